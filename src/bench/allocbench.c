@@ -0,0 +1,156 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// Copyright (C) 2025 HaמuL
+
+// Heap allocations on the steady-state *_process_into paths, counted by
+// arena.c when built with -DFRAD_COUNT_ALLOCS: every arena chunk and every
+// frad_* block that misses an arena. For profiles 0, 1, 2 and 4, with and
+// without ECC, an encoder and a decoder are warmed up on a few frames, then
+// run BENCH_FRAMES more. Any allocation there fails the run with a non-zero
+// exit, and so does a counter that misses a probe allocation, a warm-up that
+// counted nothing or a decoder that puts out no PCM. Profile 2 has no encoder
+// yet, only its encode call counts and its warm-up may count nothing.
+// Channel threads stay off: their helper threads take scratch from the heap,
+// see arena.h. The remaining direct mallocs in libfrad build encoders,
+// decoders and their caches, none of them run per frame.
+// Build with `make bench`, run bin/allocbench
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+#include "libfrad/encoder.h"
+#include "libfrad/decoder.h"
+#include "libfrad/backend/arena.h"
+
+#define BENCH_CHANNELS 2
+#define BENCH_SRATE 48000
+#define BENCH_FRAME 2048
+// Frames run before counting, enough to grow every arena and stage buffer
+#define WARMUP_FRAMES 32
+#define BENCH_FRAMES 256
+// Output buffers hold a few frames, so no call ends in FRAD_STATUS_OUTPUT_FULL
+#define STREAM_CAP (1 << 20)
+#define PCM_CAP (BENCH_FRAME * BENCH_CHANNELS * 8)
+
+typedef struct {
+    uint8_t profile;
+    uint16_t bit_depth;
+    bool decodes;
+} bench_case;
+
+// profile2_analogue is not implemented yet, there is nothing to decode
+static const bench_case CASES[] = { { 0, 24, true }, { 1, 16, true }, { 2, 16, false }, { 4, 16, true } };
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ull;
+
+static double rng_uniform(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return ((rng_state >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+// Two drifting tones and some noise, so frame sizes on the wire keep changing
+static void fill_frame(double* pcm, size_t frame) {
+    for (size_t i = 0; i < BENCH_FRAME; i++) {
+        double t = (double)(frame * BENCH_FRAME + i) / BENCH_SRATE;
+        double sweep = 220.0 + 40.0 * sin(t * 0.7);
+        for (size_t c = 0; c < BENCH_CHANNELS; c++) {
+            double tone = 0.4 * sin(2.0 * M_PI * sweep * (c + 1) * t) + 0.2 * sin(2.0 * M_PI * 3150.0 * t);
+            pcm[i * BENCH_CHANNELS + c] = tone + 0.05 * (rng_uniform() - 0.5);
+        }
+    }
+}
+
+// One frame through the encoder and whatever it emitted through the decoder
+static bool run_frame(encoder_t* enc, decoder_t* dec, double* pcm, uint8_t* stream, double* out, size_t frame,
+                      size_t* enc_allocs, size_t* dec_allocs, size_t* pcm_out) {
+    size_t written = 0, decoded = 0;
+    fill_frame(pcm, frame);
+
+    size_t before = frad_heap_allocs();
+    frad_status_t status = encoder_process_into(enc, pcm, BENCH_FRAME * BENCH_CHANNELS, stream, STREAM_CAP,
+                                                &written);
+    *enc_allocs += frad_heap_allocs() - before;
+    if (status != FRAD_STATUS_NEED_INPUT) return false;
+
+    // The first frame of a stream ends in FRAD_STATUS_STREAM_CHANGED, drain
+    // until the decoder asks for more
+    before = frad_heap_allocs();
+    status = decoder_process_into(dec, stream, written, out, PCM_CAP, &decoded);
+    *pcm_out += decoded;
+    while (status == FRAD_STATUS_STREAM_CHANGED || status == FRAD_STATUS_OUTPUT_FULL) {
+        status = decoder_process_into(dec, NULL, 0, out, PCM_CAP, &decoded);
+        *pcm_out += decoded;
+    }
+    *dec_allocs += frad_heap_allocs() - before;
+    return status == FRAD_STATUS_NEED_INPUT;
+}
+
+static bool bench_case_run(const bench_case* bc, bool ecc, size_t* enc_allocs, size_t* dec_allocs) {
+    encoder_params_t params = { bc->profile, BENCH_SRATE, BENCH_CHANNELS, bc->bit_depth, BENCH_FRAME };
+    encoder_t* enc = encoder_new(&params);
+    decoder_t* dec = decoder_new(ecc);
+    double* pcm = (double*)malloc(BENCH_FRAME * BENCH_CHANNELS * sizeof(double));
+    uint8_t* stream = (uint8_t*)malloc(STREAM_CAP);
+    double* out = (double*)malloc(PCM_CAP * sizeof(double));
+    bool ok = enc && dec && pcm && stream && out;
+    if (ok) encoder_set_ecc(enc, ecc, 96, 24);
+
+    size_t warm_enc = 0, warm_dec = 0, pcm_out = 0;
+    for (size_t f = 0; f < WARMUP_FRAMES && ok; f++) {
+        ok = run_frame(enc, dec, pcm, stream, out, f, &warm_enc, &warm_dec, &pcm_out);
+    }
+    // Fresh arenas have to grow, a warm-up with nothing counted means no counter
+    if (bc->decodes && warm_enc == 0 && warm_dec == 0) ok = false;
+    pcm_out = 0;
+    for (size_t f = WARMUP_FRAMES; f < WARMUP_FRAMES + BENCH_FRAMES && ok; f++) {
+        ok = run_frame(enc, dec, pcm, stream, out, f, enc_allocs, dec_allocs, &pcm_out);
+    }
+    // A decoder that never gets to its frames would pass with nothing allocated
+    if (bc->decodes && pcm_out == 0) ok = false;
+
+    free(out);
+    free(stream);
+    free(pcm);
+    decoder_free(dec);
+    encoder_free(enc);
+    return ok;
+}
+
+// A frad_malloc outside any arena has to show up, or every count below is 0 for nothing
+static bool counter_works(void) {
+    size_t before = frad_heap_allocs();
+    void* probe = frad_malloc(64);
+    frad_free(probe);
+    return probe && frad_heap_allocs() - before == 1;
+}
+
+int main(void) {
+    if (!counter_works()) {
+        fprintf(stderr, "allocation counter not built in, compile libfrad with -DFRAD_COUNT_ALLOCS\n");
+        return 1;
+    }
+
+    int rc = 0;
+    printf("%7s %5s %14s %14s\n", "profile", "ecc", "encode allocs", "decode allocs");
+    for (size_t i = 0; i < sizeof(CASES) / sizeof(CASES[0]); i++) {
+        for (int ecc = 0; ecc < 2; ecc++) {
+            size_t enc_allocs = 0, dec_allocs = 0;
+            if (!bench_case_run(&CASES[i], ecc, &enc_allocs, &dec_allocs)) {
+                fprintf(stderr, "profile %u%s: encode or decode failed, or warm-up counted nothing\n",
+                        CASES[i].profile, ecc ? " ecc" : "");
+                rc = 1;
+                continue;
+            }
+            if (CASES[i].decodes) {
+                printf("%7u %5s %14zu %14zu\n", CASES[i].profile, ecc ? "yes" : "no", enc_allocs, dec_allocs);
+            } else {
+                printf("%7u %5s %14zu %14s\n", CASES[i].profile, ecc ? "yes" : "no", enc_allocs, "-");
+            }
+            if (enc_allocs || dec_allocs) rc = 1;
+        }
+    }
+    printf("%s: %d frames per case after %d warm-up frames\n", rc ? "FAIL" : "ok", BENCH_FRAMES, WARMUP_FRAMES);
+    return rc;
+}
@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// Copyright (C) 2025 HaמuL
+
+// FFT/DCT throughput per compact frame length, and per profile 0 frame
+// length next to the length --snap-fsize would pick
+// Build with `make bench`, compare bin/fftbench against bin/fftbench-scalar
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "libfrad/fourier/compact.h"
+#include "libfrad/fourier/backend/dct_core.h"
+#include "libfrad/fourier/backend/pocketfft.h"
+#include "libfrad/fourier/backend/pocketfft_simd.h"
+
+// Minimum wall time spent on each measurement
+#define BENCH_MIN_SECONDS 0.05
+
+static double now_seconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// Nanoseconds per complex FFT of given length, data is left scrambled
+static double bench_cfft(size_t len, double* data) {
+    cfft_plan plan = make_cfft_plan(len);
+    if (!plan) return NAN;
+
+    size_t iters = 0;
+    double start = now_seconds(), elapsed;
+    do {
+        for (int i = 0; i < 16; i++) {
+            cfft_forward(plan, data, 1.0);
+            cfft_backward(plan, data, 1.0 / len);
+        }
+        iters += 32;
+        elapsed = now_seconds() - start;
+    } while (elapsed < BENCH_MIN_SECONDS);
+
+    destroy_cfft_plan(plan);
+    return elapsed * 1e9 / iters;
+}
+
+// Channels of the multichannel measurement
+#define BENCH_CHANNELS 8
+
+// Nanoseconds per channel of an interleaved DCT-II + DCT-III pair
+static double bench_dct(size_t len, size_t channels, double* data, double* scratch) {
+    // Untimed first pair, the first call also builds every compact plan
+    dct_batch(data, scratch, len, channels);
+    idct_batch(scratch, data, len, channels);
+
+    size_t iters = 0;
+    double start = now_seconds(), elapsed;
+    do {
+        for (int i = 0; i < 16; i++) {
+            dct_batch(data, scratch, len, channels);
+            idct_batch(scratch, data, len, channels);
+        }
+        iters += 16 * channels;
+        elapsed = now_seconds() - start;
+    } while (elapsed < BENCH_MIN_SECONDS);
+
+    return elapsed * 1e9 / iters;
+}
+
+// Profile 0 frame lengths: smooth, prime, 2 * prime and large prime factors
+static const size_t AWKWARD_SAMPLES[] = {
+    2000, 2003, 4099, 8191, 16411, 44100, 44101, 44102, 48000, 48017, 65537, 96001, 131071
+};
+#define AWKWARD_SAMPLES_SIZE (sizeof(AWKWARD_SAMPLES) / sizeof(AWKWARD_SAMPLES[0]))
+
+int main(void) {
+    size_t max_len = COMPACT_SAMPLES[COMPACT_SAMPLES_SIZE - 1] * BENCH_CHANNELS;
+    for (size_t i = 0; i < AWKWARD_SAMPLES_SIZE; i++) {
+        size_t snapped = dct_nearest_fast_length(AWKWARD_SAMPLES[i]);
+        if (AWKWARD_SAMPLES[i] > max_len) max_len = AWKWARD_SAMPLES[i];
+        if (snapped > max_len) max_len = snapped;
+    }
+    double* data = (double*)malloc(max_len * sizeof(double));
+    double* scratch = (double*)malloc(max_len * sizeof(double));
+    if (!data || !scratch) return 1;
+
+    printf("pocketfft passes: %s\n", PFV_ISA);
+    printf("%8s %14s %12s %14s %12s %14s\n", "samples", "cfft(N/2) ns", "ns/sample", "dct+idct ns", "ns/sample",
+           "8ch ns/ch");
+
+    for (size_t i = 0; i < COMPACT_SAMPLES_SIZE; i++) {
+        size_t n = COMPACT_SAMPLES[i];
+        for (size_t j = 0; j < n * 2; j++) data[j] = sin(j * 0.001) + 0.25 * cos(j * 0.37);
+
+        double t_fft = bench_cfft(n / 2, data);
+        for (size_t j = 0; j < n; j++) data[j] = sin(j * 0.001) + 0.25 * cos(j * 0.37);
+        double t_dct = bench_dct(n, 1, data, scratch);
+        for (size_t j = 0; j < n * BENCH_CHANNELS; j++) data[j] = sin(j * 0.001) + 0.25 * cos(j * 0.37);
+        double t_multi = bench_dct(n, BENCH_CHANNELS, data, scratch);
+
+        printf("%8zu %14.0f %12.3f %14.0f %12.3f %14.0f\n", n, t_fft, t_fft / n, t_dct, t_dct / n, t_multi);
+    }
+
+    printf("\nprofile 0 dct+idct\n");
+    printf("%8s %6s %12s %8s %12s\n", "samples", "fast", "ns/sample", "snapped", "ns/sample");
+
+    for (size_t i = 0; i < AWKWARD_SAMPLES_SIZE; i++) {
+        size_t n = AWKWARD_SAMPLES[i];
+        size_t snapped = dct_nearest_fast_length(n);
+        for (size_t j = 0; j < n; j++) data[j] = sin(j * 0.001) + 0.25 * cos(j * 0.37);
+        double t_dct = bench_dct(n, 1, data, scratch);
+        for (size_t j = 0; j < snapped; j++) data[j] = sin(j * 0.001) + 0.25 * cos(j * 0.37);
+        double t_snap = bench_dct(snapped, 1, data, scratch);
+
+        printf("%8zu %6s %12.3f %8zu %12.3f\n", n, dct_length_is_fast(n) ? "yes" : "no", t_dct / n, snapped,
+               t_snap / snapped);
+    }
+
+    free(data);
+    free(scratch);
+    return 0;
+}
@@ -0,0 +1,209 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// Copyright (C) 2025 HaמuL
+
+// Exponential Golomb throughput on profile 1 shaped coefficients, next to
+// the bit-at-a-time coders they replaced, whose output they have to match
+// Build with `make bench`, run bin/golombbench
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "libfrad/fourier/tools/p1tools.h"
+#include "libfrad/backend/arena.h"
+
+// Minimum wall time spent on each measurement
+#define BENCH_MIN_SECONDS 0.1
+
+static double now_seconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// The previous exp_golomb_encode: bit lengths by shifting, one bit per write
+static vec_u8* exp_golomb_encode_bitwise(const int64_t* data, size_t len) {
+    int64_t dmax = 0;
+    for (size_t i = 0; i < len; i++) {
+        int64_t abs_val = data[i] < 0 ? -data[i] : data[i];
+        if (abs_val > dmax) dmax = abs_val;
+    }
+    uint8_t k = dmax > 0 ? (uint8_t)ceil(log2((double)dmax)) : 0;
+
+    size_t total_bits = 8;
+    for (size_t i = 0; i < len; i++) {
+        int64_t n = data[i];
+        int64_t x = (n > 0 ? (n << 1) - 1 : (-n) << 1) + (1LL << k);
+        int bits_needed = 0;
+        for (int64_t temp = x; temp > 0; temp >>= 1) bits_needed++;
+        if (bits_needed == 0) bits_needed = 1;
+        total_bits += (bits_needed << 1) - (k + 1);
+    }
+
+    vec_u8* encoded = vec_u8_new((total_bits + 7) / 8);
+    vec_u8_resize(encoded, (total_bits + 7) / 8);
+    encoded->data[0] = k;
+
+    size_t bit_pos = 8;
+    for (size_t i = 0; i < len; i++) {
+        int64_t n = data[i];
+        int64_t x = (n > 0 ? (n << 1) - 1 : (-n) << 1) + (1LL << k);
+        int x_bits = 0;
+        for (int64_t temp = x; temp > 0; temp >>= 1) x_bits++;
+        if (x_bits == 0) x_bits = 1;
+        int code_bits = (x_bits << 1) - (k + 1);
+        for (int j = 0; j < code_bits; j++) {
+            if (x & (1LL << (code_bits - 1 - j))) {
+                encoded->data[bit_pos / 8] |= (1 << (7 - bit_pos % 8));
+            }
+            bit_pos++;
+        }
+    }
+    return encoded;
+}
+
+// The previous exp_golomb_decode: one byte per bit, then a bit at a time
+static int64_t* exp_golomb_decode_bitwise(const vec_u8* data, size_t* out_len) {
+    uint8_t k = data->data[0];
+    int64_t kx = 1LL << k;
+    size_t bit_len = (data->size - 1) * 8;
+    uint8_t* bits = (uint8_t*)calloc(bit_len, 1);
+    for (size_t i = 1; i < data->size; i++) {
+        for (int j = 0; j < 8; j++) bits[(i - 1) * 8 + j] = (data->data[i] >> (7 - j)) & 1;
+    }
+
+    size_t capacity = 256, count = 0, idx = 0;
+    int64_t* decoded = (int64_t*)malloc(capacity * sizeof(int64_t));
+    while (idx < bit_len) {
+        size_t m = 0;
+        while (idx + m < bit_len && bits[idx + m] == 0) m++;
+        if (idx + m >= bit_len) break;
+        size_t cwlen = m * 2 + k + 1;
+        if (idx + cwlen > bit_len) break;
+
+        int64_t n = 0;
+        for (size_t i = idx + m; i < idx + cwlen; i++) n = (n << 1) | bits[i];
+        n -= kx;
+        if (count >= capacity) {
+            capacity *= 2;
+            decoded = (int64_t*)realloc(decoded, capacity * sizeof(int64_t));
+        }
+        decoded[count++] = n & 1 ? (n + 1) >> 1 : -(n >> 1);
+        idx += cwlen;
+    }
+    free(bits);
+    *out_len = count;
+    return decoded;
+}
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ull;
+
+static double rng_uniform(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return ((rng_state >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+// Quantised spectrum of one frame: Laplacian values whose scale falls off
+// with frequency, the top of the band masked to zero as profile 1 does
+static void make_frame(int64_t* data, size_t samples, size_t channels, double scale, double masked_from) {
+    for (size_t c = 0; c < channels; c++) {
+        for (size_t i = 0; i < samples; i++) {
+            double f = (double)i / samples;
+            double u = rng_uniform() - 0.5;
+            double v = -scale * exp(-5.0 * f) * (u < 0 ? -1 : 1) * log(1 - 2 * fabs(u));
+            data[i * channels + c] = f >= masked_from ? 0 : (int64_t)llround(v);
+        }
+    }
+}
+
+// Nanoseconds per coefficient
+static double bench_encode(vec_u8* (*encode)(const int64_t*, size_t), const int64_t* data, size_t len) {
+    size_t iters = 0;
+    double start = now_seconds(), elapsed;
+    do {
+        for (int i = 0; i < 16; i++) vec_u8_free(encode(data, len));
+        iters += 16;
+        elapsed = now_seconds() - start;
+    } while (elapsed < BENCH_MIN_SECONDS);
+    return elapsed * 1e9 / (iters * len);
+}
+
+// Nanoseconds per coefficient, the new decoder is told the count up front as profile 1 does
+static double bench_decode(bool bitwise, const vec_u8* encoded, size_t len) {
+    size_t iters = 0, count;
+    double start = now_seconds(), elapsed;
+    do {
+        for (int i = 0; i < 16; i++) {
+            if (bitwise) free(exp_golomb_decode_bitwise(encoded, &count));
+            else frad_free(exp_golomb_decode(encoded, len, &count));
+        }
+        iters += 16;
+        elapsed = now_seconds() - start;
+    } while (elapsed < BENCH_MIN_SECONDS);
+    return elapsed * 1e9 / (iters * len);
+}
+
+typedef struct {
+    const char* name;
+    size_t samples;
+    size_t channels;
+    double scale;
+    double masked_from;
+} golomb_case;
+
+static const golomb_case CASES[] = {
+    {"quiet 2048x2",  2048, 2,    2.0, 0.5},
+    {"music 2048x2",  2048, 2,  300.0, 0.7},
+    {"loud 2048x2",   2048, 2, 8000.0, 0.9},
+    {"music 448x2",    448, 2,  300.0, 0.7},
+    {"music 8192x8",  8192, 8,  300.0, 0.7},
+};
+#define CASES_SIZE (sizeof(CASES) / sizeof(CASES[0]))
+
+int main(void) {
+    printf("%-14s %4s %8s %10s %10s %8s %10s %10s %8s\n", "frame", "k", "bytes", "enc old", "enc new", "speedup",
+           "dec old", "dec new", "speedup");
+
+    int status = 0;
+    for (size_t i = 0; i < CASES_SIZE; i++) {
+        const golomb_case* bc = &CASES[i];
+        size_t len = bc->samples * bc->channels;
+        int64_t* data = (int64_t*)malloc(len * sizeof(int64_t));
+        if (!data) return 1;
+        make_frame(data, bc->samples, bc->channels, bc->scale, bc->masked_from);
+
+        vec_u8* expect = exp_golomb_encode_bitwise(data, len);
+        vec_u8* got = exp_golomb_encode(data, len);
+        if (expect->size != got->size || memcmp(expect->data, got->data, got->size) != 0) {
+            fprintf(stderr, "%s: output differs from the bitwise coder\n", bc->name);
+            status = 1;
+        }
+        size_t count_old, count_new;
+        int64_t* values_old = exp_golomb_decode_bitwise(got, &count_old);
+        int64_t* values_new = exp_golomb_decode(got, len, &count_new);
+        if (count_old != count_new || count_new < len ||
+            memcmp(values_old, values_new, count_new * sizeof(int64_t)) != 0 ||
+            memcmp(values_new, data, len * sizeof(int64_t)) != 0) {
+            fprintf(stderr, "%s: decoded values differ\n", bc->name);
+            status = 1;
+        }
+        free(values_old);
+        frad_free(values_new);
+
+        double t_enc_old = bench_encode(exp_golomb_encode_bitwise, data, len);
+        double t_enc_new = bench_encode(exp_golomb_encode, data, len);
+        double t_dec_old = bench_decode(true, got, len);
+        double t_dec_new = bench_decode(false, got, len);
+        printf("%-14s %4u %8zu %10.2f %10.2f %7.1fx %10.2f %10.2f %7.1fx\n", bc->name, got->data[0], got->size,
+               t_enc_old, t_enc_new, t_enc_old / t_enc_new, t_dec_old, t_dec_new, t_dec_old / t_dec_new);
+
+        vec_u8_free(expect);
+        vec_u8_free(got);
+        free(data);
+    }
+    printf("(ns per value)\n");
+    return status;
+}
@@ -0,0 +1,184 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// Copyright (C) 2025 HaמuL
+
+// Profile 1 power-law quantisation, the array kernels next to the scalar
+// functions they have to match. The match is checked first, exhaustively
+// where the input is small enough to enumerate:
+//   - every single precision input from 0.5 to 2^20, both signs,
+//   - doubles a few ulp either side of every integer boundary below 2^20,
+//     and a spread of random ones,
+//   - every coefficient below 2^20 for dequantisation.
+// Build with `make bench`, run bin/quantbench
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "libfrad/fourier/tools/p1tools.h"
+
+// Minimum wall time spent on each measurement
+#define BENCH_MIN_SECONDS 0.1
+#define CHECK_BLOCK 4096
+
+static double now_seconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ull;
+
+static double rng_uniform(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return ((rng_state >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+static size_t check_f32_binades(void) {
+    static float in[CHECK_BLOCK];
+    static int64_t out[CHECK_BLOCK];
+    size_t bad = 0;
+    uint32_t first, last;
+    float lo = 0.5f, hi = 1048576.0f;
+    memcpy(&first, &lo, sizeof(first));
+    memcpy(&last, &hi, sizeof(last));
+    for (int sign = 0; sign < 2; sign++) {
+        for (uint32_t bits = first; bits < last;) {
+            size_t n = 0;
+            for (; n < CHECK_BLOCK && bits < last; n++, bits++) {
+                uint32_t b = bits | (uint32_t)sign << 31;
+                memcpy(&in[n], &b, sizeof(b));
+            }
+            quant_array_f32(in, n, out, 1);
+            for (size_t i = 0; i < n; i++) {
+                if (out[i] != quant_f32(in[i]) && bad++ < 8) {
+                    fprintf(stderr, "quant_array_f32(%a) = %lld, quant_f32 %lld\n", in[i], (long long)out[i],
+                            (long long)quant_f32(in[i]));
+                }
+            }
+        }
+    }
+    return bad;
+}
+
+static size_t check_f64_boundaries(void) {
+    static double in[CHECK_BLOCK];
+    static int64_t out[CHECK_BLOCK];
+    size_t bad = 0, n = 0;
+    for (int64_t q = 1; q <= (1 << 20); q++) {
+        double at = pow((double)q, 4.0 / 3.0);
+        double rnd = rng_uniform() * (1 << 26);
+        double cases[] = {
+            at, nextafter(at, 0), nextafter(at, INFINITY),
+            nextafter(nextafter(at, 0), 0), nextafter(nextafter(at, INFINITY), INFINITY),
+            -at, -nextafter(at, 0), -nextafter(at, INFINITY), rnd, -rnd
+        };
+        for (size_t j = 0; j < sizeof(cases) / sizeof(cases[0]); j++) {
+            in[n++] = cases[j];
+            if (n < CHECK_BLOCK - 16 && q < (1 << 20)) continue;
+            quant_array(in, n, out, 1);
+            for (size_t i = 0; i < n; i++) {
+                if (out[i] != quant(in[i]) && bad++ < 8) {
+                    fprintf(stderr, "quant_array(%a) = %lld, quant %lld\n", in[i], (long long)out[i],
+                            (long long)quant(in[i]));
+                }
+            }
+            n = 0;
+        }
+    }
+    return bad;
+}
+
+static size_t check_dequant(void) {
+    static int64_t in[CHECK_BLOCK];
+    static double out[CHECK_BLOCK];
+    static float out_f32[CHECK_BLOCK];
+    size_t bad = 0;
+    for (int64_t v = -(1 << 20); v < (1 << 20);) {
+        size_t n = 0;
+        for (; n < CHECK_BLOCK && v < (1 << 20); n++) in[n] = v++;
+        dequant_array(in, n, 32768.0, out);
+        dequant_array_f32(in, n, 1.0f / 32768.0f, out_f32);
+        for (size_t i = 0; i < n; i++) {
+            double expect = dequant((double)in[i]) / 32768.0;
+            float expect_f32 = dequant_f32((float)in[i]) * (1.0f / 32768.0f);
+            if ((memcmp(&out[i], &expect, sizeof(double)) != 0 || memcmp(&out_f32[i], &expect_f32, sizeof(float)) != 0) &&
+                bad++ < 8) {
+                fprintf(stderr, "dequant_array(%lld) differs\n", (long long)in[i]);
+            }
+        }
+    }
+    return bad;
+}
+
+// Masked spectrum of one channel as profile 1 quantises it: Laplacian
+// values whose scale falls off with frequency, the top of the band zero
+static void make_spectrum(double* data, size_t len, double scale) {
+    for (size_t i = 0; i < len; i++) {
+        double f = (double)i / len;
+        double u = rng_uniform() - 0.5;
+        double v = -scale * exp(-5.0 * f) * (u < 0 ? -1 : 1) * log(1 - 2 * fabs(u));
+        data[i] = f >= 0.7 ? 0.0 : v;
+    }
+}
+
+// Nanoseconds per value of each pass, scalar then array
+static void bench(const double* spectrum, size_t len, double times[8]) {
+    float* spectrum_f32 = (float*)malloc(len * sizeof(float));
+    int64_t* q = (int64_t*)malloc(len * sizeof(int64_t));
+    double* d = (double*)malloc(len * sizeof(double));
+    float* d_f32 = (float*)malloc(len * sizeof(float));
+    for (size_t i = 0; i < len; i++) spectrum_f32[i] = (float)spectrum[i];
+    quant_array(spectrum, len, q, 1);
+
+    for (int pass = 0; pass < 8; pass++) {
+        size_t iters = 0;
+        double start = now_seconds(), elapsed;
+        do {
+            switch (pass) {
+            case 0: for (size_t i = 0; i < len; i++) q[i] = quant(spectrum[i]); break;
+            case 1: quant_array(spectrum, len, q, 1); break;
+            case 2: for (size_t i = 0; i < len; i++) q[i] = quant_f32(spectrum_f32[i]); break;
+            case 3: quant_array_f32(spectrum_f32, len, q, 1); break;
+            case 4: for (size_t i = 0; i < len; i++) d[i] = dequant((double)q[i]) / 32768.0; break;
+            case 5: dequant_array(q, len, 32768.0, d); break;
+            case 6: for (size_t i = 0; i < len; i++) d_f32[i] = dequant_f32((float)q[i]) * (1.0f / 32768.0f); break;
+            case 7: dequant_array_f32(q, len, 1.0f / 32768.0f, d_f32); break;
+            }
+            iters++;
+            elapsed = now_seconds() - start;
+        } while (elapsed < BENCH_MIN_SECONDS);
+        times[pass] = elapsed * 1e9 / (iters * len);
+    }
+    free(spectrum_f32);
+    free(q);
+    free(d);
+    free(d_f32);
+}
+
+int main(void) {
+    size_t bad_f32 = check_f32_binades();
+    size_t bad_f64 = check_f64_boundaries();
+    size_t bad_deq = check_dequant();
+    printf("mismatches: quant f32 %zu, quant f64 %zu, dequant %zu\n", bad_f32, bad_f64, bad_deq);
+
+    static const double SCALES[] = {30.0, 3000.0, 300000.0};
+    printf("%-10s %9s %9s %9s %9s %9s %9s %9s %9s\n", "scale", "q old", "q new", "q32 old", "q32 new", "dq old",
+           "dq new", "dq32 old", "dq32 new");
+    size_t len = 1 << 16;
+    double* spectrum = (double*)malloc(len * sizeof(double));
+    if (!spectrum) return 1;
+    for (size_t s = 0; s < sizeof(SCALES) / sizeof(SCALES[0]); s++) {
+        double times[8];
+        make_spectrum(spectrum, len, SCALES[s]);
+        bench(spectrum, len, times);
+        printf("%-10.0f", SCALES[s]);
+        for (int i = 0; i < 8; i++) printf(" %9.2f", times[i]);
+        printf("\n");
+    }
+    printf("(ns per value)\n");
+    free(spectrum);
+    return bad_f32 || bad_f64 || bad_deq;
+}
@@ -8,6 +8,7 @@
 #include "tools/cli.h"
 #include "tools/audio.h"
 #include "tools/process.h"
+#include "tools/pipeline.h"
 #include "app_common.h"
 
 static void logging_decode(uint8_t loglevel, process_info_t* log, bool linefeed, const ASFH* asfh) {
@@ -67,6 +68,9 @@ void decode(const char* input, CliParams* params, bool play) {
         fclose(in_file);
         return;
     }
+    decoder_set_float32(decoder, params->float32);
+    decoder_set_threads(decoder, params->threads < 0 ? 1 : (size_t)params->threads);
+    decoder_set_channel_threads(decoder, params->channel_threads < 0 ? 1 : (size_t)params->channel_threads);
     
     // Create PCM processor for converting f64 to output format
     PCMProcessor* pcm_processor = pcm_processor_new(params->pcm);
@@ -141,12 +145,25 @@ void decode(const char* input, CliParams* params, bool play) {
     // Create process info for logging
     process_info_t* procinfo = process_info_new();
 
-    // Read and process input
-    uint8_t buffer[32768];
-    size_t bytes_read;
+    // Read, decode and write on three threads, chunks are recycled
+    io_pipeline_t* io = io_pipeline_new(in_file, out_file, 32768,
+                                        params->pipeline_depth < 0 ? 0 : (size_t)params->pipeline_depth);
+    if (!io) {
+        fprintf(stderr, "Error: Memory allocation failed\n");
+        process_info_free(procinfo);
+        if (out_file && !is_stdout) fclose(out_file);
+        pcm_processor_free(pcm_processor);
+        decoder_free(decoder);
+        if (!is_stdin) fclose(in_file);
+        if (auto_output) free(auto_output);
+        return;
+    }
+    io_chunk_t* chunk;
 
-    while ((bytes_read = fread(buffer, 1, sizeof(buffer), in_file)) > 0) {
-        decode_result_t* result = decoder_process(decoder, buffer, bytes_read);
+    while ((chunk = io_pipeline_read(io)) != NULL) {
+        size_t bytes_read = chunk->size;
+        decode_result_t* result = decoder_process(decoder, chunk->data, bytes_read);
+        io_pipeline_release(io, chunk);
         if (result) {
             if (result->pcm && result->pcm->size > 0) {
                 // Update process info (samples = pcm->size / channels)
@@ -174,7 +191,7 @@ void decode(const char* input, CliParams* params, bool play) {
                     size_t byte_count;
                     uint8_t* bytes = pcm_processor_from_f64(pcm_processor, result->pcm->data, result->pcm->size, &byte_count);
                     if (bytes) {
-                        fwrite(bytes, 1, byte_count, out_file);
+                        io_pipeline_write(io, bytes, byte_count);
                         free(bytes);
                     }
                 }
@@ -198,13 +215,16 @@ void decode(const char* input, CliParams* params, bool play) {
                 size_t byte_count;
                 uint8_t* bytes = pcm_processor_from_f64(pcm_processor, result->pcm->data, result->pcm->size, &byte_count);
                 if (bytes) {
-                    fwrite(bytes, 1, byte_count, out_file);
+                    io_pipeline_write(io, bytes, byte_count);
                     free(bytes);
                 }
             }
         }
         decode_result_free(result);
     }
+    if (out_file && !io_pipeline_finish(io)) {
+        fprintf(stderr, "Error: Failed to write output file '%s'\n", output_file);
+    }
     logging_decode(params->loglevel, procinfo, true, decoder_get_asfh(decoder));
 
     // Wait for audio playback to finish
@@ -215,6 +235,7 @@ void decode(const char* input, CliParams* params, bool play) {
 
     // Cleanup
     process_info_free(procinfo);
+    io_pipeline_free(io);
     if (out_file && !is_stdout) {
         fclose(out_file);
     }
@@ -4,10 +4,13 @@
 #include <strings.h>
 #include <math.h>
 #include <unistd.h>
+#include <errno.h>
+#include <time.h>
 #include "libfrad/encoder.h"
 #include "tools/pcmproc.h"
 #include "tools/cli.h"
 #include "tools/process.h"
+#include "tools/pipeline.h"
 #include "app_common.h"
 
 static void logging_encode(uint8_t loglevel, process_info_t* log, bool linefeed) {
@@ -30,6 +33,123 @@ static void logging_encode(uint8_t loglevel, process_info_t* log, bool linefeed)
     }
 }
 
+// Input arrival times for live mode, to tell how long each sample waited
+// before the frame holding it went out
+typedef struct {
+    size_t end;   // Input values received once this read returned
+    double time;
+} live_read;
+
+typedef struct {
+    live_read* reads;  // Reads whose values are not all out yet, oldest first
+    size_t head;
+    size_t len;
+    size_t cap;
+    size_t received;   // Input values read so far
+    size_t done;       // Input values covered by the output so far
+    double last;
+    double sum;
+    double max;
+    size_t count;
+} live_clock;
+
+static double monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static void live_clock_read(live_clock* clock, size_t values) {
+    if (values == 0) return;
+    if (clock->head + clock->len == clock->cap) {
+        if (clock->head > 0) {
+            memmove(clock->reads, clock->reads + clock->head, clock->len * sizeof(live_read));
+            clock->head = 0;
+        } else {
+            size_t cap = clock->cap ? clock->cap * 2 : 64;
+            live_read* grown = realloc(clock->reads, cap * sizeof(live_read));
+            if (!grown) return;
+            clock->reads = grown;
+            clock->cap = cap;
+        }
+    }
+    clock->received += values;
+    clock->reads[clock->head + clock->len++] = (live_read){ clock->received, monotonic_ms() };
+}
+
+// The output now covers values more input values, measured from the arrival of the oldest one
+static void live_clock_output(live_clock* clock, size_t values) {
+    if (values == 0 || clock->len == 0) return;
+    clock->last = monotonic_ms() - clock->reads[clock->head].time;
+    clock->sum += clock->last;
+    if (clock->last > clock->max) clock->max = clock->last;
+    clock->count++;
+
+    clock->done += values;
+    while (clock->len > 0 && clock->reads[clock->head].end <= clock->done) {
+        clock->head++;
+        clock->len--;
+    }
+    if (clock->len == 0) clock->head = 0;
+}
+
+static bool live_write(FILE* out_file, live_clock* clock, process_info_t* procinfo,
+                       encode_result_t* result, size_t channels, uint32_t srate) {
+    bool ok = true;
+    if (result->data && result->data->size > 0) {
+        ok = fwrite(result->data->data, 1, result->data->size, out_file) == result->data->size;
+        ok = fflush(out_file) == 0 && ok;
+        live_clock_output(clock, result->samples * channels);
+        process_info_update(procinfo, result->data->size, result->samples, srate);
+    }
+    encode_result_free(result);
+    return ok;
+}
+
+// Live mode: encode whatever the capture pipe has so far and send every frame
+// out the moment it is ready, instead of waiting for whole 32 KiB reads
+static void encode_live(encoder_t* encoder, PCMProcessor* pcm_processor, FILE* in_file, FILE* out_file,
+                        CliParams* params, process_info_t* procinfo) {
+    size_t channels = encoder_get_channels(encoder);
+    uint32_t srate = encoder_get_srate(encoder);
+    int fd = fileno(in_file);
+    live_clock clock = {0};
+    bool ok = true;
+
+    fwrite("fRad", 1, 4, out_file);
+    fflush(out_file);
+
+    uint8_t buffer[32768];
+    while (ok) {
+        ssize_t bytes_read = read(fd, buffer, sizeof(buffer));
+        if (bytes_read < 0 && errno == EINTR) continue;
+        if (bytes_read <= 0) break;
+
+        size_t sample_count;
+        double* samples = pcm_processor_into_f64(pcm_processor, buffer, (size_t)bytes_read, &sample_count);
+        live_clock_read(&clock, sample_count);
+
+        if (samples && sample_count > 0) {
+            encode_result_t* result = encoder_process(encoder, samples, sample_count);
+            free(samples);
+            if (result) ok = live_write(out_file, &clock, procinfo, result, channels, srate);
+        }
+        if (params->loglevel > 0) fprintf(stderr, "latency=%.2fms ", clock.last);
+        logging_encode(params->loglevel, procinfo, false);
+    }
+
+    encode_result_t* result = encoder_flush(encoder);
+    if (result && !live_write(out_file, &clock, procinfo, result, channels, srate)) ok = false;
+    if (!ok) fprintf(stderr, "Error: Failed to write output\n");
+    logging_encode(params->loglevel, procinfo, true);
+
+    if (clock.count > 0) {
+        fprintf(stderr, "latency avg=%.2fms max=%.2fms over %zu writes\n",
+                clock.sum / clock.count, clock.max, clock.count);
+    }
+    free(clock.reads);
+}
+
 void encode(const char* input, CliParams* params) {
     // Handle pipe input
     FILE* in_file = NULL;
@@ -85,6 +205,13 @@ void encode(const char* input, CliParams* params) {
     double loss_level = pow(1.25, params->losslevel) / 19.0 + 0.5;
     encoder_set_loss_level(encoder, loss_level);
     encoder_set_overlap_ratio(encoder, params->overlap_ratio);
+    encoder_set_snap_frame_size(encoder, params->snap_fsize);
+    encoder_set_float32(encoder, params->float32);
+    encoder_set_preset(encoder, params->preset);
+    // A frame pool hands frames out a call late, live mode needs them at once
+    encoder_set_threads(encoder, params->live || params->threads < 0 ? 1 : (size_t)params->threads);
+    if (params->live) encoder_set_latency(encoder, params->latency);
+    encoder_set_channel_threads(encoder, params->channel_threads < 0 ? 1 : (size_t)params->channel_threads);
 
     // Set output filename if not specified
     char* output_file = params->output;
@@ -140,38 +267,53 @@ void encode(const char* input, CliParams* params) {
         }
     }
 
-    // Write FrAD header
-    const char* frad_header = "fRad";
-    fwrite(frad_header, 1, 4, out_file);
+    if (params->live) {
+        process_info_t* procinfo = process_info_new();
+        encode_live(encoder, pcm_processor, in_file, out_file, params, procinfo);
+        process_info_free(procinfo);
+        if (!is_stdout) fclose(out_file);
+        pcm_processor_free(pcm_processor);
+        encoder_free(encoder);
+        if (!is_stdin) fclose(in_file);
+        if (auto_output) free(auto_output);
+        return;
+    }
 
-    // Process input in chunks
+    // Read, encode and write on three threads, chunks are recycled
     size_t chunk_size = 32768;  // Fixed chunk size like Rust version
-    uint8_t* buffer = malloc(chunk_size);
-    if (!buffer) {
+    io_pipeline_t* io = io_pipeline_new(in_file, out_file, chunk_size,
+                                          params->pipeline_depth < 0 ? 0 : (size_t)params->pipeline_depth);
+    if (!io) {
         fprintf(stderr, "Error: Memory allocation failed\n");
-        fclose(out_file);
+        if (!is_stdout) fclose(out_file);
         pcm_processor_free(pcm_processor);
         encoder_free(encoder);
-        fclose(in_file);
+        if (!is_stdin) fclose(in_file);
+        if (auto_output) free(auto_output);
         return;
     }
 
+    // Write FrAD header
+    const char* frad_header = "fRad";
+    io_pipeline_write(io, (const uint8_t*)frad_header, 4);
+
     // Create process info for logging
     process_info_t* procinfo = process_info_new();
-    size_t bytes_read;
+    io_chunk_t* chunk;
 
-    while ((bytes_read = fread(buffer, 1, chunk_size, in_file)) > 0) {
+    while ((chunk = io_pipeline_read(io)) != NULL) {
         // Convert PCM bytes to f64 samples
         size_t sample_count;
-        double* samples = pcm_processor_into_f64(pcm_processor, buffer, bytes_read, &sample_count);
-        
+        double* samples = pcm_processor_into_f64(pcm_processor, chunk->data, chunk->size, &sample_count);
+        io_pipeline_release(io, chunk);
+
         if (samples && sample_count > 0) {
             encode_result_t* result = encoder_process(encoder, samples, sample_count);
             free(samples);
             
             if (result) {
                 if (result->data && result->data->size > 0) {
-                    fwrite(result->data->data, 1, result->data->size, out_file);
+                    io_pipeline_write(io, result->data->data, result->data->size);
                     process_info_update(procinfo, result->data->size, result->samples, enc_params.srate);
                 }
                 encode_result_free(result);
@@ -184,16 +326,19 @@ void encode(const char* input, CliParams* params) {
     encode_result_t* result = encoder_flush(encoder);
     if (result) {
         if (result->data && result->data->size > 0) {
-            fwrite(result->data->data, 1, result->data->size, out_file);
+            io_pipeline_write(io, result->data->data, result->data->size);
             process_info_update(procinfo, result->data->size, result->samples, enc_params.srate);
         }
         encode_result_free(result);
     }
+    if (!io_pipeline_finish(io)) {
+        fprintf(stderr, "Error: Failed to write output file '%s'\n", output_file);
+    }
     logging_encode(params->loglevel, procinfo, true);
 
     // Cleanup
     process_info_free(procinfo);
-    free(buffer);
+    io_pipeline_free(io);
     if (!is_stdout) fclose(out_file);
     pcm_processor_free(pcm_processor);
     encoder_free(encoder);
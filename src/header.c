@@ -141,9 +141,7 @@ void modify_metadata(const char* input, const char* metaaction, CliParams* param
     if (head_len > 0) {
         uint8_t* temp_buf = malloc(head_len);
         fread(temp_buf, 1, head_len, rfile);
-        for (size_t i = 0; i < head_len; i++) {
-            vec_u8_push(head_old, temp_buf[i]);
-        }
+        vec_u8_extend(head_old, temp_buf, head_len);
         free(temp_buf);
     }
 
@@ -222,12 +220,8 @@ void modify_metadata(const char* input, const char* metaaction, CliParams* param
         // Add new metadata from params
         for (int i = 0; i < params->meta_count; i++) {
             if (params->meta[i][0] && params->meta[i][1]) {
-                vec_u8* data = vec_u8_new(strlen(params->meta[i][1]));
-                for (size_t j = 0; j < strlen(params->meta[i][1]); j++) {
-                    vec_u8_push(data, params->meta[i][1][j]);
-                }
-                metadata_vec_push(meta_new, params->meta[i][0], data);
-                vec_u8_free(data);
+                vec_u8 data = vec_u8_view((const uint8_t*)params->meta[i][1], strlen(params->meta[i][1]));
+                metadata_vec_push(meta_new, params->meta[i][0], &data);
             }
         }
         // Keep existing image or add new one
@@ -241,9 +235,7 @@ void modify_metadata(const char* input, const char* metaaction, CliParams* param
                 img_new = vec_u8_new(img_size);
                 uint8_t* img_buf = malloc(img_size);
                 fread(img_buf, 1, img_size, img_file);
-                for (size_t i = 0; i < img_size; i++) {
-                    vec_u8_push(img_new, img_buf[i]);
-                }
+                vec_u8_extend(img_new, img_buf, img_size);
                 free(img_buf);
                 fclose(img_file);
             } else {
@@ -251,9 +243,7 @@ void modify_metadata(const char* input, const char* metaaction, CliParams* param
             }
         } else if (parsed->img && parsed->img->size > 0) {
             img_new = vec_u8_new(parsed->img->size);
-            for (size_t i = 0; i < parsed->img->size; i++) {
-                vec_u8_push(img_new, parsed->img->data[i]);
-            }
+            vec_u8_extend(img_new, parsed->img->data, parsed->img->size);
         }
     } else if (strcmp(metaaction, "remove") == 0) {
         // Remove specified metadata keys
@@ -274,9 +264,7 @@ void modify_metadata(const char* input, const char* metaaction, CliParams* param
         // Keep existing image
         if (parsed->img && parsed->img->size > 0) {
             img_new = vec_u8_new(parsed->img->size);
-            for (size_t i = 0; i < parsed->img->size; i++) {
-                vec_u8_push(img_new, parsed->img->data[i]);
-            }
+            vec_u8_extend(img_new, parsed->img->data, parsed->img->size);
         }
     } else if (strcmp(metaaction, "rmimg") == 0) {
         // Keep metadata but remove image
@@ -290,12 +278,8 @@ void modify_metadata(const char* input, const char* metaaction, CliParams* param
         // Replace all metadata
         for (int i = 0; i < params->meta_count; i++) {
             if (params->meta[i][0] && params->meta[i][1]) {
-                vec_u8* data = vec_u8_new(strlen(params->meta[i][1]));
-                for (size_t j = 0; j < strlen(params->meta[i][1]); j++) {
-                    vec_u8_push(data, params->meta[i][1][j]);
-                }
-                metadata_vec_push(meta_new, params->meta[i][0], data);
-                vec_u8_free(data);
+                vec_u8 data = vec_u8_view((const uint8_t*)params->meta[i][1], strlen(params->meta[i][1]));
+                metadata_vec_push(meta_new, params->meta[i][0], &data);
             }
         }
         // Set new image if provided
@@ -309,9 +293,7 @@ void modify_metadata(const char* input, const char* metaaction, CliParams* param
                 img_new = vec_u8_new(img_size);
                 uint8_t* img_buf = malloc(img_size);
                 fread(img_buf, 1, img_size, img_file);
-                for (size_t i = 0; i < img_size; i++) {
-                    vec_u8_push(img_new, img_buf[i]);
-                }
+                vec_u8_extend(img_new, img_buf, img_size);
                 free(img_buf);
                 fclose(img_file);
             }
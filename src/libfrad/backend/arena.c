@@ -0,0 +1,197 @@
+#include "arena.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define ARENA_ALIGN 16
+#define ARENA_CHUNK_MIN ((size_t)1 << 20)
+#define ALIGN_UP(n) (((n) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1))
+
+typedef struct arena_chunk {
+    struct arena_chunk* next;  // Older chunks of the same frame
+    size_t cap;
+    size_t used;
+} arena_chunk;
+
+#define CHUNK_HEAD ALIGN_UP(sizeof(arena_chunk))
+
+// In front of every frad_* block, keeps the data 16-byte aligned
+typedef struct {
+    size_t size;
+    size_t from_arena;
+} block_head;
+
+struct frame_arena {
+    arena_chunk* chunk;  // Newest chunk, the only one with free space
+    block_head* last;    // Newest block, grown in place by frad_realloc
+};
+
+static _Thread_local frame_arena* current_arena = NULL;
+
+#ifdef FRAD_COUNT_ALLOCS
+#include <stdatomic.h>
+static atomic_size_t heap_allocs = 0;
+#define COUNT_HEAP_ALLOC() atomic_fetch_add_explicit(&heap_allocs, 1, memory_order_relaxed)
+
+size_t frad_heap_allocs(void) {
+    return atomic_load_explicit(&heap_allocs, memory_order_relaxed);
+}
+#else
+#define COUNT_HEAP_ALLOC() ((void)0)
+#endif
+
+static arena_chunk* chunk_new(size_t cap, arena_chunk* next) {
+    COUNT_HEAP_ALLOC();
+    arena_chunk* chunk = (arena_chunk*)malloc(CHUNK_HEAD + cap);
+    if (!chunk) return NULL;
+    chunk->next = next;
+    chunk->cap = cap;
+    chunk->used = 0;
+    return chunk;
+}
+
+frame_arena* frame_arena_new(void) {
+    return (frame_arena*)calloc(1, sizeof(frame_arena));
+}
+
+void frame_arena_free(frame_arena* arena) {
+    if (!arena) return;
+    while (arena->chunk) {
+        arena_chunk* next = arena->chunk->next;
+        free(arena->chunk);
+        arena->chunk = next;
+    }
+    free(arena);
+}
+
+void frame_arena_reset(frame_arena* arena) {
+    if (!arena || !arena->chunk) return;
+    arena->last = NULL;
+
+    if (!arena->chunk->next) {
+        arena->chunk->used = 0;
+        return;
+    }
+
+    // The frame outgrew the first chunk, replace them all with one that
+    // holds as much so the next frame does not have to grow again
+    size_t total = 0;
+    while (arena->chunk) {
+        arena_chunk* next = arena->chunk->next;
+        total += arena->chunk->cap;
+        free(arena->chunk);
+        arena->chunk = next;
+    }
+    arena->chunk = chunk_new(total, NULL);
+}
+
+void* frame_arena_alloc(frame_arena* arena, size_t size) {
+    size_t need = ALIGN_UP(size);
+    arena_chunk* chunk = arena->chunk;
+    if (!chunk || chunk->cap - chunk->used < need) {
+        size_t cap = chunk && chunk->cap * 2 > ARENA_CHUNK_MIN ? chunk->cap * 2 : ARENA_CHUNK_MIN;
+        if (cap < need) cap = need;
+        chunk = chunk_new(cap, arena->chunk);
+        if (!chunk) return NULL;
+        arena->chunk = chunk;
+    }
+
+    void* ptr = (uint8_t*)chunk + CHUNK_HEAD + chunk->used;
+    chunk->used += need;
+    arena->last = NULL;
+    return ptr;
+}
+
+frame_arena* frame_arena_enter(frame_arena* arena) {
+    frame_arena* previous = current_arena;
+    current_arena = arena;
+    return previous;
+}
+
+void frame_arena_leave(frame_arena* previous) {
+    current_arena = previous;
+}
+
+static void* block_data(block_head* head) {
+    return (uint8_t*)head + sizeof(block_head);
+}
+
+static block_head* block_of(void* ptr) {
+    return (block_head*)((uint8_t*)ptr - sizeof(block_head));
+}
+
+static void* arena_block(frame_arena* arena, size_t size) {
+    block_head* head = (block_head*)frame_arena_alloc(arena, sizeof(block_head) + size);
+    if (!head) return NULL;
+    head->size = size;
+    head->from_arena = true;
+    arena->last = head;
+    return block_data(head);
+}
+
+void* frad_malloc(size_t size) {
+    if (current_arena) return arena_block(current_arena, size);
+
+    COUNT_HEAP_ALLOC();
+    block_head* head = (block_head*)malloc(sizeof(block_head) + size);
+    if (!head) return NULL;
+    head->size = size;
+    head->from_arena = false;
+    return block_data(head);
+}
+
+void* frad_calloc(size_t count, size_t size) {
+    if (size != 0 && count > SIZE_MAX / size) return NULL;
+    void* ptr = frad_malloc(count * size);
+    if (ptr) memset(ptr, 0, count * size);
+    return ptr;
+}
+
+void* frad_realloc(void* ptr, size_t size) {
+    if (!ptr) return frad_malloc(size);
+    block_head* head = block_of(ptr);
+
+    if (!head->from_arena) {
+        COUNT_HEAP_ALLOC();
+        head = (block_head*)realloc(head, sizeof(block_head) + size);
+        if (!head) return NULL;
+        head->size = size;
+        return block_data(head);
+    }
+
+    // The newest block of this thread's arena can grow into the free space behind it
+    frame_arena* arena = current_arena;
+    if (arena && arena->last == head) {
+        arena_chunk* chunk = arena->chunk;
+        size_t old_need = ALIGN_UP(sizeof(block_head) + head->size);
+        size_t new_need = ALIGN_UP(sizeof(block_head) + size);
+        if (new_need <= old_need || chunk->cap - chunk->used >= new_need - old_need) {
+            chunk->used = chunk->used - old_need + new_need;
+            head->size = size;
+            return ptr;
+        }
+    }
+
+    void* moved = frad_malloc(size);
+    if (!moved) return NULL;
+    memcpy(moved, ptr, head->size < size ? head->size : size);
+    return moved;
+}
+
+void frad_free(void* ptr) {
+    if (!ptr) return;
+    block_head* head = block_of(ptr);
+    if (!head->from_arena) free(head);
+}
+
+void* frad_zalloc(void* opaque, unsigned int items, unsigned int size) {
+    (void)opaque;
+    if (size != 0 && items > SIZE_MAX / size) return NULL;
+    return frad_malloc((size_t)items * size);
+}
+
+void frad_zfree(void* opaque, void* ptr) {
+    (void)opaque;
+    frad_free(ptr);
+}
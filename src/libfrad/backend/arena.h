@@ -0,0 +1,45 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+// Bump allocator for the scratch memory of one frame. Memory is only given
+// back on reset, which keeps its chunks, so a frame that fits in what
+// earlier frames needed allocates nothing from the heap.
+typedef struct frame_arena frame_arena;
+
+frame_arena* frame_arena_new(void);
+void frame_arena_free(frame_arena* arena);
+// Drop everything allocated since the last reset
+void frame_arena_reset(frame_arena* arena);
+// 16-byte aligned, lives until the next reset
+void* frame_arena_alloc(frame_arena* arena, size_t size);
+
+// Serve frad_malloc and friends on this thread from arena until
+// frame_arena_leave, returns the arena that was in use before
+frame_arena* frame_arena_enter(frame_arena* arena);
+void frame_arena_leave(frame_arena* previous);
+
+// malloc, calloc, realloc and free for libfrad's frame paths. Blocks come
+// from the thread's entered arena if there is one, else from the heap, and
+// may be freed on any thread: frad_free ignores arena blocks, they go with
+// the next reset. Heap blocks stay on the heap when reallocated.
+// Helper threads of a channel pool (encoder_set_channel_threads,
+// decoder_set_channel_threads) enter no arena, so the per-channel scratch they
+// take during a frame comes from the heap. Apart from that, the frame paths
+// allocate nothing once warm, bin/allocbench checks them without channel threads.
+void* frad_malloc(size_t size);
+void* frad_calloc(size_t count, size_t size);
+void* frad_realloc(void* ptr, size_t size);
+void frad_free(void* ptr);
+// The same as zlib's alloc_func and free_func, for z_stream.zalloc/zfree
+void* frad_zalloc(void* opaque, unsigned int items, unsigned int size);
+void frad_zfree(void* opaque, void* ptr);
+
+#ifdef FRAD_COUNT_ALLOCS
+// Heap allocations made so far for arena chunks and frad_* blocks outside an
+// arena, from every thread. Only built with -DFRAD_COUNT_ALLOCS (bin/allocbench)
+size_t frad_heap_allocs(void);
+#endif
+
+#endif // ARENA_H
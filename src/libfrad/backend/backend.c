@@ -1,17 +1,36 @@
 #include "backend.h"
+#include "arena.h"
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 #include <math.h>
 
+// Grow data to hold need values of elem bytes, at least doubling so that
+// appending one value at a time stays amortised O(1)
+static bool vec_grow(void** data, size_t* capacity, size_t need, size_t elem, bool view) {
+    if (need <= *capacity) return true;
+    if (view) return false;
+    if (need > SIZE_MAX / elem) return false;
+
+    size_t grown = *capacity * 2 > need ? *capacity * 2 : need;
+    if (grown > SIZE_MAX / elem) grown = need;
+    void* new_data = frad_realloc(*data, grown * elem);
+    if (!new_data) return false;
+    *data = new_data;
+    *capacity = grown;
+    return true;
+}
+
 // vec_u8 implementation
 vec_u8* vec_u8_new(size_t capacity) {
-    vec_u8* vec = (vec_u8*)malloc(sizeof(vec_u8));
+    vec_u8* vec = (vec_u8*)frad_malloc(sizeof(vec_u8));
     if (!vec) return NULL;
     vec->capacity = capacity > 0 ? capacity : 16;
     vec->size = 0;
-    vec->data = (uint8_t*)malloc(vec->capacity * sizeof(uint8_t));
+    vec->view = false;
+    vec->data = (uint8_t*)frad_malloc(vec->capacity * sizeof(uint8_t));
     if (!vec->data) {
-        free(vec);
+        frad_free(vec);
         return NULL;
     }
     return vec;
@@ -19,30 +38,55 @@ vec_u8* vec_u8_new(size_t capacity) {
 
 void vec_u8_free(vec_u8* vec) {
     if (vec) {
-        if (vec->data) free(vec->data);
-        free(vec);
+        if (vec->data) frad_free(vec->data);
+        frad_free(vec);
     }
 }
 
-void vec_u8_push(vec_u8* vec, uint8_t value) {
-    if (vec->size >= vec->capacity) {
-        vec->capacity *= 2;
-        uint8_t* new_data = (uint8_t*)realloc(vec->data, vec->capacity * sizeof(uint8_t));
-        if (!new_data) return; // Handle allocation failure
-        vec->data = new_data;
-    }
+bool vec_u8_reserve(vec_u8* vec, size_t n) {
+    if (n > SIZE_MAX - vec->size) return false;
+    return vec_grow((void**)&vec->data, &vec->capacity, vec->size + n, sizeof(uint8_t), vec->view);
+}
+
+bool vec_u8_push(vec_u8* vec, uint8_t value) {
+    if (vec->size >= vec->capacity && !vec_u8_reserve(vec, 1)) return false;
     vec->data[vec->size++] = value;
+    return true;
+}
+
+bool vec_u8_extend(vec_u8* vec, const uint8_t* values, size_t len) {
+    if (len == 0) return true;
+    if (!vec_u8_reserve(vec, len)) return false;
+    memcpy(vec->data + vec->size, values, len * sizeof(uint8_t));
+    vec->size += len;
+    return true;
+}
+
+bool vec_u8_resize(vec_u8* vec, size_t n) {
+    if (n > vec->size) {
+        if (!vec_u8_reserve(vec, n - vec->size)) return false;
+        memset(vec->data + vec->size, 0, (n - vec->size) * sizeof(uint8_t));
+    } else if (vec->view) {
+        return n == vec->size;
+    }
+    vec->size = n;
+    return true;
+}
+
+vec_u8 vec_u8_view(const uint8_t* data, size_t size) {
+    return (vec_u8){ (uint8_t*)data, size, size, true };
 }
 
 // vec_f64 implementation
 vec_f64* vec_f64_new(size_t capacity) {
-    vec_f64* vec = (vec_f64*)malloc(sizeof(vec_f64));
+    vec_f64* vec = (vec_f64*)frad_malloc(sizeof(vec_f64));
     if (!vec) return NULL;
     vec->capacity = capacity > 0 ? capacity : 16;
     vec->size = 0;
-    vec->data = (double*)malloc(vec->capacity * sizeof(double));
+    vec->view = false;
+    vec->data = (double*)frad_malloc(vec->capacity * sizeof(double));
     if (!vec->data) {
-        free(vec);
+        frad_free(vec);
         return NULL;
     }
     return vec;
@@ -50,50 +94,97 @@ vec_f64* vec_f64_new(size_t capacity) {
 
 void vec_f64_free(vec_f64* vec) {
     if (vec) {
-        if (vec->data) free(vec->data);
-        free(vec);
+        if (vec->data) frad_free(vec->data);
+        frad_free(vec);
     }
 }
 
-void vec_f64_push(vec_f64* vec, double value) {
-    if (vec->size >= vec->capacity) {
-        vec->capacity *= 2;
-        double* new_data = (double*)realloc(vec->data, vec->capacity * sizeof(double));
-        if (!new_data) return; // Handle allocation failure
-        vec->data = new_data;
-    }
+bool vec_f64_reserve(vec_f64* vec, size_t n) {
+    if (n > SIZE_MAX - vec->size) return false;
+    return vec_grow((void**)&vec->data, &vec->capacity, vec->size + n, sizeof(double), vec->view);
+}
+
+bool vec_f64_push(vec_f64* vec, double value) {
+    if (vec->size >= vec->capacity && !vec_f64_reserve(vec, 1)) return false;
     vec->data[vec->size++] = value;
+    return true;
+}
+
+bool vec_f64_extend(vec_f64* vec, const double* values, size_t len) {
+    if (len == 0) return true;
+    if (!vec_f64_reserve(vec, len)) return false;
+    memcpy(vec->data + vec->size, values, len * sizeof(double));
+    vec->size += len;
+    return true;
+}
+
+bool vec_f64_resize(vec_f64* vec, size_t n) {
+    if (n > vec->size) {
+        if (!vec_f64_reserve(vec, n - vec->size)) return false;
+        memset(vec->data + vec->size, 0, (n - vec->size) * sizeof(double));
+    } else if (vec->view) {
+        return n == vec->size;
+    }
+    vec->size = n;
+    return true;
+}
+
+vec_f64 vec_f64_view(const double* data, size_t size) {
+    return (vec_f64){ (double*)data, size, size, true };
 }
 
 // vec_i64 functions
 vec_i64* vec_i64_new(size_t capacity) {
-    vec_i64* vec = (vec_i64*)malloc(sizeof(vec_i64));
+    vec_i64* vec = (vec_i64*)frad_malloc(sizeof(vec_i64));
     if (!vec) return NULL;
 
-    vec->data = capacity > 0 ? (int64_t*)malloc(capacity * sizeof(int64_t)) : NULL;
+    vec->data = capacity > 0 ? (int64_t*)frad_malloc(capacity * sizeof(int64_t)) : NULL;
     vec->size = 0;
-    vec->capacity = capacity;
+    vec->capacity = vec->data ? capacity : 0;
+    vec->view = false;
     return vec;
 }
 
 void vec_i64_free(vec_i64* vec) {
     if (vec) {
-        free(vec->data);
-        free(vec);
+        frad_free(vec->data);
+        frad_free(vec);
     }
 }
 
-void vec_i64_push(vec_i64* vec, int64_t value) {
-    if (!vec) return;
+bool vec_i64_reserve(vec_i64* vec, size_t n) {
+    if (n > SIZE_MAX - vec->size) return false;
+    return vec_grow((void**)&vec->data, &vec->capacity, vec->size + n, sizeof(int64_t), vec->view);
+}
 
-    if (vec->size >= vec->capacity) {
-        size_t new_capacity = vec->capacity == 0 ? 1 : vec->capacity * 2;
-        int64_t* new_data = (int64_t*)realloc(vec->data, new_capacity * sizeof(int64_t));
-        if (!new_data) return;
-        vec->data = new_data;
-        vec->capacity = new_capacity;
-    }
+bool vec_i64_push(vec_i64* vec, int64_t value) {
+    if (!vec) return false;
+    if (vec->size >= vec->capacity && !vec_i64_reserve(vec, 1)) return false;
     vec->data[vec->size++] = value;
+    return true;
+}
+
+bool vec_i64_extend(vec_i64* vec, const int64_t* values, size_t len) {
+    if (len == 0) return true;
+    if (!vec_i64_reserve(vec, len)) return false;
+    memcpy(vec->data + vec->size, values, len * sizeof(int64_t));
+    vec->size += len;
+    return true;
+}
+
+bool vec_i64_resize(vec_i64* vec, size_t n) {
+    if (n > vec->size) {
+        if (!vec_i64_reserve(vec, n - vec->size)) return false;
+        memset(vec->data + vec->size, 0, (n - vec->size) * sizeof(int64_t));
+    } else if (vec->view) {
+        return n == vec->size;
+    }
+    vec->size = n;
+    return true;
+}
+
+vec_i64 vec_i64_view(const int64_t* data, size_t size) {
+    return (vec_i64){ (int64_t*)data, size, size, true };
 }
 
 vec_f64* linspace(double start, double end, size_t num, bool endpoint) {
@@ -102,8 +193,9 @@ vec_f64* linspace(double start, double end, size_t num, bool endpoint) {
 
     double step = (end - start) / (endpoint ? (num - 1) : num);
     for (size_t i = 0; i < num; i++) {
-        vec_f64_push(vec, start + i * step);
+        vec->data[i] = start + i * step;
     }
+    vec->size = num;
     return vec;
 }
 
@@ -137,9 +229,8 @@ vec_u8* vec_u8_split_front(vec_u8* vec, size_t n) {
 
     // Create result with first n bytes
     vec_u8* result = vec_u8_new(n);
-    for (size_t i = 0; i < n; i++) {
-        vec_u8_push(result, vec->data[i]);
-    }
+    if (!result) return NULL;
+    vec_u8_extend(result, vec->data, n);
 
     // Remove first n bytes from original vector
     memmove(vec->data, vec->data + n, vec->size - n);
@@ -148,6 +239,14 @@ vec_u8* vec_u8_split_front(vec_u8* vec, size_t n) {
     return result;
 }
 
+// Drop front - removes first n bytes from vec_u8, nothing is allocated
+void vec_u8_drop_front(vec_u8* vec, size_t n) {
+    if (!vec || n == 0) return;
+    if (n > vec->size) n = vec->size;
+    memmove(vec->data, vec->data + n, vec->size - n);
+    vec->size -= n;
+}
+
 // Split front - removes and returns first n elements from vec_f64
 vec_f64* vec_f64_split_front(vec_f64* vec, size_t n) {
     if (!vec || n == 0) return vec_f64_new(0);
@@ -157,9 +256,8 @@ vec_f64* vec_f64_split_front(vec_f64* vec, size_t n) {
 
     // Create result with first n elements
     vec_f64* result = vec_f64_new(n);
-    for (size_t i = 0; i < n; i++) {
-        vec_f64_push(result, vec->data[i]);
-    }
+    if (!result) return NULL;
+    vec_f64_extend(result, vec->data, n);
 
     // Remove first n elements from original vector
     memmove(vec->data, vec->data + n, (vec->size - n) * sizeof(double));
@@ -174,12 +272,7 @@ void vec_f64_prepend(vec_f64* dst, vec_f64* src) {
 
     // Ensure dst has enough capacity
     size_t new_size = dst->size + src->size;
-    if (new_size > dst->capacity) {
-        dst->capacity = new_size * 2;
-        double* new_data = (double*)realloc(dst->data, dst->capacity * sizeof(double));
-        if (!new_data) return;
-        dst->data = new_data;
-    }
+    if (!vec_f64_reserve(dst, src->size)) return;
 
     // Move existing data to make room at the front
     memmove(dst->data + src->size, dst->data, dst->size * sizeof(double));
@@ -194,13 +287,14 @@ vec_f64* hanning_in_overlap(size_t olap_len) {
     if (olap_len == 0) return vec_f64_new(0);
 
     vec_f64* window = vec_f64_new(olap_len);
+    if (!window) return NULL;
 
     // First half: reverse of (1.0 - hanning)
     size_t mid_point = ((olap_len + 1) >> 1) + 1;
     size_t first_half_len = olap_len - mid_point + 1;
 
     // Generate the second half first (for easier reversal)
-    double* temp = (double*)malloc(first_half_len * sizeof(double));
+    double* temp = (double*)frad_malloc(first_half_len * sizeof(double));
     for (size_t i = mid_point; i <= olap_len; i++) {
         double val = 0.5 * (1.0 - cos(M_PI * (double)i / ((double)olap_len + 1.0)));
         temp[i - mid_point] = val;
@@ -221,7 +315,7 @@ vec_f64* hanning_in_overlap(size_t olap_len) {
         vec_f64_push(window, temp[i]);
     }
 
-    free(temp);
+    frad_free(temp);
     return window;
 }
 
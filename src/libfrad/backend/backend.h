@@ -5,38 +5,62 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+// Every vector can also be a view: it borrows data it does not own, so it
+// is read-only in size, never grows and is never freed. Views live on the
+// stack and can be handed to anything that only reads a vector.
+// On allocation failure push, extend, reserve and resize return false and
+// leave the vector as it was.
+
 // Dynamic vector for uint8_t
 typedef struct {
     uint8_t* data;
     size_t size;
     size_t capacity;
+    bool view;
 } vec_u8;
 
 vec_u8* vec_u8_new(size_t capacity);
 void vec_u8_free(vec_u8* vec);
-void vec_u8_push(vec_u8* vec, uint8_t value);
+bool vec_u8_push(vec_u8* vec, uint8_t value);
+// Append len values in one go
+bool vec_u8_extend(vec_u8* vec, const uint8_t* values, size_t len);
+// Make room for n more values without changing the size
+bool vec_u8_reserve(vec_u8* vec, size_t n);
+// Set the size to n, new values are zero
+bool vec_u8_resize(vec_u8* vec, size_t n);
+vec_u8 vec_u8_view(const uint8_t* data, size_t size);
 
 // Dynamic vector for double
 typedef struct {
     double* data;
     size_t size;
     size_t capacity;
+    bool view;
 } vec_f64;
 
 vec_f64* vec_f64_new(size_t capacity);
 void vec_f64_free(vec_f64* vec);
-void vec_f64_push(vec_f64* vec, double value);
+bool vec_f64_push(vec_f64* vec, double value);
+bool vec_f64_extend(vec_f64* vec, const double* values, size_t len);
+bool vec_f64_reserve(vec_f64* vec, size_t n);
+bool vec_f64_resize(vec_f64* vec, size_t n);
+vec_f64 vec_f64_view(const double* data, size_t size);
 
 // Dynamic vector for int64_t
 typedef struct {
     int64_t* data;
     size_t size;
     size_t capacity;
+    bool view;
 } vec_i64;
 
 vec_i64* vec_i64_new(size_t capacity);
 void vec_i64_free(vec_i64* vec);
-void vec_i64_push(vec_i64* vec, int64_t value);
+bool vec_i64_push(vec_i64* vec, int64_t value);
+bool vec_i64_extend(vec_i64* vec, const int64_t* values, size_t len);
+bool vec_i64_reserve(vec_i64* vec, size_t n);
+bool vec_i64_resize(vec_i64* vec, size_t n);
+vec_i64 vec_i64_view(const int64_t* data, size_t size);
 
 vec_f64* linspace(double start, double end, size_t num, bool endpoint);
 
@@ -45,6 +69,8 @@ int vec_u8_find_pattern(vec_u8* haystack, const uint8_t* needle, size_t needle_l
 
 // Split front - removes and returns first n bytes from vec_u8
 vec_u8* vec_u8_split_front(vec_u8* vec, size_t n);
+// Drop front - removes the first n bytes without returning them
+void vec_u8_drop_front(vec_u8* vec, size_t n);
 
 // Split front - removes and returns first n elements from vec_f64
 vec_f64* vec_f64_split_front(vec_f64* vec, size_t n);
@@ -1,4 +1,5 @@
 #include "bitcvt.h"
+#include "arena.h"
 #include <string.h>
 
 bool* to_bits(const uint8_t* bytes, size_t byte_count, size_t* bit_count) {
@@ -8,7 +9,7 @@ bool* to_bits(const uint8_t* bytes, size_t byte_count, size_t* bit_count) {
     }
 
     *bit_count = byte_count * 8;
-    bool* bits = (bool*)malloc(*bit_count * sizeof(bool));
+    bool* bits = (bool*)frad_malloc(*bit_count * sizeof(bool));
     if (!bits) {
         *bit_count = 0;
         return NULL;
@@ -32,7 +33,7 @@ uint8_t* to_bytes(const bool* bitstream, size_t bit_count, size_t* byte_count) {
 
     // Calculate number of bytes needed (padding with zeros if necessary)
     *byte_count = (bit_count + 7) / 8;
-    uint8_t* bytes = (uint8_t*)calloc(*byte_count, sizeof(uint8_t));
+    uint8_t* bytes = (uint8_t*)frad_calloc(*byte_count, sizeof(uint8_t));
     if (!bytes) {
         *byte_count = 0;
         return NULL;
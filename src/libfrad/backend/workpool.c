@@ -0,0 +1,177 @@
+#include "workpool.h"
+#include "arena.h"
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+
+struct workpool {
+    pthread_mutex_t lock;
+    pthread_cond_t task_ready;  // Signalled on submit and shutdown
+    pthread_cond_t task_done;   // Broadcast whenever a task completes
+    workpool_task* head;
+    workpool_task* tail;
+    pthread_t* workers;
+    size_t threads;
+    bool stop;
+};
+
+static void* worker_main(void* arg) {
+    workpool_t* pool = (workpool_t*)arg;
+
+    pthread_mutex_lock(&pool->lock);
+    while (true) {
+        while (!pool->head && !pool->stop) pthread_cond_wait(&pool->task_ready, &pool->lock);
+        // Stop only once the queue is drained
+        if (!pool->head) break;
+
+        workpool_task* task = pool->head;
+        pool->head = task->next;
+        if (!pool->head) pool->tail = NULL;
+        pthread_mutex_unlock(&pool->lock);
+
+        task->run(task);
+
+        pthread_mutex_lock(&pool->lock);
+        task->done = true;
+        pthread_cond_broadcast(&pool->task_done);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+// Runs of one workpool_parallel_for, claimed one at a time by helpers and the caller
+typedef struct {
+    pthread_mutex_t lock;
+    size_t next;
+    size_t count;
+    size_t grain;
+    workpool_range_fn fn;
+    void* ctx;
+} range_shared;
+
+typedef struct {
+    workpool_task task;  // First member, run() casts back to the helper
+    range_shared* shared;
+} range_helper;
+
+static void range_drain(range_shared* shared) {
+    while (true) {
+        pthread_mutex_lock(&shared->lock);
+        size_t begin = shared->next;
+        if (begin < shared->count) shared->next = begin + shared->grain < shared->count ? begin + shared->grain : shared->count;
+        size_t end = shared->next;
+        pthread_mutex_unlock(&shared->lock);
+
+        if (begin >= end) return;
+        shared->fn(shared->ctx, begin, end);
+    }
+}
+
+static void range_helper_run(workpool_task* task) {
+    range_drain(((range_helper*)task)->shared);
+}
+
+void workpool_parallel_for(workpool_t* pool, size_t count, size_t grain, workpool_range_fn fn, void* ctx) {
+    if (count == 0) return;
+    if (grain == 0) grain = 1;
+
+    size_t runs = (count + grain - 1) / grain;
+    size_t helpers = pool ? (runs - 1 < pool->threads ? runs - 1 : pool->threads) : 0;
+    // From the caller's frame arena when it has one entered
+    range_helper* helper = helpers ? (range_helper*)frad_malloc(helpers * sizeof(range_helper)) : NULL;
+    if (!helper) {
+        fn(ctx, 0, count);
+        return;
+    }
+
+    range_shared shared = { .next = 0, .count = count, .grain = grain, .fn = fn, .ctx = ctx };
+    pthread_mutex_init(&shared.lock, NULL);
+    for (size_t i = 0; i < helpers; i++) {
+        helper[i].task.run = range_helper_run;
+        helper[i].shared = &shared;
+        workpool_submit(pool, &helper[i].task);
+    }
+
+    range_drain(&shared);
+    // Helpers that start late find nothing left, but still have to finish
+    for (size_t i = 0; i < helpers; i++) workpool_wait(pool, &helper[i].task);
+
+    pthread_mutex_destroy(&shared.lock);
+    frad_free(helper);
+}
+
+size_t workpool_cpu_count(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (size_t)n : 1;
+}
+
+workpool_t* workpool_new(size_t threads) {
+    if (threads == 0) threads = workpool_cpu_count();
+
+    workpool_t* pool = (workpool_t*)calloc(1, sizeof(workpool_t));
+    if (!pool) return NULL;
+    pool->workers = (pthread_t*)calloc(threads, sizeof(pthread_t));
+    if (!pool->workers) {
+        free(pool);
+        return NULL;
+    }
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->task_ready, NULL);
+    pthread_cond_init(&pool->task_done, NULL);
+
+    for (size_t i = 0; i < threads; i++) {
+        if (pthread_create(&pool->workers[i], NULL, worker_main, pool) != 0) break;
+        pool->threads++;
+    }
+    if (pool->threads == 0) {
+        workpool_free(pool);
+        return NULL;
+    }
+    return pool;
+}
+
+void workpool_free(workpool_t* pool) {
+    if (!pool) return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = true;
+    pthread_cond_broadcast(&pool->task_ready);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (size_t i = 0; i < pool->threads; i++) pthread_join(pool->workers[i], NULL);
+
+    pthread_cond_destroy(&pool->task_done);
+    pthread_cond_destroy(&pool->task_ready);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->workers);
+    free(pool);
+}
+
+size_t workpool_threads(const workpool_t* pool) {
+    return pool ? pool->threads : 0;
+}
+
+void workpool_submit(workpool_t* pool, workpool_task* task) {
+    task->next = NULL;
+    task->done = false;
+
+    pthread_mutex_lock(&pool->lock);
+    if (pool->tail) pool->tail->next = task;
+    else pool->head = task;
+    pool->tail = task;
+    pthread_cond_signal(&pool->task_ready);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void workpool_wait(workpool_t* pool, workpool_task* task) {
+    pthread_mutex_lock(&pool->lock);
+    while (!task->done) pthread_cond_wait(&pool->task_done, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+bool workpool_is_done(workpool_t* pool, workpool_task* task) {
+    pthread_mutex_lock(&pool->lock);
+    bool done = task->done;
+    pthread_mutex_unlock(&pool->lock);
+    return done;
+}
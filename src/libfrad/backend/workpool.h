@@ -0,0 +1,37 @@
+#ifndef WORKPOOL_H
+#define WORKPOOL_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+// A task is embedded in the caller's job struct, run() receives it back
+typedef struct workpool_task {
+    void (*run)(struct workpool_task* task);
+    struct workpool_task* next;
+    bool done;
+} workpool_task;
+
+// Fixed set of worker threads draining a FIFO of tasks
+typedef struct workpool workpool_t;
+
+// threads == 0 picks the number of online CPUs
+workpool_t* workpool_new(size_t threads);
+// Runs every queued task to completion before joining the workers
+void workpool_free(workpool_t* pool);
+size_t workpool_threads(const workpool_t* pool);
+
+// The task must stay alive until workpool_wait has returned for it
+void workpool_submit(workpool_t* pool, workpool_task* task);
+void workpool_wait(workpool_t* pool, workpool_task* task);
+bool workpool_is_done(workpool_t* pool, workpool_task* task);
+
+// Split [0, count) into runs of `grain` and hand them to the pool and the
+// calling thread, returns once every run is done. A NULL pool runs it all
+// inline. Must not be called from a task of the same pool.
+typedef void (*workpool_range_fn)(void* ctx, size_t begin, size_t end);
+void workpool_parallel_for(workpool_t* pool, size_t count, size_t grain, workpool_range_fn fn, void* ctx);
+
+// Number of online CPUs, at least 1
+size_t workpool_cpu_count(void);
+
+#endif // WORKPOOL_H
@@ -1,4 +1,5 @@
 #include "common.h"
+#include <pthread.h>
 
 const uint8_t SIGNATURE[] = { 0x66, 0x52, 0x61, 0x64 };
 const uint8_t FRM_SIGN[] = { 0xff, 0xd0, 0xd2, 0x97 };
@@ -34,14 +35,16 @@ static void build_crc32_table() {
     }
 }
 
-static int crc_tables_built = 0;
+// Decoder workers check CRCs concurrently
+static pthread_once_t crc_tables_once = PTHREAD_ONCE_INIT;
+
+static void build_crc_tables_once(void) {
+    build_crc16_table();
+    build_crc32_table();
+}
 
 static void build_crc_tables() {
-    if (!crc_tables_built) {
-        build_crc16_table();
-        build_crc32_table();
-        crc_tables_built = 1;
-    }
+    pthread_once(&crc_tables_once, build_crc_tables_once);
 }
 
 uint16_t crc16_ansi(uint16_t crc, const uint8_t* data, size_t len) {
@@ -12,6 +12,14 @@ typedef struct {
     uint32_t sample_rate;
 } encoded_packet;
 
+// Outcome of the *_process_into and *_flush_into calls
+typedef enum {
+    FRAD_STATUS_NEED_INPUT,      // All input taken and all output written
+    FRAD_STATUS_OUTPUT_FULL,     // Output buffer full, call again for the rest
+    FRAD_STATUS_STREAM_CHANGED,  // Decoder: channels or sample rate change after this output
+    FRAD_STATUS_ERROR
+} frad_status_t;
+
 extern const uint8_t SIGNATURE[];
 extern const uint8_t FRM_SIGN[];
 
@@ -6,22 +6,65 @@
 #include "fourier/profile1.h"
 #include "fourier/profile2.h"
 #include "fourier/profile4.h"
+#include "fourier/tools/zstream.h"
 #include "common.h"
+#include "backend/workpool.h"
+#include "backend/arena.h"
 #include <stdlib.h>
 #include <string.h>
 
+// One split frame on its way through ECC and the profile decoder
+typedef struct decode_job {
+    workpool_task task;  // First member, run() casts back to the job
+    struct decode_job* next;
+    frame_arena* arena;  // Everything the frame allocates, kept when the job is reused
+    zstream_cache* zs;   // Deflate/inflate state, likewise kept
+
+    // Input and the header it was parsed with
+    vec_u8* frad;
+    ASFH head;
+    bool fix_error;
+    bool f32;
+    workpool_t* channel_pool;
+
+    // Output in the arena, NULL if the frame could not be decoded
+    vec_f64* pcm;
+} decode_job;
+
 struct decoder {
     ASFH* asfh;
     ASFH* info;
     vec_u8* buffer;
     vec_f64* overlap_fragment;
+    vec_f64* fade_in;  // Hanning window of the last overlap length
     bool fix_error;
     bool broken_frame;
+    bool f32;
+
+    // Frame-parallel mode: frames in flight, oldest first
+    size_t threads;
+    workpool_t* pool;
+    workpool_t* channel_pool;  // Channels of one frame, NULL for none
+    decode_job* pending_head;
+    decode_job* pending_tail;
+    size_t pending;
+    decode_job* spare;  // Finished jobs, arenas warm, for the next frames
+
+    // decoder_process_into: PCM not yet handed out is stage[stage_pos..],
+    // in the format below, and stage_crit if a new stream follows it.
+    // stage_flush while decoder_flush_into is still handing out its PCM.
+    vec_f64* stage;
+    size_t stage_pos;
+    uint16_t stage_channels;
+    uint32_t stage_srate;
+    bool stage_crit;
+    bool stage_flush;
 };
 
 // Apply overlap to the decoded PCM (implementation of Rust version)
-static vec_f64* overlap(decoder_t* dec, vec_f64* frame) {
-    size_t channels = (dec->asfh->channels > 0) ? dec->asfh->channels : 1;
+// head is the header the frame was parsed with
+static vec_f64* overlap(decoder_t* dec, const ASFH* head, vec_f64* frame) {
+    size_t channels = (head->channels > 0) ? head->channels : 1;
 
     // 1. If overlap buffer not empty, apply Forward linear overlap-add
     if (dec->overlap_fragment && dec->overlap_fragment->size > 0) {
@@ -29,7 +72,11 @@ static vec_f64* overlap(decoder_t* dec, vec_f64* frame) {
         size_t frame_samples = frame->size / channels;
         size_t actual_overlap_len = (overlap_len < frame_samples) ? overlap_len : frame_samples;
 
-        vec_f64* fade_in = hanning_in_overlap(actual_overlap_len);
+        if (!dec->fade_in || dec->fade_in->size != actual_overlap_len) {
+            vec_f64_free(dec->fade_in);
+            dec->fade_in = hanning_in_overlap(actual_overlap_len);
+        }
+        const vec_f64* fade_in = dec->fade_in;
 
         for (size_t i = 0; i < actual_overlap_len; i++) {
             for (size_t j = 0; j < channels; j++) {
@@ -38,78 +85,251 @@ static vec_f64* overlap(decoder_t* dec, vec_f64* frame) {
                 frame->data[idx] += dec->overlap_fragment->data[idx] * fade_in->data[fade_in->size - i - 1];
             }
         }
-
-        vec_f64_free(fade_in);
     }
 
-    // 2. If COMPACT profile and overlap is enabled, split this frame
-    vec_f64* next_overlap = vec_f64_new(0);
-    if ((dec->asfh->profile == 1 || dec->asfh->profile == 2) && dec->asfh->overlap_ratio != 0) {
-        size_t overlap_ratio = dec->asfh->overlap_ratio;
+    // 2. If COMPACT profile and overlap is enabled, split this frame,
+    // the tail becomes the next overlap fragment in the same buffer
+    dec->overlap_fragment->size = 0;
+    if ((head->profile == 1 || head->profile == 2) && head->overlap_ratio != 0) {
+        size_t overlap_ratio = head->overlap_ratio;
         // Samples * (Overlap ratio - 1) / Overlap ratio
         // e.g., ([2048], overlap_ratio=16) -> [1920, 128]
         size_t frame_cutout = (frame->size / channels) * (overlap_ratio - 1) / overlap_ratio;
 
-        // Copy the end portion to next_overlap
-        for (size_t i = frame_cutout * channels; i < frame->size; i++) {
-            vec_f64_push(next_overlap, frame->data[i]);
-        }
+        // Copy the end portion to the overlap fragment
+        vec_f64_extend(dec->overlap_fragment, frame->data + frame_cutout * channels, frame->size - frame_cutout * channels);
 
         // Truncate frame
         frame->size = frame_cutout * channels;
     }
 
-    // Replace overlap fragment
-    vec_f64_free(dec->overlap_fragment);
-    dec->overlap_fragment = next_overlap;
-
     return frame;
 }
 
 decoder_t* decoder_new(bool fix_error) {
-    decoder_t* dec = calloc(1, sizeof(decoder_t));
+    decoder_t* dec = frad_calloc(1, sizeof(decoder_t));
     if (!dec) return NULL;
 
     dec->asfh = asfh_new();
     dec->info = asfh_new();
     dec->buffer = vec_u8_new(0);
     dec->overlap_fragment = vec_f64_new(0);
+    dec->stage = vec_f64_new(0);
 
-    if (!dec->asfh || !dec->info || !dec->buffer || !dec->overlap_fragment) {
+    if (!dec->asfh || !dec->info || !dec->buffer || !dec->overlap_fragment || !dec->stage) {
         decoder_free(dec);
         return NULL;
     }
 
     dec->fix_error = fix_error;
     dec->broken_frame = false;
+    dec->threads = 1;
 
     return dec;
 }
 
+void decoder_set_float32(decoder_t* dec, bool f32) {
+    if (dec) dec->f32 = f32;
+}
+
+static void decode_job_free(decode_job* job) {
+    if (!job) return;
+    frame_arena_free(job->arena);
+    zstream_cache_free(job->zs);
+    free(job);
+}
+
+// A cleared job, a spare one if there is any so its arena is already grown
+static decode_job* decode_job_take(decoder_t* dec) {
+    decode_job* job = dec->spare;
+    if (job) {
+        dec->spare = job->next;
+        frame_arena* arena = job->arena;
+        zstream_cache* zs = job->zs;
+        frame_arena_reset(arena);
+        memset(job, 0, sizeof(decode_job));
+        job->arena = arena;
+        job->zs = zs;
+        return job;
+    }
+
+    job = calloc(1, sizeof(decode_job));
+    if (!job) return NULL;
+    job->arena = frame_arena_new();
+    job->zs = zstream_cache_new();
+    if (!job->arena || !job->zs) {
+        decode_job_free(job);
+        return NULL;
+    }
+    return job;
+}
+
+// The frame and its PCM live in the arena, they go with its next reset
+static void decode_job_recycle(decoder_t* dec, decode_job* job) {
+    job->next = dec->spare;
+    dec->spare = job;
+}
+
+void decoder_set_threads(decoder_t* dec, size_t threads) {
+    if (!dec) return;
+
+    // Frames in flight finish on the old pool and go out with the next call
+    workpool_free(dec->pool);
+    dec->pool = NULL;
+
+    dec->threads = threads == 0 ? workpool_cpu_count() : threads;
+    if (dec->threads > 1) {
+        dec->pool = workpool_new(dec->threads);
+        if (!dec->pool) dec->threads = 1;
+        else dec->threads = workpool_threads(dec->pool);
+    }
+}
+
+void decoder_set_channel_threads(decoder_t* dec, size_t threads) {
+    if (!dec) return;
+
+    // Frames in flight may still use the old pool
+    if (dec->pool) {
+        for (decode_job* job = dec->pending_head; job; job = job->next) workpool_wait(dec->pool, &job->task);
+    }
+    workpool_free(dec->channel_pool);
+    dec->channel_pool = NULL;
+
+    if (threads == 0) threads = workpool_cpu_count();
+    if (threads > 1) dec->channel_pool = workpool_new(threads);
+}
+
 void decoder_free(decoder_t* dec) {
     if (!dec) return;
 
+    // Let the workers finish, frames still in flight are dropped
+    workpool_free(dec->pool);
+    workpool_free(dec->channel_pool);
+    while (dec->pending_head) {
+        decode_job* job = dec->pending_head;
+        dec->pending_head = job->next;
+        decode_job_free(job);
+    }
+    while (dec->spare) {
+        decode_job* job = dec->spare;
+        dec->spare = job->next;
+        decode_job_free(job);
+    }
+
     if (dec->asfh) asfh_free(dec->asfh);
     if (dec->info) asfh_free(dec->info);
     if (dec->buffer) vec_u8_free(dec->buffer);
     if (dec->overlap_fragment) vec_f64_free(dec->overlap_fragment);
-    free(dec);
+    if (dec->fade_in) vec_f64_free(dec->fade_in);
+    if (dec->stage) vec_f64_free(dec->stage);
+    frad_free(dec);
 }
 
-decode_result_t* decoder_process(decoder_t* dec, const uint8_t* stream, size_t stream_len) {
-    if (!dec) return NULL;
+// Steps 1.2 and 1.3 of decoder_process, touches nothing but the job
+static void decode_job_run(workpool_task* task) {
+    decode_job* job = (decode_job*)task;
+    ASFH* head = &job->head;
+    vec_u8* frad = job->frad;
+    job->frad = NULL;
+    frame_arena* previous = frame_arena_enter(job->arena);
+
+    // 1.2. Correct the error if ECC is enabled
+    if (head->ecc) {
+        bool repair = job->fix_error && (
+            // and if CRC mismatch
+            ((head->profile == 0 || head->profile == 4) && frad_crc32(0, frad->data, frad->size) != head->crc32) ||
+            ((head->profile == 1 || head->profile == 2) && crc16_ansi(0, frad->data, frad->size) != head->crc16)
+        );
+        vec_u8* corrected = ecc_decode(frad, head->ecc_ratio, repair);
+        vec_u8_free(frad);
+        frad = corrected;
+    }
+
+    // 1.3. Decode the FrAD frame
+    vec_f64* pcm = NULL;
+    switch (head->profile) {
+        case 1:
+            pcm = profile1_digital(frad->data, frad->size, head->bit_depth_index,
+                                  head->channels, head->srate, head->fsize, head->endian,
+                                  job->f32, job->channel_pool, job->zs);
+            break;
+        case 2:
+            pcm = profile2_digital(frad->data, frad->size, head->bit_depth_index,
+                                  head->channels, head->srate, head->fsize, head->endian,
+                                  job->f32, job->zs);
+            break;
+        case 4:
+            pcm = profile4_digital(frad->data, frad->size, head->bit_depth_index,
+                                  head->channels, head->endian);
+            break;
+        default: // Profile 0
+            pcm = profile0_digital(frad->data, frad->size, head->bit_depth_index,
+                                  head->channels, head->endian, job->channel_pool);
+            break;
+    }
+
+    job->pcm = pcm;
+    frame_arena_leave(previous);
+}
+
+// Hand a split frame to the pool, or decode it right here when single-threaded
+static void decoder_dispatch(decoder_t* dec, decode_job* job) {
+    job->task.run = decode_job_run;
+    job->next = NULL;
+    if (dec->pending_tail) dec->pending_tail->next = job;
+    else dec->pending_head = job;
+    dec->pending_tail = job;
+    dec->pending++;
+
+    if (dec->pool) {
+        workpool_submit(dec->pool, &job->task);
+    } else {
+        decode_job_run(&job->task);
+        job->task.done = true;
+    }
+}
+
+// Overlap-add finished frames in split order and append them to out
+// Waits until at most `keep` frames are in flight
+static void decoder_emit(decoder_t* dec, vec_f64* out, size_t* frames, size_t keep) {
+    while (dec->pending_head) {
+        decode_job* job = dec->pending_head;
+        if (dec->pool) {
+            if (dec->pending > keep) workpool_wait(dec->pool, &job->task);
+            else if (!workpool_is_done(dec->pool, &job->task)) break;
+        }
+        dec->pending_head = job->next;
+        if (!dec->pending_head) dec->pending_tail = NULL;
+        dec->pending--;
+
+        vec_f64* pcm = job->pcm;
+        if (pcm) {
+            // 1.4. Apply overlap
+            pcm = overlap(dec, &job->head, pcm);
+
+            // 1.5. Append the decoded PCM
+            vec_f64_extend(out, pcm->data, pcm->size);
+            (*frames)++;
+        }
+        decode_job_recycle(dec, job);
+    }
+}
 
+// Decode what the buffered stream holds into ret_pcm and fill in the
+// format it is in, returns true if it ends a stream and a new one follows
+static bool decoder_inner(decoder_t* dec, const uint8_t* stream, size_t stream_len, vec_f64* ret_pcm,
+                          size_t* ret_frames, uint16_t* ret_channels, uint32_t* ret_srate) {
     // Extend buffer with new stream data
     if (stream && stream_len > 0) {
-        for (size_t i = 0; i < stream_len; i++) {
-            vec_u8_push(dec->buffer, stream[i]);
-        }
+        vec_u8_extend(dec->buffer, stream, stream_len);
     }
 
-    vec_f64* ret_pcm = vec_f64_new(0);
     size_t frames = 0;
     bool crit = false;
 
+    // Frames in flight before the demuxer waits for the oldest one
+    size_t max_pending = dec->pool ? dec->threads * 2 : 0;
+
     while (true) {
         // If every parameter in the ASFH struct is set
         /* 1. Decoding FrAD Frame */
@@ -122,56 +342,27 @@ decode_result_t* decoder_process(decoder_t* dec, const uint8_t* stream, size_t s
                 break;
             }
 
-            // 1.1. Split out the frame data
-            vec_u8* frad = vec_u8_split_front(dec->buffer, (size_t)dec->asfh->frmbytes);
-
-            // 1.2. Correct the error if ECC is enabled
-            if (dec->asfh->ecc) {
-                bool repair = dec->fix_error && (
-                    // and if CRC mismatch
-                    ((dec->asfh->profile == 0 || dec->asfh->profile == 4) && frad_crc32(0, frad->data, frad->size) != dec->asfh->crc32) ||
-                    ((dec->asfh->profile == 1 || dec->asfh->profile == 2) && crc16_ansi(0, frad->data, frad->size) != dec->asfh->crc16)
-                );
-                vec_u8* corrected = ecc_decode(frad, dec->asfh->ecc_ratio, repair);
-                vec_u8_free(frad);
-                frad = corrected;
-            }
-
-            // 1.3. Decode the FrAD frame
-            vec_f64* pcm = NULL;
-            switch (dec->asfh->profile) {
-                case 1:
-                    pcm = profile1_digital(frad->data, frad->size, dec->asfh->bit_depth_index,
-                                          dec->asfh->channels, dec->asfh->srate, dec->asfh->fsize, dec->asfh->endian);
-                    break;
-                case 2:
-                    pcm = profile2_digital(frad->data, frad->size, dec->asfh->bit_depth_index,
-                                          dec->asfh->channels, dec->asfh->srate, dec->asfh->fsize, dec->asfh->endian);
-                    break;
-                case 4:
-                    pcm = profile4_digital(frad->data, frad->size, dec->asfh->bit_depth_index,
-                                          dec->asfh->channels, dec->asfh->endian);
-                    break;
-                default: // Profile 0
-                    pcm = profile0_digital(frad->data, frad->size, dec->asfh->bit_depth_index,
-                                          dec->asfh->channels, dec->asfh->endian);
-                    break;
-            }
-
-            vec_u8_free(frad);
-
-            if (pcm) {
-                // 1.4. Apply overlap
-                pcm = overlap(dec, pcm);
-
-                // 1.5. Append the decoded PCM and clear header
-                for (size_t i = 0; i < pcm->size; i++) {
-                    vec_f64_push(ret_pcm, pcm->data[i]);
-                }
-                vec_f64_free(pcm);
-                frames++;
+            // 1.1. Split out the frame data, into the arena of the job that decodes it
+            decode_job* job = decode_job_take(dec);
+            if (!job) {
+                vec_u8_drop_front(dec->buffer, (size_t)dec->asfh->frmbytes);
+                asfh_clear(dec->asfh);
+                continue;
             }
-
+            frame_arena* previous = frame_arena_enter(job->arena);
+            job->frad = vec_u8_split_front(dec->buffer, (size_t)dec->asfh->frmbytes);
+            frame_arena_leave(previous);
+
+            // 1.2-1.3. Correct and decode the frame, on a worker if there is a pool
+            job->head = *dec->asfh;
+            job->head.buffer = NULL;  // Still owned by dec->asfh
+            job->fix_error = dec->fix_error;
+            job->f32 = dec->f32;
+            job->channel_pool = dec->channel_pool;
+            decoder_dispatch(dec, job);
+
+            // 1.4-1.5. Overlap and append every frame that is ready, then clear header
+            decoder_emit(dec, ret_pcm, &frames, max_pending);
             asfh_clear(dec->asfh);
         }
 
@@ -184,19 +375,16 @@ decode_result_t* decoder_process(decoder_t* dec, const uint8_t* stream, size_t s
                 int pattern_pos = vec_u8_find_pattern(dec->buffer, FRM_SIGN, 4);
                 if (pattern_pos >= 0) {
                     // 2.1.1. Split out the buffer to the header buffer
-                    vec_u8* discarded = vec_u8_split_front(dec->buffer, pattern_pos);
-                    vec_u8_free(discarded);
+                    vec_u8_drop_front(dec->buffer, pattern_pos);
 
                     // Take the FRM_SIGN bytes and put them in ASFH buffer
-                    vec_u8* sign_bytes = vec_u8_split_front(dec->buffer, 4);
-                    if (sign_bytes) {
-                        vec_u8_free(dec->asfh->buffer);
-                        dec->asfh->buffer = sign_bytes;
-                    }
+                    dec->asfh->buffer->size = 0;
+                    vec_u8_extend(dec->asfh->buffer, dec->buffer->data, 4);
+                    vec_u8_drop_front(dec->buffer, 4);
                 } else {
                     // 2.1.2. else, Split out the buffer to the last 3 bytes and return
                     if (dec->buffer->size > 3) {
-                        vec_u8_free(vec_u8_split_front(dec->buffer, dec->buffer->size - 3));
+                        vec_u8_drop_front(dec->buffer, dec->buffer->size - 3);
                     }
                     break;
                 }
@@ -219,31 +407,28 @@ decode_result_t* decoder_process(decoder_t* dec, const uint8_t* stream, size_t s
                         dec->info->srate = dec->asfh->srate;
 
                         if (old_srate != 0 || old_channels != 0) { // If the info struct is not empty
+                            // Frames of the old stream go out first
+                            decoder_emit(dec, ret_pcm, &frames, 0);
+
                             // Flush the overlap buffer and return with critical flag
-                            for (size_t i = 0; i < dec->overlap_fragment->size; i++) {
-                                vec_f64_push(ret_pcm, dec->overlap_fragment->data[i]);
-                            }
+                            vec_f64_extend(ret_pcm, dec->overlap_fragment->data, dec->overlap_fragment->size);
                             dec->overlap_fragment->size = 0;
 
-                            decode_result_t* result = calloc(1, sizeof(decode_result_t));
-                            if (result) {
-                                result->pcm = ret_pcm;
-                                result->channels = old_channels;
-                                result->srate = old_srate;
-                                result->frames = frames;
-                                result->crit = true;
-                            }
-                            return result;
+                            *ret_frames = frames;
+                            *ret_channels = old_channels;
+                            *ret_srate = old_srate;
+                            return true;
                         }
                     }
                     break;
 
                 // 2.3.2. If header is complete and forced to flush, flush and return
                 case PARSE_FORCE_FLUSH:
-                    for (size_t i = 0; i < dec->overlap_fragment->size; i++) {
-                        vec_f64_push(ret_pcm, dec->overlap_fragment->data[i]);
-                    }
+                    decoder_emit(dec, ret_pcm, &frames, 0);
+                    vec_f64_extend(ret_pcm, dec->overlap_fragment->data, dec->overlap_fragment->size);
                     dec->overlap_fragment->size = 0;
+                    // The flush header carries no frame, do not decode an empty one next call
+                    asfh_clear(dec->asfh);
                     goto end_loop;
 
                 // 2.3.3. If header is incomplete, return
@@ -254,50 +439,140 @@ decode_result_t* decoder_process(decoder_t* dec, const uint8_t* stream, size_t s
     }
 
 end_loop:
-    ;
-    decode_result_t* result = calloc(1, sizeof(decode_result_t));
-    if (result) {
-        result->pcm = ret_pcm;
-        result->channels = dec->asfh->channels;
-        result->srate = dec->asfh->srate;
-        result->frames = frames;
-        result->crit = crit;
-    } else {
-        vec_f64_free(ret_pcm);
+    *ret_frames = frames;
+    *ret_channels = dec->asfh->channels;
+    *ret_srate = dec->asfh->srate;
+    return crit;
+}
+
+decode_result_t* decoder_process(decoder_t* dec, const uint8_t* stream, size_t stream_len) {
+    if (!dec) return NULL;
+
+    decode_result_t* result = frad_calloc(1, sizeof(decode_result_t));
+    if (!result) return NULL;
+    result->pcm = vec_f64_new(0);
+    if (!result->pcm) {
+        frad_free(result);
+        return NULL;
     }
 
+    result->crit = decoder_inner(dec, stream, stream_len, result->pcm,
+                                 &result->frames, &result->channels, &result->srate);
     return result;
 }
 
+// Frames still in flight, then the overlap buffer, returns the frame count
+static size_t decoder_flush_inner(decoder_t* dec, vec_f64* out) {
+    size_t frames = 0;
+    decoder_emit(dec, out, &frames, 0);
+    vec_f64_extend(out, dec->overlap_fragment->data, dec->overlap_fragment->size);
+    dec->overlap_fragment->size = 0;
+    return frames;
+}
+
 decode_result_t* decoder_flush(decoder_t* dec) {
     if (!dec) return NULL;
 
-    decode_result_t* result = calloc(1, sizeof(decode_result_t));
+    decode_result_t* result = frad_calloc(1, sizeof(decode_result_t));
     if (!result) return NULL;
 
-    // Extract the overlap buffer
     result->pcm = vec_f64_new(dec->overlap_fragment->size);
-    for (size_t i = 0; i < dec->overlap_fragment->size; i++) {
-        vec_f64_push(result->pcm, dec->overlap_fragment->data[i]);
+    if (!result->pcm) {
+        frad_free(result);
+        return NULL;
     }
 
+    result->frames = decoder_flush_inner(dec, result->pcm);
     result->channels = dec->asfh->channels;
     result->srate = dec->asfh->srate;
-    result->frames = 0;
     result->crit = true;
 
-    // Clear the overlap buffer and ASFH struct
-    dec->overlap_fragment->size = 0;
+    // Clear the ASFH struct
     asfh_clear(dec->asfh);
 
     return result;
 }
 
+// Hand out whole samples of the stage after the *written already in out,
+// the stage is emptied once all of them are taken
+static frad_status_t decoder_drain(decoder_t* dec, double* out, size_t out_cap, size_t* written) {
+    size_t channels = dec->stage_channels > 0 ? dec->stage_channels : 1;
+    size_t left = dec->stage->size - dec->stage_pos;
+    size_t room = out_cap - *written;
+    size_t n = left < room ? left : room - room % channels;
+    if (n > 0) memcpy(out + *written, dec->stage->data + dec->stage_pos, n * sizeof(double));
+    *written += n;
+
+    dec->stage_pos += n;
+    if (dec->stage_pos < dec->stage->size) {
+        // Not even one sample fits, the caller would spin forever
+        if (n == 0 && out_cap > 0 && out_cap < channels) return FRAD_STATUS_ERROR;
+        return FRAD_STATUS_OUTPUT_FULL;
+    }
+    dec->stage->size = 0;
+    dec->stage_pos = 0;
+    if (dec->stage_crit) {
+        dec->stage_crit = false;
+        return FRAD_STATUS_STREAM_CHANGED;
+    }
+    return FRAD_STATUS_NEED_INPUT;
+}
+
+frad_status_t decoder_process_into(decoder_t* dec, const uint8_t* stream, size_t stream_len,
+                                   double* out, size_t out_cap, size_t* written) {
+    if (written) *written = 0;
+    if (!dec || !written || (!out && out_cap > 0)) return FRAD_STATUS_ERROR;
+
+    // Earlier PCM goes first, the new stream data waits in the buffer until it is all out
+    frad_status_t status = decoder_drain(dec, out, out_cap, written);
+    if (status != FRAD_STATUS_NEED_INPUT) {
+        if (stream && !vec_u8_extend(dec->buffer, stream, stream_len)) return FRAD_STATUS_ERROR;
+        return status;
+    }
+
+    size_t frames;
+    dec->stage_crit = decoder_inner(dec, stream, stream_len, dec->stage,
+                                    &frames, &dec->stage_channels, &dec->stage_srate);
+    return decoder_drain(dec, out, out_cap, written);
+}
+
+frad_status_t decoder_flush_into(decoder_t* dec, double* out, size_t out_cap, size_t* written) {
+    if (written) *written = 0;
+    if (!dec || !written || (!out && out_cap > 0)) return FRAD_STATUS_ERROR;
+
+    frad_status_t status = decoder_drain(dec, out, out_cap, written);
+    if (dec->stage_flush || status != FRAD_STATUS_NEED_INPUT) {
+        if (status == FRAD_STATUS_NEED_INPUT) dec->stage_flush = false;
+        return status;
+    }
+
+    // Stream data still buffered behind earlier output goes first
+    size_t frames;
+    dec->stage_crit = decoder_inner(dec, NULL, 0, dec->stage, &frames, &dec->stage_channels, &dec->stage_srate);
+    if (!dec->stage_crit) {
+        decoder_flush_inner(dec, dec->stage);
+        asfh_clear(dec->asfh);
+        dec->stage_flush = true;
+    }
+
+    status = decoder_drain(dec, out, out_cap, written);
+    if (status == FRAD_STATUS_NEED_INPUT) dec->stage_flush = false;
+    return status;
+}
+
+uint16_t decoder_get_channels(decoder_t* dec) {
+    return dec ? dec->stage_channels : 0;
+}
+
+uint32_t decoder_get_srate(decoder_t* dec) {
+    return dec ? dec->stage_srate : 0;
+}
+
 void decode_result_free(decode_result_t* result) {
     if (!result) return;
 
     if (result->pcm) vec_f64_free(result->pcm);
-    free(result);
+    frad_free(result);
 }
 
 bool decoder_is_empty(decoder_t* dec) {
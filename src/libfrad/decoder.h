@@ -6,6 +6,7 @@
 #include <stdbool.h>
 #include "backend/backend.h"
 #include "tools/asfh.h"
+#include "common.h"
 
 // Decode result
 typedef struct {
@@ -22,12 +23,36 @@ typedef struct decoder decoder_t;
 // Decoder functions
 decoder_t* decoder_new(bool fix_error);
 void decoder_free(decoder_t* dec);
+// Profiles 1 and 2: inverse transform in single precision
+void decoder_set_float32(decoder_t* dec, bool f32);
+// Decode frames on a pool of worker threads, 0 uses every CPU and 1 (the
+// default) decodes on the calling thread. Overlap-add stays in frame order,
+// so the PCM does not change, but it may be returned by a later call;
+// decoder_flush returns everything.
+void decoder_set_threads(decoder_t* dec, size_t threads);
+// Profiles 0 and 1: spread the channels of each frame over N threads,
+// 0 uses every CPU, 1 (the default) turns it off
+void decoder_set_channel_threads(decoder_t* dec, size_t threads);
 
 // Processing
 decode_result_t* decoder_process(decoder_t* dec, const uint8_t* stream, size_t stream_len);
 decode_result_t* decoder_flush(decoder_t* dec);
 void decode_result_free(decode_result_t* result);
 
+// Same, but the PCM is copied into the caller's buffer, whole samples only,
+// so out_cap must hold at least one value per channel, and nothing is
+// allocated per call. Stream data is always taken in full.
+// FRAD_STATUS_OUTPUT_FULL means PCM is left over, it goes out first on the
+// next call. FRAD_STATUS_STREAM_CHANGED means the PCM written up to here ends a
+// stream and the following PCM has another layout. Call decoder_flush_into
+// until it returns FRAD_STATUS_NEED_INPUT to end the stream.
+frad_status_t decoder_process_into(decoder_t* dec, const uint8_t* stream, size_t stream_len,
+                                   double* out, size_t out_cap, size_t* written);
+frad_status_t decoder_flush_into(decoder_t* dec, double* out, size_t out_cap, size_t* written);
+// Channels and sample rate of the PCM the last *_into call wrote
+uint16_t decoder_get_channels(decoder_t* dec);
+uint32_t decoder_get_srate(decoder_t* dec);
+
 // Status
 bool decoder_is_empty(decoder_t* dec);
 const ASFH* decoder_get_asfh(decoder_t* dec);
@@ -6,7 +6,11 @@
 #include "fourier/profile1.h"
 #include "fourier/profile2.h"
 #include "fourier/profile4.h"
+#include "fourier/backend/dct_core.h"
+#include "fourier/tools/zstream.h"
 #include "tools/ecc/ecc.h"
+#include "backend/workpool.h"
+#include "backend/arena.h"
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
@@ -54,40 +58,89 @@ static bool is_compact_profile(uint8_t profile) {
     return (profile == 1 || profile == 2);
 }
 
+// One cut frame on its way through the profile encoder and ECC
+typedef struct encode_job {
+    workpool_task task;  // First member, run() casts back to the job
+    struct encode_job* next;
+    frame_arena* arena;  // Everything the frame allocates, kept when the job is reused
+    zstream_cache* zs;   // Deflate/inflate state, likewise kept
+
+    // Input and the settings in force when the frame was cut
+    const double* frame;  // Borrowed when encoded inline, else a copy in the arena
+    size_t frame_len;
+    ASFH head;
+    uint16_t bit_depth;
+    uint16_t channels;
+    uint32_t srate;
+    double loss_level;
+    bool f32;
+    workpool_t* channel_pool;
+    bool flush;
+
+    // Output
+    uint32_t fsize;
+    encoded_packet* packet;
+    vec_u8* frad;  // Packet data, ECC applied if enabled
+} encode_job;
+
 // Encoder structure
 struct encoder {
     ASFH* asfh;
-    vec_f64* buffer;  // Changed to store f64 samples directly
+
+    // Pending samples are buf[buf_start, buf_start + buf_len), the olap
+    // values right before buf_start are the overlap fragment
+    double* buf;
+    size_t buf_cap;
+    size_t buf_start;
+    size_t buf_len;
+    size_t olap;
 
     uint16_t bit_depth;
     uint16_t channels;
     uint32_t fsize;
     uint32_t srate;
 
-    vec_f64* overlap_fragment;
-
     double loss_level;
+    double latency_ms;  // Live budget for the samples one frame waits for, 0 for none
+    bool snap_fsize;
+    bool f32;
+    zstream_effort effort;  // Deflate effort of the preset
     bool init;
+
+    // Frame-parallel mode: frames in flight, oldest first
+    size_t threads;
+    workpool_t* pool;
+    workpool_t* channel_pool;  // Channels of one frame, NULL for none
+    encode_job* pending_head;
+    encode_job* pending_tail;
+    size_t pending;
+    encode_job* spare;  // Finished jobs, arenas warm, for the next frames
+
+    // encoder_process_into: bytes not yet handed out are stage[stage_pos..],
+    // stage_flush while encoder_flush_into is still handing out its bytes
+    vec_u8* stage;
+    size_t stage_pos;
+    bool stage_flush;
 };
 
 // Create new encoder
 encoder_t* encoder_new(encoder_params_t* params) {
     if (!params) return NULL;
 
-    encoder_t* enc = calloc(1, sizeof(encoder_t));
+    encoder_t* enc = frad_calloc(1, sizeof(encoder_t));
     if (!enc) return NULL;
 
     enc->asfh = asfh_new();
-    enc->buffer = vec_f64_new(0);  // Changed to f64 buffer
-    enc->overlap_fragment = vec_f64_new(0);
+    enc->stage = vec_u8_new(0);
 
-    if (!enc->asfh || !enc->buffer || !enc->overlap_fragment) {
+    if (!enc->asfh || !enc->stage) {
         encoder_free(enc);
         return NULL;
     }
 
     enc->loss_level = 0.5;
     enc->init = false;
+    enc->threads = 1;
 
     // Set initial profile
     const char* err = encoder_set_profile(enc, params);
@@ -99,196 +152,440 @@ encoder_t* encoder_new(encoder_params_t* params) {
     return enc;
 }
 
+static void encode_job_free(encode_job* job) {
+    if (!job) return;
+    frame_arena_free(job->arena);
+    zstream_cache_free(job->zs);
+    free(job);
+}
+
+// A cleared job, a spare one if there is any so its arena is already grown
+static encode_job* encode_job_take(encoder_t* enc) {
+    encode_job* job = enc->spare;
+    if (job) {
+        enc->spare = job->next;
+        frame_arena* arena = job->arena;
+        zstream_cache* zs = job->zs;
+        frame_arena_reset(arena);
+        memset(job, 0, sizeof(encode_job));
+        job->arena = arena;
+        job->zs = zs;
+        return job;
+    }
+
+    job = calloc(1, sizeof(encode_job));
+    if (!job) return NULL;
+    job->arena = frame_arena_new();
+    job->zs = zstream_cache_new();
+    if (!job->arena || !job->zs) {
+        encode_job_free(job);
+        return NULL;
+    }
+    return job;
+}
+
+// The packet and ECC output live in the arena, they go with its next reset
+static void encode_job_recycle(encoder_t* enc, encode_job* job) {
+    job->next = enc->spare;
+    enc->spare = job;
+}
+
 // Free encoder
 void encoder_free(encoder_t* enc) {
     if (enc) {
+        // Let the workers finish, frames still in flight are dropped
+        workpool_free(enc->pool);
+        workpool_free(enc->channel_pool);
+        while (enc->pending_head) {
+            encode_job* job = enc->pending_head;
+            enc->pending_head = job->next;
+            encode_job_free(job);
+        }
+        while (enc->spare) {
+            encode_job* job = enc->spare;
+            enc->spare = job->next;
+            encode_job_free(job);
+        }
         asfh_free(enc->asfh);
-        vec_f64_free(enc->buffer);  // Changed from vec_u8_free
-        vec_f64_free(enc->overlap_fragment);
-        free(enc);
+        vec_u8_free(enc->stage);
+        frad_free(enc->buf);
+        frad_free(enc);
     }
 }
 
-// Overlap function - matches Rust implementation exactly
-static vec_f64* overlap(encoder_t* enc, vec_f64* frame, bool flush) {
-    if (!enc || !frame) return NULL;
+// Make room for n more samples after the pending ones, keeping the overlap fragment
+static bool queue_reserve(encoder_t* enc, size_t n) {
+    size_t keep = enc->olap + enc->buf_len;
+    if (enc->buf_start + enc->buf_len + n <= enc->buf_cap) return true;
 
-    size_t channels = enc->channels;
+    // Slide the live part to the front first, grow only if that is not enough
+    if (enc->buf_start > enc->olap) {
+        memmove(enc->buf, enc->buf + enc->buf_start - enc->olap, keep * sizeof(double));
+        enc->buf_start = enc->olap;
+    }
+    if (keep + n > enc->buf_cap) {
+        size_t cap = enc->buf_cap * 2 > keep + n ? enc->buf_cap * 2 : keep + n;
+        double* grown = (double*)frad_realloc(enc->buf, cap * sizeof(double));
+        if (!grown) return false;
+        enc->buf = grown;
+        enc->buf_cap = cap;
+    }
+    return true;
+}
+
+static bool queue_append(encoder_t* enc, const double* samples, size_t n) {
+    if (n == 0) return true;
+    if (!queue_reserve(enc, n)) return false;
+    memcpy(enc->buf + enc->buf_start + enc->buf_len, samples, n * sizeof(double));
+    enc->buf_len += n;
+    return true;
+}
 
-    // 1. If overlap fragment is not empty, prepend the fragment to the frame
-    if (enc->overlap_fragment && enc->overlap_fragment->size > 0) {
-        vec_f64_prepend(frame, enc->overlap_fragment);
+// Replace the queue with samples[olap, n) pending and samples[0, olap) as the overlap fragment
+static bool queue_reset(encoder_t* enc, const double* samples, size_t n) {
+    if (n > enc->buf_cap) {
+        double* grown = (double*)frad_realloc(enc->buf, n * sizeof(double));
+        if (!grown) return false;
+        enc->buf = grown;
+        enc->buf_cap = n;
     }
+    memcpy(enc->buf, samples, n * sizeof(double));
+    enc->buf_start = enc->olap;
+    enc->buf_len = n - enc->olap;
+    return true;
+}
 
-    // 2. If overlap is enabled and profile uses overlap
-    vec_f64* next_overlap = vec_f64_new(0);
+// Overlap function - matches Rust implementation exactly
+// The next overlap fragment is the tail of this frame, left in place, so
+// only its length in values is returned
+static size_t overlap(encoder_t* enc, size_t frame_len, bool flush) {
+    size_t channels = enc->channels;
+
+    // If overlap is enabled and profile uses overlap
     bool next_flag = !flush &&
                      is_compact_profile(enc->asfh->profile) &&
                      enc->asfh->overlap_ratio > 1;
+    if (!next_flag || frame_len == 0) return 0;
+
+    size_t overlap_ratio = enc->asfh->overlap_ratio;
+    // Samples * (Overlap ratio - 1) / Overlap ratio
+    // e.g., ([2048], overlap_ratio=16) -> [1920, 128]
+    size_t cutoff = (frame_len / channels) * (overlap_ratio - 1) / overlap_ratio;
+    return frame_len - cutoff * channels;
+}
+
+// The frame size the latency budget allows, at least one sample. A frame goes
+// out once its new samples are in, so their span is the latency it adds.
+static size_t latency_frame_size(encoder_t* enc) {
+    size_t budget = (size_t)(enc->latency_ms * enc->srate / 1000.0);
+    if (is_compact_profile(enc->asfh->profile)) return get_samples_max_le(budget);
+    return budget > 0 ? budget : 1;
+}
+
+// Steps 3 and 4 of encoder_inner, touches nothing but the job
+static void encode_job_run(workpool_task* task) {
+    encode_job* job = (encode_job*)task;
+    const double* frame = job->frame;
+    size_t frame_len = job->frame_len;
+    job->fsize = frame_len / job->channels;
+    frame_arena* previous = frame_arena_enter(job->arena);
+
+    // 3. Encode the frame
+    switch (job->head.profile) {
+        case 0:
+            job->packet = profile0_analogue(frame, frame_len, job->bit_depth,
+                                            job->channels, job->srate, job->head.endian, job->channel_pool);
+            break;
+        case 1:
+            job->packet = profile1_analogue(frame, frame_len, job->bit_depth,
+                                            job->channels, job->srate, job->loss_level, job->head.endian,
+                                            job->f32, job->channel_pool, job->zs);
+            break;
+        case 2:
+            job->packet = profile2_analogue(frame, frame_len, job->bit_depth,
+                                            job->channels, job->srate, job->head.endian, job->f32);
+            break;
+        case 4:
+            job->packet = profile4_analogue(frame, frame_len, job->bit_depth,
+                                            job->channels, job->srate, job->head.endian);
+            break;
+    }
 
-    if (next_flag && frame->size > 0) {
-        // Copy the last olap samples to the next overlap fragment
-        size_t overlap_ratio = enc->asfh->overlap_ratio;
-        // Samples * (Overlap ratio - 1) / Overlap ratio
-        // e.g., ([2048], overlap_ratio=16) -> [1920, 128]
-        size_t cutoff = (frame->size / channels) * (overlap_ratio - 1) / overlap_ratio;
+    job->frame = NULL;
 
-        // Copy the end portion to next_overlap
-        for (size_t i = cutoff * channels; i < frame->size; i++) {
-            vec_f64_push(next_overlap, frame->data[i]);
+    // 4. Create Reed-Solomon error correction code
+    if (job->packet) {
+        job->frad = job->packet->data;
+        if (job->head.ecc) {
+            vec_u8* encoded = ecc_encode(job->frad, job->head.ecc_ratio);
+            if (encoded) {
+                job->frad = encoded;
+            }
         }
     }
 
-    // Replace overlap fragment
-    vec_f64_free(enc->overlap_fragment);
-    enc->overlap_fragment = next_overlap;
+    frame_arena_leave(previous);
+}
 
-    return frame;
+// Hand a cut frame to the pool, or encode it right here when single-threaded
+static void encoder_dispatch(encoder_t* enc, encode_job* job) {
+    job->task.run = encode_job_run;
+    job->next = NULL;
+    if (enc->pending_tail) enc->pending_tail->next = job;
+    else enc->pending_head = job;
+    enc->pending_tail = job;
+    enc->pending++;
+
+    if (enc->pool) {
+        workpool_submit(enc->pool, &job->task);
+    } else {
+        encode_job_run(&job->task);
+        job->task.done = true;
+    }
 }
 
-// Inner encoder loop - matches Rust implementation exactly
-static encode_result_t* encoder_inner(encoder_t* enc, const double* samples, size_t sample_count, bool flush) {
-    if (!enc) return NULL;
+// Write finished frames in cut order, so the stream matches the single-threaded one
+// Waits until at most `keep` frames are in flight, returns false if a frame failed to encode
+static bool encoder_emit(encoder_t* enc, vec_u8* out, size_t keep) {
+    bool ok = true;
+    while (enc->pending_head) {
+        encode_job* job = enc->pending_head;
+        if (enc->pool) {
+            if (enc->pending > keep) workpool_wait(enc->pool, &job->task);
+            else if (!workpool_is_done(enc->pool, &job->task)) break;
+        }
+        enc->pending_head = job->next;
+        if (!enc->pending_head) enc->pending_tail = NULL;
+        enc->pending--;
+
+        if (!job->packet) {
+            ok = false;
+            encode_job_recycle(enc, job);
+            continue;
+        }
 
-    // Extend buffer with new samples
-    if (samples && sample_count > 0) {
-        for (size_t i = 0; i < sample_count; i++) {
-            vec_f64_push(enc->buffer, samples[i]);
+        // 5. Write the frame to the buffer
+        enc->asfh->bit_depth_index = job->packet->bit_depth_index;
+        enc->asfh->channels = job->packet->channels;
+        enc->asfh->fsize = job->fsize;
+        enc->asfh->srate = job->packet->sample_rate;
+
+        ASFH head = job->head;
+        head.bit_depth_index = enc->asfh->bit_depth_index;
+        head.channels = enc->asfh->channels;
+        head.fsize = enc->asfh->fsize;
+        head.srate = enc->asfh->srate;
+
+        asfh_write_into(&head, job->frad, out);
+        if (job->flush) {
+            asfh_force_flush_into(&head, out);
         }
+        encode_job_recycle(enc, job);
     }
+    return ok;
+}
 
-    encode_result_t* result = calloc(1, sizeof(encode_result_t));
-    if (!result) return NULL;
-
-    result->data = vec_u8_new(0);
-    result->samples = 0;
+// Inner encoder loop - matches Rust implementation exactly
+// Appends the encoded stream to out, returns the samples per channel it covers
+static size_t encoder_inner(encoder_t* enc, const double* samples, size_t sample_count, bool flush, vec_u8* out) {
+    const double* ext = samples;
+    size_t ext_len = samples ? sample_count : 0;
+    size_t ext_pos = 0;
+    size_t encoded = 0;
 
     if (!enc->init) {
-        return result;
+        queue_append(enc, ext, ext_len);
+        return 0;
     }
 
+    // Frames in flight before the cutter waits for the oldest one
+    size_t max_pending = enc->pool ? enc->threads * 2 : 0;
+    bool end_of_stream = false;
+
     while (true) {
         // 0. Set read length in samples
-        size_t overlap_len = enc->overlap_fragment->size / enc->channels;
-        size_t rlen = (enc->fsize > overlap_len) ? enc->fsize : overlap_len;
+        size_t overlap_len = enc->olap / enc->channels;
+        size_t fsize = enc->fsize;
+        if (enc->latency_ms > 0) {
+            size_t live = latency_frame_size(enc);
+            if (live < fsize) fsize = live;
+        }
+        size_t rlen = (fsize > overlap_len) ? fsize : overlap_len;
 
         if (is_compact_profile(enc->asfh->profile)) {
             rlen = get_samples_min_ge(rlen);
+        } else if (enc->snap_fsize && enc->asfh->profile == 0) {
+            // Profile 0 takes any length, prefer one the FFT handles directly
+            size_t snapped = dct_nearest_fast_length(rlen);
+            if (snapped <= SEGMAX[0]) rlen = snapped;
         }
         rlen -= overlap_len;
 
         size_t read_samples = rlen * enc->channels;
-
-        if (enc->buffer->size < read_samples && !flush) break;
-
-        // 1. Cut out the frame from the buffer
-        vec_f64* frame = vec_f64_split_front(enc->buffer, (read_samples < enc->buffer->size) ? read_samples : enc->buffer->size);
-        size_t samples_in_frame = frame->size / enc->channels;
+        size_t available = enc->buf_len + (ext_len - ext_pos);
+
+        if (available < read_samples && !flush) break;
+        size_t read = (read_samples < available) ? read_samples : available;
+
+        // 1. Cut out the frame, overlap fragment included: straight from the
+        // caller's array once the queue is drained, else from the queue
+        const double* frame;
+        if (enc->buf_len == 0 && ext_pos >= enc->olap) {
+            frame = ext + ext_pos - enc->olap;
+            ext_pos += read;
+        } else {
+            if (enc->buf_len < read) {
+                size_t take = read - enc->buf_len;
+                if (!queue_append(enc, ext + ext_pos, take)) break;
+                ext_pos += take;
+            }
+            frame = enc->buf + enc->buf_start - enc->olap;
+            enc->buf_start += read;
+            enc->buf_len -= read;
+        }
+        size_t frame_len = enc->olap + read;
+        size_t samples_in_frame = read / enc->channels;
 
         // 2. Overlap the frame with the previous overlap fragment
-        frame = overlap(enc, frame, flush);
-        if (!frame || frame->size == 0) {
+        enc->olap = overlap(enc, frame_len, flush);
+        if (frame_len == 0) {
             // If this frame is empty, break
-            vec_u8* flush_data = asfh_force_flush(enc->asfh);
-            if (flush_data) {
-                for (size_t i = 0; i < flush_data->size; i++) {
-                    vec_u8_push(result->data, flush_data->data[i]);
-                }
-                vec_u8_free(flush_data);
-            }
-            if (frame) vec_f64_free(frame);
+            end_of_stream = true;
             break;
         }
 
-        result->samples += samples_in_frame;
-        uint32_t fsize = frame->size / enc->channels;
-
-        // 3. Encode the frame
-        encoded_packet* packet = NULL;
-
-        switch (enc->asfh->profile) {
-            case 0:
-                packet = profile0_analogue(frame->data, frame->size, enc->bit_depth,
-                                          enc->channels, enc->srate, enc->asfh->endian);
-                break;
-            case 1:
-                packet = profile1_analogue(frame->data, frame->size, enc->bit_depth,
-                                          enc->channels, enc->srate, enc->loss_level, enc->asfh->endian);
-                break;
-            case 2:
-                packet = profile2_analogue(frame->data, frame->size, enc->bit_depth,
-                                          enc->channels, enc->srate, enc->asfh->endian);
-                break;
-            case 4:
-                packet = profile4_analogue(frame->data, frame->size, enc->bit_depth,
-                                          enc->channels, enc->srate, enc->asfh->endian);
+        encoded += samples_in_frame;
+
+        // 3-4. Encode the frame, on a worker if there is a pool
+        encode_job* job = encode_job_take(enc);
+        if (!job) break;
+        job->frame = frame;
+        job->frame_len = frame_len;
+        if (enc->pool) {
+            // The frame outlives this call, the caller's array and the queue may not
+            double* copy = (double*)frame_arena_alloc(job->arena, frame_len * sizeof(double));
+            if (!copy) {
+                encode_job_recycle(enc, job);
                 break;
+            }
+            memcpy(copy, frame, frame_len * sizeof(double));
+            job->frame = copy;
         }
+        job->head = *enc->asfh;
+        job->bit_depth = enc->bit_depth;
+        job->channels = enc->channels;
+        job->srate = enc->srate;
+        job->loss_level = enc->loss_level;
+        job->f32 = enc->f32;
+        zstream_set_effort(job->zs, enc->effort);
+        job->channel_pool = enc->channel_pool;
+        job->flush = flush;
+        encoder_dispatch(enc, job);
+
+        // 5. Write every frame that is ready
+        if (!encoder_emit(enc, out, max_pending)) break;
+    }
 
-        vec_f64_free(frame);
-
-        if (!packet) {
-            break;
-        }
+    // Keep what is left of the caller's array, with the overlap fragment
+    // if that still lies in it
+    if (enc->buf_len == 0 && ext_pos >= enc->olap && ext_len > 0) {
+        queue_reset(enc, ext + ext_pos - enc->olap, ext_len - ext_pos + enc->olap);
+    } else {
+        queue_append(enc, ext + ext_pos, ext_len - ext_pos);
+    }
 
-        // 4. Create Reed-Solomon error correction code
-        vec_u8* frad = packet->data;
-        if (enc->asfh->ecc) {
-            vec_u8* encoded = ecc_encode(frad, enc->asfh->ecc_ratio);
-            if (encoded) {
-                frad = encoded;
-            }
-        }
+    if (flush || end_of_stream) {
+        encoder_emit(enc, out, 0);
+    }
+    if (end_of_stream) {
+        asfh_force_flush_into(enc->asfh, out);
+    }
 
-        // 5. Write the frame to the buffer
-        enc->asfh->bit_depth_index = packet->bit_depth_index;
-        enc->asfh->channels = packet->channels;
-        enc->asfh->fsize = fsize;
-        enc->asfh->srate = packet->sample_rate;
-
-        vec_u8* frame_data = asfh_write(enc->asfh, frad);
-        if (frame_data) {
-            for (size_t i = 0; i < frame_data->size; i++) {
-                vec_u8_push(result->data, frame_data->data[i]);
-            }
-            vec_u8_free(frame_data);
-        }
+    return encoded;
+}
 
-        if (flush) {
-            vec_u8* flush_data = asfh_force_flush(enc->asfh);
-            if (flush_data) {
-                for (size_t i = 0; i < flush_data->size; i++) {
-                    vec_u8_push(result->data, flush_data->data[i]);
-                }
-                vec_u8_free(flush_data);
-            }
-        }
+static encode_result_t* encoder_result(encoder_t* enc, const double* samples, size_t sample_count, bool flush) {
+    if (!enc) return NULL;
 
-        // Clean up
-        if (enc->asfh->ecc && frad != packet->data) {
-            vec_u8_free(frad);
-        }
-        free(packet);
+    encode_result_t* result = frad_calloc(1, sizeof(encode_result_t));
+    if (!result) return NULL;
+    result->data = vec_u8_new(0);
+    if (!result->data) {
+        frad_free(result);
+        return NULL;
     }
 
+    result->samples = encoder_inner(enc, samples, sample_count, flush, result->data);
     return result;
 }
 
 // Process input stream (now takes f64 samples)
 encode_result_t* encoder_process(encoder_t* enc, const double* samples, size_t sample_count) {
-    return encoder_inner(enc, samples, sample_count, false);
+    return encoder_result(enc, samples, sample_count, false);
 }
 
 // Flush encoder
 encode_result_t* encoder_flush(encoder_t* enc) {
-    return encoder_inner(enc, NULL, 0, true);
+    return encoder_result(enc, NULL, 0, true);
+}
+
+// Hand out staged bytes after the *written already in out, the stage is
+// emptied once all of them are taken
+static frad_status_t encoder_drain(encoder_t* enc, uint8_t* out, size_t out_cap, size_t* written) {
+    size_t left = enc->stage->size - enc->stage_pos;
+    size_t room = out_cap - *written;
+    size_t n = left < room ? left : room;
+    if (n > 0) memcpy(out + *written, enc->stage->data + enc->stage_pos, n);
+    *written += n;
+
+    enc->stage_pos += n;
+    if (enc->stage_pos < enc->stage->size) return FRAD_STATUS_OUTPUT_FULL;
+    enc->stage->size = 0;
+    enc->stage_pos = 0;
+    return FRAD_STATUS_NEED_INPUT;
+}
+
+// The stage keeps its capacity, so once it has grown to a call's worth of
+// output these allocate nothing themselves
+frad_status_t encoder_process_into(encoder_t* enc, const double* samples, size_t sample_count,
+                                   uint8_t* out, size_t out_cap, size_t* written) {
+    if (written) *written = 0;
+    if (!enc || !written || (!out && out_cap > 0)) return FRAD_STATUS_ERROR;
+
+    // Earlier output goes first, the new samples wait in the queue until it is all out
+    if (encoder_drain(enc, out, out_cap, written) == FRAD_STATUS_OUTPUT_FULL) {
+        if (samples && !queue_append(enc, samples, sample_count)) return FRAD_STATUS_ERROR;
+        return FRAD_STATUS_OUTPUT_FULL;
+    }
+    encoder_inner(enc, samples, sample_count, false, enc->stage);
+    return encoder_drain(enc, out, out_cap, written);
+}
+
+frad_status_t encoder_flush_into(encoder_t* enc, uint8_t* out, size_t out_cap, size_t* written) {
+    if (written) *written = 0;
+    if (!enc || !written || (!out && out_cap > 0)) return FRAD_STATUS_ERROR;
+
+    frad_status_t status = encoder_drain(enc, out, out_cap, written);
+    if (enc->stage_flush || status == FRAD_STATUS_OUTPUT_FULL) {
+        if (status == FRAD_STATUS_NEED_INPUT) enc->stage_flush = false;
+        return status;
+    }
+
+    // Whole frames still queued behind earlier output are cut as usual, only the tail is flushed
+    encoder_inner(enc, NULL, 0, false, enc->stage);
+    encoder_inner(enc, NULL, 0, true, enc->stage);
+    enc->stage_flush = true;
+
+    status = encoder_drain(enc, out, out_cap, written);
+    if (status == FRAD_STATUS_NEED_INPUT) enc->stage_flush = false;
+    return status;
 }
 
 // Free encode result
 void encode_result_free(encode_result_t* result) {
     if (result) {
         vec_u8_free(result->data);
-        free(result);
+        frad_free(result);
     }
 }
 
@@ -416,4 +713,54 @@ void encoder_set_overlap_ratio(encoder_t* enc, uint16_t overlap_ratio) {
         overlap_ratio = fmax(2, fmin(256, overlap_ratio));
     }
     enc->asfh->overlap_ratio = overlap_ratio;
+}
+
+void encoder_set_snap_frame_size(encoder_t* enc, bool snap) {
+    if (enc) enc->snap_fsize = snap;
+}
+
+void encoder_set_latency(encoder_t* enc, double max_ms) {
+    if (enc) enc->latency_ms = max_ms > 0 ? max_ms : 0;
+}
+
+void encoder_set_float32(encoder_t* enc, bool f32) {
+    if (enc) enc->f32 = f32;
+}
+
+void encoder_set_preset(encoder_t* enc, encoder_preset_t preset) {
+    if (!enc) return;
+    switch (preset) {
+        case ENCODER_PRESET_BALANCED: enc->effort = ZSTREAM_BALANCED; break;
+        case ENCODER_PRESET_FAST: enc->effort = ZSTREAM_FAST; break;
+        default: enc->effort = ZSTREAM_BEST; break;
+    }
+}
+
+void encoder_set_threads(encoder_t* enc, size_t threads) {
+    if (!enc) return;
+
+    // Frames in flight finish on the old pool and go out with the next call
+    workpool_free(enc->pool);
+    enc->pool = NULL;
+
+    enc->threads = threads == 0 ? workpool_cpu_count() : threads;
+    if (enc->threads > 1) {
+        enc->pool = workpool_new(enc->threads);
+        if (!enc->pool) enc->threads = 1;
+        else enc->threads = workpool_threads(enc->pool);
+    }
+}
+
+void encoder_set_channel_threads(encoder_t* enc, size_t threads) {
+    if (!enc) return;
+
+    // Frames in flight may still use the old pool
+    if (enc->pool) {
+        for (encode_job* job = enc->pending_head; job; job = job->next) workpool_wait(enc->pool, &job->task);
+    }
+    workpool_free(enc->channel_pool);
+    enc->channel_pool = NULL;
+
+    if (threads == 0) threads = workpool_cpu_count();
+    if (threads > 1) enc->channel_pool = workpool_new(threads);
 }
\ No newline at end of file
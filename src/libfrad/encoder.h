@@ -7,6 +7,7 @@
 #include "backend/backend.h"
 #include "../tools/pcmproc.h"
 #include "tools/asfh.h"
+#include "common.h"
 
 // Encoder parameters
 typedef struct {
@@ -23,6 +24,13 @@ typedef struct {
     size_t samples;
 } encode_result_t;
 
+// Encoder speed presets, how hard profile 1 deflates its frames
+typedef enum {
+    ENCODER_PRESET_MAX,       // zlib's best level, the default
+    ENCODER_PRESET_BALANCED,  // Frames within 1% of max, deflated in half the time
+    ENCODER_PRESET_FAST       // Huffman coding only, a quarter of the time for up to 15% more bytes
+} encoder_preset_t;
+
 // Encoder (opaque type)
 typedef struct encoder encoder_t;
 
@@ -35,6 +43,14 @@ encode_result_t* encoder_process(encoder_t* enc, const double* samples, size_t s
 encode_result_t* encoder_flush(encoder_t* enc);
 void encode_result_free(encode_result_t* result);
 
+// Same, but the stream is copied into the caller's buffer and nothing is
+// allocated per call. Samples are always taken in full. FRAD_STATUS_OUTPUT_FULL
+// means bytes are left over, they go out first on the next call. Call
+// encoder_flush_into until it returns FRAD_STATUS_NEED_INPUT to end the stream.
+frad_status_t encoder_process_into(encoder_t* enc, const double* samples, size_t sample_count,
+                                   uint8_t* out, size_t out_cap, size_t* written);
+frad_status_t encoder_flush_into(encoder_t* enc, uint8_t* out, size_t out_cap, size_t* written);
+
 // Setters and getters
 const char* encoder_set_profile(encoder_t* enc, encoder_params_t* params);
 uint8_t encoder_get_profile(encoder_t* enc);
@@ -48,5 +64,28 @@ void encoder_set_ecc(encoder_t* enc, bool ecc, uint8_t data_size, uint8_t check_
 void encoder_set_little_endian(encoder_t* enc, bool little_endian);
 void encoder_set_loss_level(encoder_t* enc, double loss_level);
 void encoder_set_overlap_ratio(encoder_t* enc, uint16_t overlap_ratio);
+// Profile 0: round the frame size to the nearest FFT-friendly length,
+// the length actually used is written to each frame header
+void encoder_set_snap_frame_size(encoder_t* enc, bool snap);
+// Live streaming: shrink frames so that none waits for more than max_ms of
+// input, compact profiles take the largest frame length that fits (at least
+// 128 samples). The frame size stays an upper bound, 0 turns it off.
+void encoder_set_latency(encoder_t* enc, double max_ms);
+// Profiles 1 and 2: transform and quantise in single precision, the output
+// stays within one quantisation step of the double path
+void encoder_set_float32(encoder_t* enc, bool f32);
+// Profile 1: deflate effort, see encoder_preset_t. Below max, frames that
+// do not compress are stored as they are, and libdeflate is used in place of
+// zlib when built with FRAD_LIBDEFLATE. Any preset decodes the same way.
+void encoder_set_preset(encoder_t* enc, encoder_preset_t preset);
+// Encode frames on a pool of worker threads, 0 uses every CPU and 1 (the
+// default) encodes on the calling thread. The byte stream does not change,
+// but finished frames may be returned by a later call than the one that
+// supplied their samples; encoder_flush returns everything.
+void encoder_set_threads(encoder_t* enc, size_t threads);
+// Profiles 0 and 1: spread the channels of each frame over N threads, for
+// many-channel streams where waiting for whole frames costs too much
+// latency. 0 uses every CPU, 1 (the default) turns it off.
+void encoder_set_channel_threads(encoder_t* enc, size_t threads);
 
 #endif
\ No newline at end of file
@@ -1,123 +1,232 @@
 #include "dct_core.h"
 #include "pocketfft.h"
-#include <math.h>
+#include "fft_cache.h"
+#include "../compact.h"
+#include "../../backend/arena.h"
 #include <stdlib.h>
-#include <string.h>
+#include <pthread.h>
 
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
+#define SQRT2   1.41421356237309504880
+#define SQRT1_2 0.70710678118654752440
 
-static vec_f64* dct2_core(const vec_f64* x, double fct) {
-    size_t n = x->size;
-    size_t n2 = 2 * n;
+static pthread_once_t prewarm_once = PTHREAD_ONCE_INIT;
+static pthread_once_t prewarm_once_f32 = PTHREAD_ONCE_INIT;
 
-    // Allocate complex array for FFT (interleaved real/imag)
-    double* beta = (double*)calloc(n2 * 2, sizeof(double));
-    if (!beta) return NULL;
+// Build the plans for every compact frame length at once
+static void dct_prewarm(void) {
+    fft_cache_prewarm(FFT_PLAN_DCT, COMPACT_SAMPLES, COMPACT_SAMPLES_SIZE);
+}
 
-    // Create beta: x concatenated with reversed x
-    for (size_t i = 0; i < n; i++) {
-        beta[i * 2] = x->data[i];      // real part
-        beta[i * 2 + 1] = 0.0;          // imag part
-        beta[(n + i) * 2] = x->data[n - 1 - i];  // real part
-        beta[(n + i) * 2 + 1] = 0.0;             // imag part
-    }
+static void dct_prewarm_f32(void) {
+    fft_cache_prewarm(FFT_PLAN_DCT_F32, COMPACT_SAMPLES, COMPACT_SAMPLES_SIZE);
+}
 
-    // Create FFT plan and perform forward FFT
-    cfft_plan plan = make_cfft_plan(n2);
-    if (!plan) {
-        free(beta);
-        return NULL;
-    }
+static bool is_compact_length(size_t n) {
+    return n <= COMPACT_MAX_SMPL && get_samples_min_ge(n) == n;
+}
 
-    cfft_forward(plan, beta, fct);
+// Get the transform plan and rotation tables for an N-point DCT
+static fft_cache_entry* dct_plan(size_t n) {
+    if (is_compact_length(n)) pthread_once(&prewarm_once, dct_prewarm);
+    return fft_cache_acquire(FFT_PLAN_DCT, n);
+}
 
-    // Create output vector
-    vec_f64* output = vec_f64_new(n);
-    if (!output) {
-        destroy_cfft_plan(plan);
-        free(beta);
-        return NULL;
-    }
+static fft_cache_entry* dct_plan_f32(size_t n) {
+    if (is_compact_length(n)) pthread_once(&prewarm_once_f32, dct_prewarm_f32);
+    return fft_cache_acquire(FFT_PLAN_DCT_F32, n);
+}
 
-    // Extract DCT coefficients with phase correction
-    for (size_t k = 0; k < n; k++) {
-        double phase = -M_PI * k / (2.0 * n);
-        double cos_phase = cos(phase);
-        double sin_phase = sin(phase);
-        double real = beta[k * 2] * cos_phase - beta[k * 2 + 1] * sin_phase;
-        vec_f64_push(output, real);
-    }
+// Channels gathered per pass, keeps the working rows of a pass in cache
+#define DCT_BATCH_BLOCK 8
 
-    destroy_cfft_plan(plan);
-    free(beta);
+// Most runs a *_batch_parallel call is split into, 256 channels fit in 32 blocks
+#define DCT_PARALLEL_MAX_RUNS 32
 
-    return output;
+// Longest frame run in vertical groups, beyond this a group and its FFT
+// scratch outgrow L1 and one row at a time is faster
+#define DCT_VERTICAL_MAX_SAMPLES 512
+
+// Fewest lanes a vertical group needs to beat one row at a time, narrower
+// groups lose more in their gather and split than the shared FFT passes save
+#define DCT_VERTICAL_MIN_WIDTH 8
+
+// Kernels whose vectorisation rests on restrict parameters stay out of line,
+// GCC loses the restrict guarantee once they are inlined
+#ifdef __GNUC__
+#define DCT_NOINLINE __attribute__((noinline))
+#else
+#define DCT_NOINLINE
+#endif
+
+// Position of sample i in Makhoul order: even samples ascending, odd samples descending
+static inline size_t makhoul_index(size_t i, size_t n) {
+    return (i & 1) ? n - 1 - (i >> 1) : i >> 1;
 }
 
-// DCT-III using FFT (matches Rust dct3_core)
-static vec_f64* dct3_core(const vec_f64* x, double fct) {
-    size_t n = x->size;
-    size_t n2 = 2 * n;
+// Transform kernels in double and in single precision
+#define DCT_T double
+#define DCT_FN(name) name
+#include "dct_core_impl.h"
+#undef DCT_T
+#undef DCT_FN
+
+#define DCT_T float
+#define DCT_FN(name) name##_f32
+#include "dct_core_impl.h"
+#undef DCT_T
+#undef DCT_FN
+
+bool dct_batch(const double* input, double* output, size_t frames, size_t channels) {
+    if (!input || !output || frames == 0 || channels == 0) return false;
+    return dct2_core(input, output, frames, channels, channels, 1.0 / (2.0 * frames));
+}
 
-    // Allocate complex array for FFT (interleaved real/imag)
-    double* beta = (double*)calloc(n2 * 2, sizeof(double));
-    if (!beta) return NULL;
+bool idct_batch(const double* input, double* output, size_t frames, size_t channels) {
+    if (!input || !output || frames == 0 || channels == 0) return false;
+    return dct3_core(input, output, frames, channels, channels, 1.0);
+}
 
-    // Create beta with phase-shifted input
-    for (size_t i = 0; i < n; i++) {
-        double phase = -M_PI * i / (2.0 * n);
-        beta[i * 2] = x->data[i] * cos(phase);
-        beta[i * 2 + 1] = x->data[i] * sin(phase);
-    }
+bool dct_batch_f32(const float* input, float* output, size_t frames, size_t channels) {
+    if (!input || !output || frames == 0 || channels == 0) return false;
+    return dct2_core_f32(input, output, frames, channels, channels, 1.0f / (2.0f * frames));
+}
 
-    // Middle element is zero
-    beta[n * 2] = 0.0;
-    beta[n * 2 + 1] = 0.0;
+bool idct_batch_f32(const float* input, float* output, size_t frames, size_t channels) {
+    if (!input || !output || frames == 0 || channels == 0) return false;
+    return dct3_core_f32(input, output, frames, channels, channels, 1.0f);
+}
 
-    // Mirror with conjugation
-    for (size_t i = 1; i < n; i++) {
-        double phase = -M_PI * i / (2.0 * n);
-        beta[(n + i) * 2] = x->data[n - i] * cos(phase);
-        beta[(n + i) * 2 + 1] = -x->data[n - i] * sin(phase);  // Conjugate
+// One *_batch_parallel call, each run is a range of whole channel blocks
+typedef struct {
+    const void* input;
+    void* output;
+    size_t frames;
+    size_t channels;
+    bool inverse;
+    bool f32;
+    size_t grain;
+    bool failed[DCT_PARALLEL_MAX_RUNS];
+} dct_parallel_job;
+
+static void dct_parallel_run(void* ctx, size_t begin, size_t end) {
+    dct_parallel_job* job = (dct_parallel_job*)ctx;
+    size_t c0 = begin * DCT_BATCH_BLOCK;
+    size_t c1 = end * DCT_BATCH_BLOCK < job->channels ? end * DCT_BATCH_BLOCK : job->channels;
+    size_t n = job->frames, stride = job->channels;
+
+    bool ok;
+    if (job->f32) {
+        const float* in = (const float*)job->input + c0;
+        float* out = (float*)job->output + c0;
+        ok = job->inverse ? dct3_core_f32(in, out, n, c1 - c0, stride, 1.0f)
+                          : dct2_core_f32(in, out, n, c1 - c0, stride, 1.0f / (2.0f * n));
+    } else {
+        const double* in = (const double*)job->input + c0;
+        double* out = (double*)job->output + c0;
+        ok = job->inverse ? dct3_core(in, out, n, c1 - c0, stride, 1.0)
+                          : dct2_core(in, out, n, c1 - c0, stride, 1.0 / (2.0 * n));
     }
+    if (!ok) job->failed[begin / job->grain] = true;
+}
 
-    // Create FFT plan and perform forward FFT
-    cfft_plan plan = make_cfft_plan(n2);
-    if (!plan) {
-        free(beta);
-        return NULL;
+// Runs align with the blocks of the serial path, so the output is bit-identical
+static bool dct_parallel(const void* input, void* output, size_t frames, size_t channels, bool inverse, bool f32,
+                         workpool_t* pool) {
+    size_t blocks = (channels + DCT_BATCH_BLOCK - 1) / DCT_BATCH_BLOCK;
+    size_t grain = (blocks + DCT_PARALLEL_MAX_RUNS - 1) / DCT_PARALLEL_MAX_RUNS;
+    dct_parallel_job job = { input, output, frames, channels, inverse, f32, grain, { false } };
+    workpool_parallel_for(pool, blocks, grain, dct_parallel_run, &job);
+    for (size_t i = 0; i < DCT_PARALLEL_MAX_RUNS; i++) {
+        if (job.failed[i]) return false;
     }
+    return true;
+}
 
-    cfft_forward(plan, beta, fct);
+bool dct_batch_parallel(const double* input, double* output, size_t frames, size_t channels, workpool_t* pool) {
+    if (!pool || channels <= DCT_BATCH_BLOCK) return dct_batch(input, output, frames, channels);
+    if (!input || !output || frames == 0) return false;
+    return dct_parallel(input, output, frames, channels, false, false, pool);
+}
 
-    // Create output vector (take real parts)
-    vec_f64* output = vec_f64_new(n);
-    if (!output) {
-        destroy_cfft_plan(plan);
-        free(beta);
-        return NULL;
-    }
+bool idct_batch_parallel(const double* input, double* output, size_t frames, size_t channels, workpool_t* pool) {
+    if (!pool || channels <= DCT_BATCH_BLOCK) return idct_batch(input, output, frames, channels);
+    if (!input || !output || frames == 0) return false;
+    return dct_parallel(input, output, frames, channels, true, false, pool);
+}
 
-    for (size_t k = 0; k < n; k++) {
-        vec_f64_push(output, beta[k * 2]);  // real part
+bool dct_batch_f32_parallel(const float* input, float* output, size_t frames, size_t channels, workpool_t* pool) {
+    if (!pool || channels <= DCT_BATCH_BLOCK) return dct_batch_f32(input, output, frames, channels);
+    if (!input || !output || frames == 0) return false;
+    return dct_parallel(input, output, frames, channels, false, true, pool);
+}
+
+bool idct_batch_f32_parallel(const float* input, float* output, size_t frames, size_t channels, workpool_t* pool) {
+    if (!pool || channels <= DCT_BATCH_BLOCK) return idct_batch_f32(input, output, frames, channels);
+    if (!input || !output || frames == 0) return false;
+    return dct_parallel(input, output, frames, channels, true, true, pool);
+}
+
+bool dct_length_is_fast(size_t n) {
+    if (n == 0) return false;
+    static const size_t radices[] = {2, 3, 5, 7};
+    for (size_t i = 0; i < 4; i++) {
+        while (n % radices[i] == 0) n /= radices[i];
     }
+    return n == 1;
+}
 
-    destroy_cfft_plan(plan);
-    free(beta);
+size_t dct_nearest_fast_length(size_t n) {
+    if (n <= 8) return n;
 
-    return output;
+    // Walk every 2^a 3^b 5^c 7^d up to the first power of two >= n and keep
+    // the closest one on either side
+    size_t below = 1, above = 1;
+    while (above < n) {
+        if (above > SIZE_MAX / 2) return n;
+        above *= 2;
+    }
+    size_t limit = above;
+    for (size_t p7 = 1; p7 <= limit; p7 *= 7) {
+        for (size_t p5 = p7; p5 <= limit; p5 *= 5) {
+            for (size_t p3 = p5; p3 <= limit; p3 *= 3) {
+                for (size_t c = p3; c <= limit; c *= 2) {
+                    if (c <= n && c > below) below = c;
+                    if (c >= n && c < above) above = c;
+                    if (c > limit / 2) break;
+                }
+                if (p3 > limit / 3) break;
+            }
+            if (p5 > limit / 5) break;
+        }
+        if (p7 > limit / 7) break;
+    }
+    return (n - below < above - n) ? below : above;
 }
 
 // Public DCT function (DCT-II)
 vec_f64* dct(const vec_f64* input) {
     if (!input || input->size == 0) return NULL;
-    return dct2_core(input, 1.0 / (2.0 * input->size));
+
+    vec_f64* output = vec_f64_new(input->size);
+    if (!output) return NULL;
+    if (!dct_batch(input->data, output->data, input->size, 1)) {
+        vec_f64_free(output);
+        return NULL;
+    }
+    output->size = input->size;
+    return output;
 }
 
 // Public IDCT function (DCT-III)
 vec_f64* idct(const vec_f64* input) {
     if (!input || input->size == 0) return NULL;
-    return dct3_core(input, 1.0);
-}
\ No newline at end of file
+
+    vec_f64* output = vec_f64_new(input->size);
+    if (!output) return NULL;
+    if (!idct_batch(input->data, output->data, input->size, 1)) {
+        vec_f64_free(output);
+        return NULL;
+    }
+    output->size = input->size;
+    return output;
+}
@@ -5,9 +5,35 @@
 #define DCT_CORE_H
 
 #include <stddef.h>
+#include <stdbool.h>
 #include "../../backend/backend.h"
+#include "../../backend/workpool.h"
 
 vec_f64* dct(const vec_f64* input);
 vec_f64* idct(const vec_f64* input);
 
+// Transform every channel of an interleaved buffer of frames * channels values
+// Output is interleaved the same way and must not alias the input
+bool dct_batch(const double* input, double* output, size_t frames, size_t channels);
+bool idct_batch(const double* input, double* output, size_t frames, size_t channels);
+
+// Single precision dct_batch / idct_batch, for lossy profiles whose output
+// is coarser than float rounding
+bool dct_batch_f32(const float* input, float* output, size_t frames, size_t channels);
+bool idct_batch_f32(const float* input, float* output, size_t frames, size_t channels);
+
+// The batches above with channel blocks fanned out across a pool, same output
+// A NULL pool, or too few channels to split, runs on the calling thread
+bool dct_batch_parallel(const double* input, double* output, size_t frames, size_t channels, workpool_t* pool);
+bool idct_batch_parallel(const double* input, double* output, size_t frames, size_t channels, workpool_t* pool);
+bool dct_batch_f32_parallel(const float* input, float* output, size_t frames, size_t channels, workpool_t* pool);
+bool idct_batch_f32_parallel(const float* input, float* output, size_t frames, size_t channels, workpool_t* pool);
+
+// Frame length planning
+// 7-smooth lengths run on the mixed-radix FFT alone, any other length goes
+// through Rader or Bluestein and costs several times more per sample
+bool dct_length_is_fast(size_t n);
+// Closest fast length to n, ties go to the longer one
+size_t dct_nearest_fast_length(size_t n);
+
 #endif // DCT_CORE_H
@@ -0,0 +1,327 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// Copyright (C) 2025 HaמuL
+
+// DCT kernels, included by dct_core.c once per sample type with
+//   DCT_T         sample type
+//   DCT_FN(name)  the instance of name for DCT_T: kernels defined here, the
+//                 pocketfft calls, the fft_cache_entry fields and dct_plan
+// No include guard on purpose
+
+// Post-rotation of one rfft row into DCT-II bins
+// Halfcomplex bin k = [r_k, i_k] yields both X[k] and X[N-k]
+static void DCT_FN(dct2_rotate)(const fft_cache_entry* plan, const DCT_T* v, DCT_T* out, size_t n) {
+    const DCT_T* tc = plan->DCT_FN(tw_cos);
+    const DCT_T* ts = plan->DCT_FN(tw_sin);
+
+    out[0] = v[0];
+    for (size_t k = 1; k < (n + 1) / 2; k++) {
+        DCT_T re = v[2 * k - 1], im = v[2 * k];
+        out[k] = tc[k] * re + ts[k] * im;
+        out[n - k] = ts[k] * re - tc[k] * im;
+    }
+    if (n % 2 == 0 && n > 1) out[n / 2] = v[n - 1] * (DCT_T)SQRT1_2;
+}
+
+// Pre-rotation of one DCT-III row into halfcomplex: V[k] = e^(i*pi*k/2N) * (X[k] - i*X[N-k])
+static void DCT_FN(dct3_rotate)(const fft_cache_entry* plan, const DCT_T* x, DCT_T* v, size_t n) {
+    const DCT_T* tc = plan->DCT_FN(tw_cos);
+    const DCT_T* ts = plan->DCT_FN(tw_sin);
+
+    v[0] = x[0];
+    for (size_t k = 1; k < (n + 1) / 2; k++) {
+        DCT_T a = x[k], b = x[n - k];
+        v[2 * k - 1] = tc[k] * a + ts[k] * b;
+        v[2 * k] = ts[k] * a - tc[k] * b;
+    }
+    if (n % 2 == 0 && n > 1) v[n - 1] = x[n / 2] * (DCT_T)SQRT2;
+}
+
+// Post-rotation of an N/2-point complex FFT into DCT-II bins, even N > 2 only
+// Z = FFT(v[2m] + i*v[2m+1]) splits into the real spectrum
+// V[k] = (Z[k] + conj(Z[M-k])) / 2 - i * W^k * (Z[k] - conj(Z[M-k])) / 2, W = e^(-2*pi*i/N)
+// This gives bins k and N-k from Z[k] = a and Z[M-k] = b, tables as in fft_cache_entry
+static inline void DCT_FN(dct2_split_bin)(const DCT_T* tc, const DCT_T* ts, const DCT_T* wc, const DCT_T* ws, size_t k,
+                                          DCT_T ar, DCT_T ai, DCT_T br, DCT_T bi, DCT_T* lo, DCT_T* hi) {
+    bi = -bi;
+    DCT_T er = (DCT_T)0.5 * (ar + br), ei = (DCT_T)0.5 * (ai + bi);
+    DCT_T or_ = (DCT_T)0.5 * (ai - bi), oi = (DCT_T)-0.5 * (ar - br);
+    DCT_T vr = er + wc[k] * or_ + ws[k] * oi;
+    DCT_T vi = ei + wc[k] * oi - ws[k] * or_;
+    *lo = tc[k] * vr + ts[k] * vi;
+    *hi = ts[k] * vr - tc[k] * vi;
+}
+
+// Split M complex values, Z[k] at z[2 * k * stride], into fct-scaled real and imaginary arrays
+static void DCT_FN(dct_deinterleave)(const DCT_T* restrict z, DCT_T* restrict re, DCT_T* restrict im, size_t m,
+                                     size_t stride, DCT_T fct) {
+    for (size_t k = 0; k < m; k++) {
+        re[k] = fct * z[2 * k * stride];
+        im[k] = fct * z[2 * k * stride + 1];
+    }
+}
+
+// Bins of a plain row from separate real and imaginary arrays of Z, lo and hi
+// are the two halves of the bins. Keeping the mirrored Z[M-k] loads
+// single-element lets this loop vectorise where the interleaved one cannot
+DCT_NOINLINE static void DCT_FN(dct2_split_halves)(const DCT_T* restrict tc, const DCT_T* restrict ts, const DCT_T* restrict wc,
+                                      const DCT_T* restrict ws, const DCT_T* restrict zr, const DCT_T* restrict zi,
+                                      DCT_T* restrict lo, DCT_T* restrict hi, size_t m) {
+    lo[0] = zr[0] + zi[0];
+    hi[0] = (zr[0] - zi[0]) * (DCT_T)SQRT1_2;
+    for (size_t k = 1; k < m; k++) {
+        DCT_FN(dct2_split_bin)(tc, ts, wc, ws, k, zr[k], zi[k], zr[m - k], zi[m - k], lo + k, hi + m - k);
+    }
+}
+
+// dct2_split_bin over one FFT row through n values of scratch, with the FFT scale fct folded in
+// Z[k] sits at z[2 * k * stride], stride is the group width for vertical rows
+static void DCT_FN(dct2_split_plain)(const fft_cache_entry* plan, const DCT_T* z, DCT_T* out, DCT_T* scratch, size_t n,
+                                     size_t stride, DCT_T fct) {
+    size_t m = n / 2;
+    DCT_FN(dct_deinterleave)(z, scratch, scratch + m, m, stride, fct);
+    DCT_FN(dct2_split_halves)(plan->DCT_FN(tw_cos), plan->DCT_FN(tw_sin), plan->DCT_FN(split_cos),
+                              plan->DCT_FN(split_sin), scratch, scratch + m, out, out + m, m);
+}
+
+// Pre-rotation of DCT-III bins into one N/2-point complex FFT row, even N > 2 only
+// Z[k] = (V[k] + conj(V[M-k])) + i * W^-k * (V[k] - conj(V[M-k])), laid out as dct2_split_plain reads it
+static void DCT_FN(dct3_rotate_split)(const fft_cache_entry* plan, const DCT_T* x, DCT_T* z, size_t n, size_t stride) {
+    const DCT_T* tc = plan->DCT_FN(tw_cos);
+    const DCT_T* ts = plan->DCT_FN(tw_sin);
+    const DCT_T* wc = plan->DCT_FN(split_cos);
+    const DCT_T* ws = plan->DCT_FN(split_sin);
+    size_t m = n / 2;
+
+    DCT_T v0 = x[0], vm = x[m] * (DCT_T)SQRT2;
+    z[0] = v0 + vm;
+    z[1] = v0 - vm;
+    for (size_t k = 1; k < m; k++) {
+        size_t j = m - k;
+        DCT_T ar = tc[k] * x[k] + ts[k] * x[n - k];
+        DCT_T ai = ts[k] * x[k] - tc[k] * x[n - k];
+        DCT_T br = tc[j] * x[j] + ts[j] * x[n - j];
+        DCT_T bi = -(ts[j] * x[j] - tc[j] * x[n - j]);
+        DCT_T dr = ar - br, di = ai - bi;
+        DCT_T tr = wc[k] * dr - ws[k] * di, ti = wc[k] * di + ws[k] * dr;
+        z[2 * k * stride] = ar + br - ti;
+        z[2 * k * stride + 1] = ai + bi + tr;
+    }
+}
+
+// Vertical groups: the first channels of a block run `width` at a time through
+// cfft_*_multi, each lane carrying one transform. A group occupies width rows
+// interleaved element by element, position pos of lane l sits at
+// group[(pos / 2) * 2 * width + 2 * l + pos % 2]
+
+// Transforms per vertical group for N-point rows, 0 to run every row alone
+static size_t DCT_FN(dct_vertical_width)(const fft_cache_entry* plan, size_t n) {
+    if (!plan->DCT_FN(cplan) || n > DCT_VERTICAL_MAX_SAMPLES) return 0;
+    size_t width = DCT_FN(cfft_multi_width)(plan->DCT_FN(cplan));
+    return width >= DCT_VERTICAL_MIN_WIDTH ? width : 0;
+}
+
+// Gather the first `lanes` channels into Makhoul-ordered groups
+static void DCT_FN(dct_vertical_gather)(const DCT_T* input, DCT_T* rows, size_t n, size_t channels, size_t lanes, size_t width) {
+    for (size_t i = 0; i < n; i++) {
+        const DCT_T* frame = input + i * channels;
+        size_t pos = makhoul_index(i, n);
+        size_t off = (pos >> 1) * 2 * width + (pos & 1);
+        for (size_t g = 0; g < lanes; g += width) {
+            DCT_T* slot = rows + g * n + off;
+            for (size_t l = 0; l < width; l++) slot[2 * l] = frame[g + l];
+        }
+    }
+}
+
+// Inverse of dct_vertical_gather
+static void DCT_FN(dct_vertical_scatter)(const DCT_T* rows, DCT_T* output, size_t n, size_t channels, size_t lanes, size_t width) {
+    for (size_t i = 0; i < n; i++) {
+        DCT_T* frame = output + i * channels;
+        size_t pos = makhoul_index(i, n);
+        size_t off = (pos >> 1) * 2 * width + (pos & 1);
+        for (size_t g = 0; g < lanes; g += width) {
+            const DCT_T* slot = rows + g * n + off;
+            for (size_t l = 0; l < width; l++) frame[g + l] = slot[2 * l];
+        }
+    }
+}
+
+// DCT-II of one vertical group into width plain rows of bins, n values of scratch
+static bool DCT_FN(dct2_vertical)(const fft_cache_entry* plan, DCT_T* group, DCT_T* bins, DCT_T* scratch, size_t n,
+                                  size_t width, DCT_T fct) {
+    if (DCT_FN(cfft_forward_multi)(plan->DCT_FN(cplan), group, 1) != 0) return false;
+    for (size_t l = 0; l < width; l++) DCT_FN(dct2_split_plain)(plan, group + 2 * l, bins + l * n, scratch, n, width, fct);
+    return true;
+}
+
+// DCT-III of width plain rows of bins into one vertical group
+static bool DCT_FN(dct3_vertical)(const fft_cache_entry* plan, const DCT_T* bins, DCT_T* group, size_t n, size_t width, DCT_T fct) {
+    for (size_t l = 0; l < width; l++) DCT_FN(dct3_rotate_split)(plan, bins + l * n, group + 2 * l, n, width);
+    return DCT_FN(cfft_backward_multi)(plan->DCT_FN(cplan), group, fct) == 0;
+}
+
+// Makhoul order of one plain row: even samples ascending, odd samples descending
+static void DCT_FN(dct_makhoul_gather)(const DCT_T* restrict x, DCT_T* restrict row, size_t n) {
+    for (size_t m = 0; m < n / 2; m++) {
+        row[m] = x[2 * m];
+        row[n - 1 - m] = x[2 * m + 1];
+    }
+    if (n & 1) row[n / 2] = x[n - 1];
+}
+
+// Inverse of dct_makhoul_gather
+static void DCT_FN(dct_makhoul_scatter)(const DCT_T* restrict row, DCT_T* restrict x, size_t n) {
+    for (size_t m = 0; m < n / 2; m++) {
+        x[2 * m] = row[m];
+        x[2 * m + 1] = row[n - 1 - m];
+    }
+    if (n & 1) x[n - 1] = row[n / 2];
+}
+
+// DCT-II of a single plain channel, even N > 2, straight from input to output
+static bool DCT_FN(dct2_single)(const fft_cache_entry* plan, const DCT_T* input, DCT_T* output, size_t n, DCT_T fct) {
+    DCT_T* work = (DCT_T*)frad_malloc(n * 2 * sizeof(DCT_T));
+    if (!work) return false;
+
+    DCT_FN(dct_makhoul_gather)(input, work, n);
+    bool ok = DCT_FN(cfft_forward)(plan->DCT_FN(cplan), work, 1) == 0;
+    if (ok) DCT_FN(dct2_split_plain)(plan, work, output, work + n, n, 1, 2 * fct);
+    frad_free(work);
+    return ok;
+}
+
+// DCT-III of a single plain channel, even N > 2, straight from input to output
+static bool DCT_FN(dct3_single)(const fft_cache_entry* plan, const DCT_T* input, DCT_T* output, size_t n, DCT_T fct) {
+    DCT_T* row = (DCT_T*)frad_malloc(n * sizeof(DCT_T));
+    if (!row) return false;
+
+    DCT_FN(dct3_rotate_split)(plan, input, row, n, 1);
+    bool ok = DCT_FN(cfft_backward)(plan->DCT_FN(cplan), row, fct) == 0;
+    if (ok) DCT_FN(dct_makhoul_scatter)(row, output, n);
+    frad_free(row);
+    return ok;
+}
+
+// DCT-II via Makhoul reordering, complex FFT of half length for even N
+// Output is fct * 2 * sum(x[i] * cos(pi * k * (2i + 1) / 2N)) per channel
+// Transforms the first `channels` columns of rows that are `stride` values apart
+static bool DCT_FN(dct2_core)(const DCT_T* input, DCT_T* output, size_t n, size_t channels, size_t stride,
+                               DCT_T fct) {
+    fft_cache_entry* plan = DCT_FN(dct_plan)(n);
+    if (!plan) return false;
+    if (stride == 1 && plan->DCT_FN(cplan)) {
+        bool ok = DCT_FN(dct2_single)(plan, input, output, n, fct);
+        fft_cache_release(plan);
+        return ok;
+    }
+
+    // Block rows and bins, plus one row of scratch for dct2_split_plain
+    size_t block = channels < DCT_BATCH_BLOCK ? channels : DCT_BATCH_BLOCK;
+    DCT_T* work = (DCT_T*)frad_malloc((block * 2 + 1) * n * sizeof(DCT_T));
+    if (!work) {
+        fft_cache_release(plan);
+        return false;
+    }
+    DCT_T* rows = work;
+    DCT_T* bins = work + block * n;
+    DCT_T* scratch = work + block * n * 2;
+
+    bool ok = true;
+    size_t width = DCT_FN(dct_vertical_width)(plan, n);
+    for (size_t c0 = 0; c0 < channels && ok; c0 += block) {
+        size_t nb = channels - c0 < block ? channels - c0 : block;
+        size_t vlanes = width ? nb - nb % width : 0;
+
+        // Gather the block straight into Makhoul order
+        if (vlanes) DCT_FN(dct_vertical_gather)(input + c0, rows, n, stride, vlanes, width);
+        for (size_t i = 0; i < n && vlanes < nb; i++) {
+            const DCT_T* frame = input + i * stride + c0;
+            size_t pos = makhoul_index(i, n);
+            for (size_t b = vlanes; b < nb; b++) rows[b * n + pos] = frame[b];
+        }
+
+        for (size_t b = 0; b < vlanes && ok; b += width) {
+            ok = DCT_FN(dct2_vertical)(plan, rows + b * n, bins + b * n, scratch, n, width, 2 * fct);
+        }
+        for (size_t b = vlanes; b < nb && ok; b++) {
+            DCT_T* row = rows + b * n;
+            if (plan->DCT_FN(cplan)) {
+                ok = DCT_FN(cfft_forward)(plan->DCT_FN(cplan), row, 1) == 0;
+                DCT_FN(dct2_split_plain)(plan, row, bins + b * n, scratch, n, 1, 2 * fct);
+            } else {
+                ok = DCT_FN(rfft_forward)(plan->DCT_FN(rplan), row, 2 * fct) == 0;
+                DCT_FN(dct2_rotate)(plan, row, bins + b * n, n);
+            }
+        }
+
+        // Scatter back to interleaved
+        for (size_t k = 0; k < n; k++) {
+            DCT_T* frame = output + k * stride + c0;
+            for (size_t b = 0; b < nb; b++) frame[b] = bins[b * n + k];
+        }
+    }
+
+    frad_free(work);
+    fft_cache_release(plan);
+    return ok;
+}
+
+// DCT-III via the same Makhoul reordering, inverse of dct2_core with fct = 1 / 2N
+// Output is fct * (X[0] + 2 * sum(X[k] * cos(pi * k * (2i + 1) / 2N))) per channel
+static bool DCT_FN(dct3_core)(const DCT_T* input, DCT_T* output, size_t n, size_t channels, size_t stride,
+                               DCT_T fct) {
+    fft_cache_entry* plan = DCT_FN(dct_plan)(n);
+    if (!plan) return false;
+    if (stride == 1 && plan->DCT_FN(cplan)) {
+        bool ok = DCT_FN(dct3_single)(plan, input, output, n, fct);
+        fft_cache_release(plan);
+        return ok;
+    }
+
+    size_t block = channels < DCT_BATCH_BLOCK ? channels : DCT_BATCH_BLOCK;
+    DCT_T* work = (DCT_T*)frad_malloc(block * n * 2 * sizeof(DCT_T));
+    if (!work) {
+        fft_cache_release(plan);
+        return false;
+    }
+    DCT_T* bins = work;
+    DCT_T* rows = work + block * n;
+
+    bool ok = true;
+    size_t width = DCT_FN(dct_vertical_width)(plan, n);
+    for (size_t c0 = 0; c0 < channels && ok; c0 += block) {
+        size_t nb = channels - c0 < block ? channels - c0 : block;
+        size_t vlanes = width ? nb - nb % width : 0;
+
+        for (size_t k = 0; k < n; k++) {
+            const DCT_T* frame = input + k * stride + c0;
+            for (size_t b = 0; b < nb; b++) bins[b * n + k] = frame[b];
+        }
+
+        for (size_t b = 0; b < vlanes && ok; b += width) {
+            ok = DCT_FN(dct3_vertical)(plan, bins + b * n, rows + b * n, n, width, fct);
+        }
+        for (size_t b = vlanes; b < nb && ok; b++) {
+            DCT_T* row = rows + b * n;
+            if (plan->DCT_FN(cplan)) {
+                DCT_FN(dct3_rotate_split)(plan, bins + b * n, row, n, 1);
+                ok = DCT_FN(cfft_backward)(plan->DCT_FN(cplan), row, fct) == 0;
+            } else {
+                DCT_FN(dct3_rotate)(plan, bins + b * n, row, n);
+                ok = DCT_FN(rfft_backward)(plan->DCT_FN(rplan), row, fct) == 0;
+            }
+        }
+
+        // Undo the Makhoul order while scattering back to interleaved
+        if (vlanes) DCT_FN(dct_vertical_scatter)(rows, output + c0, n, stride, vlanes, width);
+        for (size_t i = 0; i < n && vlanes < nb; i++) {
+            DCT_T* frame = output + i * stride + c0;
+            size_t pos = makhoul_index(i, n);
+            for (size_t b = vlanes; b < nb; b++) frame[b] = rows[b * n + pos];
+        }
+    }
+
+    frad_free(work);
+    fft_cache_release(plan);
+    return ok;
+}
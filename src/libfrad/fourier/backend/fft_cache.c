@@ -0,0 +1,255 @@
+#include "fft_cache.h"
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Process-wide plan cache keyed by (kind, length)
+// Plans are immutable once built, so any number of threads may run
+// transforms on the same entry; the mutex only guards the slot table.
+static struct {
+    pthread_mutex_t lock;
+    fft_cache_entry* slots[FFT_CACHE_MAX_ENTRIES];
+    size_t count;
+    size_t bytes;
+    uint64_t tick;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+} cache = { .lock = PTHREAD_MUTEX_INITIALIZER };
+
+// Rough footprint of a plan: twiddles plus Bluestein/scratch headroom
+static size_t plan_bytes(fft_plan_kind kind, size_t len) {
+    size_t per_bin = kind == FFT_PLAN_COMPLEX ? 4 : kind == FFT_PLAN_REAL ? 2 : 3;
+    size_t elem = kind == FFT_PLAN_DCT_F32 ? sizeof(float) : sizeof(double);
+    return sizeof(fft_cache_entry) + len * per_bin * elem;
+}
+
+static void entry_destroy(fft_cache_entry* entry) {
+    if (!entry) return;
+    if (entry->cplan) destroy_cfft_plan(entry->cplan);
+    if (entry->rplan) destroy_rfft_plan(entry->rplan);
+    if (entry->cplan_f32) destroy_cfft_plan_f32(entry->cplan_f32);
+    if (entry->rplan_f32) destroy_rfft_plan_f32(entry->rplan_f32);
+    free(entry->tw_cos);
+    free(entry->tw_cos_f32);
+    free(entry);
+}
+
+// Rotation factors shared by the DCT pre- and post-rotation loops
+// Laid out as [cos | sin] over half then [cos | sin] over split
+static void dct_twiddle_fill(double* tw, size_t n, size_t half, size_t split) {
+    for (size_t k = 0; k < half; k++) {
+        double phase = M_PI * k / (2.0 * n);
+        tw[k] = cos(phase);
+        tw[half + k] = sin(phase);
+    }
+    for (size_t k = 0; k < split; k++) {
+        double phase = 2.0 * M_PI * k / n;
+        tw[2 * half + k] = cos(phase);
+        tw[2 * half + split + k] = sin(phase);
+    }
+}
+
+static bool dct_twiddle_build(fft_cache_entry* entry) {
+    size_t n = entry->len;
+    size_t half = n / 2 + 1;
+    size_t split = entry->cplan || entry->cplan_f32 ? n / 2 : 0;
+    double* tw = (double*)malloc((half + split) * 2 * sizeof(double));
+    if (!tw) return false;
+    dct_twiddle_fill(tw, n, half, split);
+
+    if (entry->kind == FFT_PLAN_DCT) {
+        entry->tw_cos = tw;
+        entry->tw_sin = tw + half;
+        entry->split_cos = split ? tw + 2 * half : NULL;
+        entry->split_sin = split ? tw + 2 * half + split : NULL;
+        return true;
+    }
+
+    // Single precision tables are rounded from the double ones
+    float* twf = (float*)malloc((half + split) * 2 * sizeof(float));
+    if (twf) {
+        for (size_t k = 0; k < (half + split) * 2; k++) twf[k] = (float)tw[k];
+        entry->tw_cos_f32 = twf;
+        entry->tw_sin_f32 = twf + half;
+        entry->split_cos_f32 = split ? twf + 2 * half : NULL;
+        entry->split_sin_f32 = split ? twf + 2 * half + split : NULL;
+    }
+    free(tw);
+    return twf != NULL;
+}
+
+static fft_cache_entry* entry_build(fft_plan_kind kind, size_t len) {
+    fft_cache_entry* entry = (fft_cache_entry*)calloc(1, sizeof(fft_cache_entry));
+    if (!entry) return NULL;
+
+    entry->kind = kind;
+    entry->len = len;
+    entry->bytes = plan_bytes(kind, len);
+
+    switch (kind) {
+        case FFT_PLAN_COMPLEX:
+            entry->cplan = make_cfft_plan(len);
+            if (!entry->cplan) {
+                free(entry);
+                return NULL;
+            }
+            break;
+        case FFT_PLAN_REAL:
+            entry->rplan = make_rfft_plan(len);
+            if (!entry->rplan) {
+                free(entry);
+                return NULL;
+            }
+            break;
+        case FFT_PLAN_DCT:
+            // pocketfft skips scaling for length 1, so N = 2 stays on the real FFT
+            if (len % 2 == 0 && len > 2) entry->cplan = make_cfft_plan(len / 2);
+            else entry->rplan = make_rfft_plan(len);
+            if ((!entry->cplan && !entry->rplan) || !dct_twiddle_build(entry)) {
+                entry_destroy(entry);
+                return NULL;
+            }
+            break;
+        case FFT_PLAN_DCT_F32:
+            if (len % 2 == 0 && len > 2) entry->cplan_f32 = make_cfft_plan_f32(len / 2);
+            else entry->rplan_f32 = make_rfft_plan_f32(len);
+            if ((!entry->cplan_f32 && !entry->rplan_f32) || !dct_twiddle_build(entry)) {
+                entry_destroy(entry);
+                return NULL;
+            }
+            break;
+    }
+    return entry;
+}
+
+// Must be called with the lock held
+static fft_cache_entry* cache_find(fft_plan_kind kind, size_t len) {
+    for (size_t i = 0; i < cache.count; i++) {
+        fft_cache_entry* entry = cache.slots[i];
+        if (entry->len == len && entry->kind == kind) return entry;
+    }
+    return NULL;
+}
+
+// Evict the least recently used idle entry, must be called with the lock held
+static bool cache_evict_one(void) {
+    size_t victim = cache.count;
+    for (size_t i = 0; i < cache.count; i++) {
+        fft_cache_entry* entry = cache.slots[i];
+        if (entry->refs > 0) continue;
+        if (victim == cache.count || entry->last_use < cache.slots[victim]->last_use) {
+            victim = i;
+        }
+    }
+    if (victim == cache.count) return false;
+
+    fft_cache_entry* entry = cache.slots[victim];
+    cache.slots[victim] = cache.slots[--cache.count];
+    cache.bytes -= entry->bytes;
+    cache.evictions++;
+    entry_destroy(entry);
+    return true;
+}
+
+// Try to make room for an entry of given size, must be called with the lock held
+static bool cache_make_room(size_t bytes) {
+    while (cache.count >= FFT_CACHE_MAX_ENTRIES || cache.bytes + bytes > FFT_CACHE_MAX_BYTES) {
+        if (!cache_evict_one()) return false;
+    }
+    return true;
+}
+
+fft_cache_entry* fft_cache_acquire(fft_plan_kind kind, size_t len) {
+    if (len == 0) return NULL;
+
+    pthread_mutex_lock(&cache.lock);
+    fft_cache_entry* entry = cache_find(kind, len);
+    if (entry) {
+        entry->refs++;
+        entry->last_use = ++cache.tick;
+        cache.hits++;
+        pthread_mutex_unlock(&cache.lock);
+        return entry;
+    }
+    cache.misses++;
+    pthread_mutex_unlock(&cache.lock);
+
+    // Build outside the lock, planning large or Bluestein lengths is slow
+    fft_cache_entry* built = entry_build(kind, len);
+    if (!built) return NULL;
+
+    pthread_mutex_lock(&cache.lock);
+    // Another thread may have inserted the same plan in the meantime
+    entry = cache_find(kind, len);
+    if (entry) {
+        entry->refs++;
+        entry->last_use = ++cache.tick;
+        pthread_mutex_unlock(&cache.lock);
+        entry_destroy(built);
+        return entry;
+    }
+
+    built->refs = 1;
+    built->last_use = ++cache.tick;
+    if (built->bytes <= FFT_CACHE_MAX_BYTES && cache_make_room(built->bytes)) {
+        built->cached = true;
+        cache.slots[cache.count++] = built;
+        cache.bytes += built->bytes;
+    }
+    // else: every slot is busy or the plan is too large, hand out a private plan
+    pthread_mutex_unlock(&cache.lock);
+    return built;
+}
+
+void fft_cache_release(fft_cache_entry* entry) {
+    if (!entry) return;
+
+    pthread_mutex_lock(&cache.lock);
+    bool cached = entry->cached;
+    if (cached) entry->refs--;
+    pthread_mutex_unlock(&cache.lock);
+
+    if (!cached) entry_destroy(entry);
+}
+
+void fft_cache_prewarm(fft_plan_kind kind, const uint32_t* lens, size_t count) {
+    if (!lens) return;
+    for (size_t i = 0; i < count; i++) {
+        fft_cache_release(fft_cache_acquire(kind, lens[i]));
+    }
+}
+
+void fft_cache_get_stats(fft_cache_stats_t* stats) {
+    if (!stats) return;
+
+    pthread_mutex_lock(&cache.lock);
+    stats->hits = cache.hits;
+    stats->misses = cache.misses;
+    stats->evictions = cache.evictions;
+    stats->entries = cache.count;
+    stats->bytes = cache.bytes;
+    pthread_mutex_unlock(&cache.lock);
+}
+
+// Drop every idle plan; plans still in use stay cached
+void fft_cache_clear(void) {
+    pthread_mutex_lock(&cache.lock);
+    size_t i = 0;
+    while (i < cache.count) {
+        fft_cache_entry* entry = cache.slots[i];
+        if (entry->refs > 0) {
+            i++;
+            continue;
+        }
+        cache.slots[i] = cache.slots[--cache.count];
+        cache.bytes -= entry->bytes;
+        entry_destroy(entry);
+    }
+    pthread_mutex_unlock(&cache.lock);
+}
@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// Copyright (C) 2025 HaמuL
+
+#ifndef FFT_CACHE_H
+#define FFT_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "pocketfft.h"
+
+// Upper bounds of the process-wide plan cache
+#define FFT_CACHE_MAX_ENTRIES 64
+#define FFT_CACHE_MAX_BYTES   ((size_t)64 << 20)
+
+// Kind of transform a cached plan was built for
+typedef enum {
+    FFT_PLAN_COMPLEX = 0,
+    FFT_PLAN_REAL,
+    FFT_PLAN_DCT,    // DCT plan with rotation tables
+    FFT_PLAN_DCT_F32 // the same in single precision
+} fft_plan_kind;
+
+// Cached plan, shared read-only between all threads holding a reference
+typedef struct fft_cache_entry {
+    fft_plan_kind kind;
+    size_t len;
+    cfft_plan cplan;
+    rfft_plan rplan;
+
+    // DCT rotation factors cos/sin(pi * k / 2N) for k in [0, N / 2]
+    // Even N > 2 runs as an N/2-point complex FFT (cplan) and also needs the
+    // real-split factors cos/sin(2 * pi * k / N) for k in [0, N / 2),
+    // other lengths use an N-point real FFT (rplan)
+    double* tw_cos;
+    double* tw_sin;
+    double* split_cos;
+    double* split_sin;
+
+    // FFT_PLAN_DCT_F32 fills these instead, same layout
+    cfft_plan_f32 cplan_f32;
+    rfft_plan_f32 rplan_f32;
+    float* tw_cos_f32;
+    float* tw_sin_f32;
+    float* split_cos_f32;
+    float* split_sin_f32;
+
+    // Bookkeeping, owned by the cache
+    size_t bytes;
+    size_t refs;
+    uint64_t last_use;
+    bool cached;
+} fft_cache_entry;
+
+// Cache counters
+typedef struct {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    size_t entries;
+    size_t bytes;
+} fft_cache_stats_t;
+
+// Get a plan of given kind and length, building it on a miss
+// Every acquired entry must be handed back with fft_cache_release
+fft_cache_entry* fft_cache_acquire(fft_plan_kind kind, size_t len);
+void fft_cache_release(fft_cache_entry* entry);
+
+// Build plans for the given lengths ahead of time
+void fft_cache_prewarm(fft_plan_kind kind, const uint32_t* lens, size_t count);
+
+// Counters and maintenance
+void fft_cache_get_stats(fft_cache_stats_t* stats);
+void fft_cache_clear(void);
+
+#endif // FFT_CACHE_H
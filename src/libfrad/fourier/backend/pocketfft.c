@@ -14,11 +14,45 @@
 #include <string.h>
 
 #include "pocketfft.h"
+#include "pocketfft_simd.h"
+#include "../../backend/arena.h"
+
+/* POCKETFFT_FLOAT builds the single-precision flavour (pocketfft_f32.c):
+   transform data and twiddles are float and the public names carry an _f32
+   suffix. Twiddles are still computed in double before rounding. */
+#ifdef POCKETFFT_FLOAT
+typedef float pfreal;
+#define cfft_plan_i         cfft_plan_f32_i
+#define cfft_plan           cfft_plan_f32
+#define make_cfft_plan      make_cfft_plan_f32
+#define destroy_cfft_plan   destroy_cfft_plan_f32
+#define cfft_backward       cfft_backward_f32
+#define cfft_forward        cfft_forward_f32
+#define cfft_length         cfft_length_f32
+#define cfft_multi_width    cfft_multi_width_f32
+#define cfft_backward_multi cfft_backward_multi_f32
+#define cfft_forward_multi  cfft_forward_multi_f32
+#define rfft_plan_i         rfft_plan_f32_i
+#define rfft_plan           rfft_plan_f32
+#define make_rfft_plan      make_rfft_plan_f32
+#define destroy_rfft_plan   destroy_rfft_plan_f32
+#define rfft_backward       rfft_backward_f32
+#define rfft_forward        rfft_forward_f32
+#define rfft_length         rfft_length_f32
+#else
+typedef double pfreal;
+#endif
 
 #define RALLOC(type,num) \
   ((type *)malloc((num)*sizeof(type)))
 #define DEALLOC(ptr) \
   do { free(ptr); (ptr)=NULL; } while(0)
+/* Scratch of a single transform, comes from the frame arena when one is
+   entered; plans themselves always live on the heap. */
+#define WALLOC(type,num) \
+  ((type *)frad_malloc((num)*sizeof(type)))
+#define WDEALLOC(ptr) \
+  do { frad_free(ptr); (ptr)=NULL; } while(0)
 
 #define SWAP(a,b,type) \
   do { type tmp_=(a); (a)=(b); (b)=tmp_; } while(0)
@@ -260,7 +294,7 @@ NOINLINE static size_t good_size(size_t n)
   }
 
 typedef struct cmplx {
-  double r,i;
+  pfreal r,i;
 } cmplx;
 
 #define NFCT 25
@@ -281,11 +315,14 @@ typedef struct cfftp_plan_i * cfftp_plan;
 #define PMC(a,b,c,d) { a.r=c.r+d.r; a.i=c.i+d.i; b.r=c.r-d.r; b.i=c.i-d.i; }
 #define ADDC(a,b,c) { a.r=b.r+c.r; a.i=b.i+c.i; }
 #define SCALEC(a,b) { a.r*=b; a.i*=b; }
-#define ROT90(a) { double tmp_=a.r; a.r=-a.i; a.i=tmp_; }
-#define ROTM90(a) { double tmp_=-a.r; a.r=a.i; a.i=tmp_; }
+#define ROT90(a) { pfreal tmp_=a.r; a.r=-a.i; a.i=tmp_; }
+#define ROTM90(a) { pfreal tmp_=-a.r; a.r=a.i; a.i=tmp_; }
+/* a *= sign*i */
+#define ROTX90(a) { pfreal tmp_=a.r; a.r=-sign*a.i; a.i=sign*tmp_; }
 #define CH(a,b,c) ch[(a)+ido*((b)+l1*(c))]
 #define CC(a,b,c) cc[(a)+ido*((b)+cdim*(c))]
-#define WA(x,i) wa[(i)-1+(x)*(ido-1)]
+/* cfftp twiddles include i=0, always 1, so whole rows of i vectorise */
+#define WA(x,i) wa[(i)+(x)*ido]
 /* a = b*c */
 #define A_EQ_B_MUL_C(a,b,c) { a.r=b.r*c.r-b.i*c.i; a.i=b.r*c.i+b.i*c.r; }
 /* a = conj(b)*c*/
@@ -295,7 +332,157 @@ typedef struct cfftp_plan_i * cfftp_plan;
 /* a = b*c */
 #define MULPMSIGNC(a,b,c) { a.r=b.r*c.r-sign*b.i*c.i; a.i=b.r*c.i+sign*b.i*c.r; }
 /* a *= b */
-#define MULPMSIGNCEQ(a,b) { double xtmp=a.r; a.r=b.r*a.r-sign*b.i*a.i; a.i=b.r*a.i+sign*b.i*xtmp; }
+#define MULPMSIGNCEQ(a,b) { pfreal xtmp=a.r; a.r=b.r*a.r-sign*b.i*a.i; a.i=b.r*a.i+sign*b.i*xtmp; }
+
+#ifdef PFV_LEN
+/* Vector butterflies, PFV_LEN transforms side by side.
+   LD(m) loads input leg m, ST(u,v) stores output leg u, TW(u,v) applies
+   the twiddle of output leg u. With ido==1 the lanes run along k,
+   otherwise along i. */
+#define PFV_CC(m)    PFV_LOAD(&CC(i,m,k))
+#define PFV_CCS(m)   PFV_LOADS(&CC(0,m,k),cdim)
+#define PFV_CH(u,v)  PFV_STORE(&CH(i,k,u),v)
+#define PFV_CH0(u,v) PFV_STORE(&CH(0,k,u),v)
+#define PFV_TWB(u,v) PFV_CMUL(PFV_LOAD(&WA(u-1,i)),v)
+#define PFV_TWF(u,v) PFV_CMULC(PFV_LOAD(&WA(u-1,i)),v)
+#define PFV_TW0(u,v) (v)
+
+#define PFV_PASS2(LD,ST,TW) \
+        { \
+        pfv a=LD(0), b=LD(1); \
+        ST(0,PFV_ADD(a,b)); \
+        ST(1,TW(1,PFV_SUB(a,b))); \
+        }
+#define PFV_PASS3(LD,ST,TW) \
+        { \
+        pfv t0=LD(0), c1=LD(1), c2=LD(2); \
+        pfv t1=PFV_ADD(c1,c2), t2=PFV_SUB(c1,c2); \
+        ST(0,PFV_ADD(t0,t1)); \
+        pfv ca=PFV_FMAS(t0,t1,tw1r), cb=PFV_MULS(PFV_ROT90(t2),tw1i); \
+        ST(1,TW(1,PFV_ADD(ca,cb))); \
+        ST(2,TW(2,PFV_SUB(ca,cb))); \
+        }
+#define PFV_PASS4(LD,ST,TW,ROT) \
+        { \
+        pfv c0=LD(0), c1=LD(1), c2=LD(2), c3=LD(3); \
+        pfv t2=PFV_ADD(c0,c2), t1=PFV_SUB(c0,c2); \
+        pfv t3=PFV_ADD(c1,c3), t4=ROT(PFV_SUB(c1,c3)); \
+        ST(0,PFV_ADD(t2,t3)); \
+        ST(2,TW(2,PFV_SUB(t2,t3))); \
+        ST(1,TW(1,PFV_ADD(t1,t4))); \
+        ST(3,TW(3,PFV_SUB(t1,t4))); \
+        }
+#define PFV_PART5(ST,TW,u1,u2,twar,twbr,twai,twbi) \
+        { \
+        pfv ca=PFV_FMAS(PFV_FMAS(t0,t1,twar),t2,twbr); \
+        pfv cb=PFV_ROT90(PFV_FMAS(PFV_MULS(t4,twai),t3,twbi)); \
+        ST(u1,TW(u1,PFV_ADD(ca,cb))); \
+        ST(u2,TW(u2,PFV_SUB(ca,cb))); \
+        }
+#define PFV_PASS5(LD,ST,TW) \
+        { \
+        pfv t0=LD(0), c1=LD(1), c2=LD(2), c3=LD(3), c4=LD(4); \
+        pfv t1=PFV_ADD(c1,c4), t4=PFV_SUB(c1,c4); \
+        pfv t2=PFV_ADD(c2,c3), t3=PFV_SUB(c2,c3); \
+        ST(0,PFV_ADD(PFV_ADD(t0,t1),t2)); \
+        PFV_PART5(ST,TW,1,4,tw1r,tw2r,+tw1i,+tw2i) \
+        PFV_PART5(ST,TW,2,3,tw2r,tw1r,+tw2i,-tw1i) \
+        }
+/* Radix 8 as two radix-4 halves, odd half rotated by w^1..w^3 */
+#define PFV_PASS8(LD,ST,TW,ROT) \
+        { \
+        pfv c0=LD(0), c1=LD(1), c2=LD(2), c3=LD(3), c4=LD(4), c5=LD(5), c6=LD(6), c7=LD(7); \
+        pfv t1=PFV_ADD(c0,c4), t2=PFV_SUB(c0,c4), t3=PFV_ADD(c2,c6), t4=ROT(PFV_SUB(c2,c6)); \
+        pfv e0=PFV_ADD(t1,t3), e2=PFV_SUB(t1,t3), e1=PFV_ADD(t2,t4), e3=PFV_SUB(t2,t4); \
+        t1=PFV_ADD(c1,c5); t2=PFV_SUB(c1,c5); t3=PFV_ADD(c3,c7); t4=ROT(PFV_SUB(c3,c7)); \
+        pfv o0=PFV_ADD(t1,t3), o2=ROT(PFV_SUB(t1,t3)), o1=PFV_ADD(t2,t4), o3=PFV_SUB(t2,t4); \
+        o1=PFV_MULS(PFV_ADD(o1,ROT(o1)),hsqt2); \
+        o3=PFV_MULS(PFV_SUB(ROT(o3),o3),hsqt2); \
+        ST(0,PFV_ADD(e0,o0)); \
+        ST(4,TW(4,PFV_SUB(e0,o0))); \
+        ST(1,TW(1,PFV_ADD(e1,o1))); \
+        ST(5,TW(5,PFV_SUB(e1,o1))); \
+        ST(2,TW(2,PFV_ADD(e2,o2))); \
+        ST(6,TW(6,PFV_SUB(e2,o2))); \
+        ST(3,TW(3,PFV_ADD(e3,o3))); \
+        ST(7,TW(7,PFV_SUB(e3,o3))); \
+        }
+/* Radix 16 as two rounds of radix-4 butterflies, w^(n2*k1) in between with
+   w = e^(sign*i*pi/8); ROT(x) is x*w^4, the others x*cos + ROT(x)*sin */
+#define PFV_DFT4(x0,x1,x2,x3,y0,y1,y2,y3,ROT) \
+        { \
+        pfv t1=PFV_ADD(x0,x2), t2=PFV_SUB(x0,x2), t3=PFV_ADD(x1,x3), t4=ROT(PFV_SUB(x1,x3)); \
+        y0=PFV_ADD(t1,t3); y2=PFV_SUB(t1,t3); y1=PFV_ADD(t2,t4); y3=PFV_SUB(t2,t4); \
+        }
+#define PFV_ROTW(x,cs,sn,ROT) PFV_FMAS(PFV_MULS(x,cs),ROT(x),sn)
+#define PFV_PASS16(LD,ST,TW,ROT) \
+        { \
+        pfv a0,a1,a2,a3,a4,a5,a6,a7,a8,a9,a10,a11,a12,a13,a14,a15; \
+        { \
+        pfv c0=LD(0), c4=LD(4), c8=LD(8), c12=LD(12); \
+        PFV_DFT4(c0,c4,c8,c12,a0,a1,a2,a3,ROT) \
+        } \
+        { \
+        pfv c1=LD(1), c5=LD(5), c9=LD(9), c13=LD(13); \
+        PFV_DFT4(c1,c5,c9,c13,a4,a5,a6,a7,ROT) \
+        } \
+        { \
+        pfv c2=LD(2), c6=LD(6), c10=LD(10), c14=LD(14); \
+        PFV_DFT4(c2,c6,c10,c14,a8,a9,a10,a11,ROT) \
+        } \
+        { \
+        pfv c3=LD(3), c7=LD(7), c11=LD(11), c15=LD(15); \
+        PFV_DFT4(c3,c7,c11,c15,a12,a13,a14,a15,ROT) \
+        } \
+        a5=PFV_ROTW(a5,c1,s1,ROT); \
+        a6=PFV_MULS(PFV_ADD(a6,ROT(a6)),hsqt2); \
+        a7=PFV_ROTW(a7,s1,c1,ROT); \
+        a9=PFV_MULS(PFV_ADD(a9,ROT(a9)),hsqt2); \
+        a10=ROT(a10); \
+        a11=PFV_MULS(PFV_SUB(ROT(a11),a11),hsqt2); \
+        a13=PFV_ROTW(a13,s1,c1,ROT); \
+        a14=PFV_MULS(PFV_SUB(ROT(a14),a14),hsqt2); \
+        a15=PFV_ROTW(a15,-c1,-s1,ROT); \
+        { \
+        pfv y0,y4,y8,y12; \
+        PFV_DFT4(a0,a4,a8,a12,y0,y4,y8,y12,ROT) \
+        ST(0,y0); ST(4,TW(4,y4)); ST(8,TW(8,y8)); ST(12,TW(12,y12)); \
+        } \
+        { \
+        pfv y1,y5,y9,y13; \
+        PFV_DFT4(a1,a5,a9,a13,y1,y5,y9,y13,ROT) \
+        ST(1,TW(1,y1)); ST(5,TW(5,y5)); ST(9,TW(9,y9)); ST(13,TW(13,y13)); \
+        } \
+        { \
+        pfv y2,y6,y10,y14; \
+        PFV_DFT4(a2,a6,a10,a14,y2,y6,y10,y14,ROT) \
+        ST(2,TW(2,y2)); ST(6,TW(6,y6)); ST(10,TW(10,y10)); ST(14,TW(14,y14)); \
+        } \
+        { \
+        pfv y3,y7,y11,y15; \
+        PFV_DFT4(a3,a7,a11,a15,y3,y7,y11,y15,ROT) \
+        ST(3,TW(3,y3)); ST(7,TW(7,y7)); ST(11,TW(11,y11)); ST(15,TW(15,y15)); \
+        } \
+        }
+#define PFV_PART7(ST,TW,u1,u2,x1,x2,x3,y1,y2,y3) \
+        { \
+        pfv ca=PFV_FMAS(PFV_FMAS(PFV_FMAS(t1,t2,x1),t3,x2),t4,x3); \
+        pfv cb=PFV_ROT90(PFV_FMAS(PFV_FMAS(PFV_MULS(t7,y1),t6,y2),t5,y3)); \
+        ST(u1,TW(u1,PFV_ADD(ca,cb))); \
+        ST(u2,TW(u2,PFV_SUB(ca,cb))); \
+        }
+#define PFV_PASS7(LD,ST,TW) \
+        { \
+        pfv t1=LD(0), c1=LD(1), c2=LD(2), c3=LD(3), c4=LD(4), c5=LD(5), c6=LD(6); \
+        pfv t2=PFV_ADD(c1,c6), t7=PFV_SUB(c1,c6); \
+        pfv t3=PFV_ADD(c2,c5), t6=PFV_SUB(c2,c5); \
+        pfv t4=PFV_ADD(c3,c4), t5=PFV_SUB(c3,c4); \
+        ST(0,PFV_ADD(PFV_ADD(PFV_ADD(t1,t2),t3),t4)); \
+        PFV_PART7(ST,TW,1,6,tw1r,tw2r,tw3r,+tw1i,+tw2i,+tw3i) \
+        PFV_PART7(ST,TW,2,5,tw2r,tw3r,tw1r,+tw2i,-tw3i,-tw1i) \
+        PFV_PART7(ST,TW,3,4,tw3r,tw1r,tw2r,+tw3i,-tw1i,+tw2i) \
+        }
+#endif
 
 NOINLINE static void pass2b (size_t ido, size_t l1, const cmplx * restrict cc,
   cmplx * restrict ch, const cmplx * restrict wa)
@@ -303,13 +490,32 @@ NOINLINE static void pass2b (size_t ido, size_t l1, const cmplx * restrict cc,
   const size_t cdim=2;
 
   if (ido==1)
-    for (size_t k=0; k<l1; ++k)
+    {
+    size_t k=0;
+#ifdef PFV_LEN
+    for (; k+PFV_LEN<=l1; k+=PFV_LEN)
+      PFV_PASS2(PFV_CCS,PFV_CH0,PFV_TW0)
+#endif
+    for (; k<l1; ++k)
       PMC (CH(0,k,0),CH(0,k,1),CC(0,0,k),CC(0,1,k))
+    }
   else
+#ifdef PFV_LEN
+  if (ido%PFV_LEN==0)
+    for (size_t k=0; k<l1; ++k)
+      for (size_t i=0; i<ido; i+=PFV_LEN)
+        PFV_PASS2(PFV_CC,PFV_CH,PFV_TWB)
+  else
+#endif
     for (size_t k=0; k<l1; ++k)
       {
       PMC (CH(0,k,0),CH(0,k,1),CC(0,0,k),CC(0,1,k))
-      for (size_t i=1; i<ido; ++i)
+      size_t i=1;
+#ifdef PFV_LEN
+      for (; i+PFV_LEN<=ido; i+=PFV_LEN)
+        PFV_PASS2(PFV_CC,PFV_CH,PFV_TWB)
+#endif
+      for (; i<ido; ++i)
         {
         cmplx t;
         PMC (CH(i,k,0),t,CC(i,0,k),CC(i,1,k))
@@ -324,13 +530,32 @@ NOINLINE static void pass2f (size_t ido, size_t l1, const cmplx * restrict cc,
   const size_t cdim=2;
 
   if (ido==1)
-    for (size_t k=0; k<l1; ++k)
+    {
+    size_t k=0;
+#ifdef PFV_LEN
+    for (; k+PFV_LEN<=l1; k+=PFV_LEN)
+      PFV_PASS2(PFV_CCS,PFV_CH0,PFV_TW0)
+#endif
+    for (; k<l1; ++k)
       PMC (CH(0,k,0),CH(0,k,1),CC(0,0,k),CC(0,1,k))
+    }
   else
+#ifdef PFV_LEN
+  if (ido%PFV_LEN==0)
+    for (size_t k=0; k<l1; ++k)
+      for (size_t i=0; i<ido; i+=PFV_LEN)
+        PFV_PASS2(PFV_CC,PFV_CH,PFV_TWF)
+  else
+#endif
     for (size_t k=0; k<l1; ++k)
       {
       PMC (CH(0,k,0),CH(0,k,1),CC(0,0,k),CC(0,1,k))
-      for (size_t i=1; i<ido; ++i)
+      size_t i=1;
+#ifdef PFV_LEN
+      for (; i+PFV_LEN<=ido; i+=PFV_LEN)
+        PFV_PASS2(PFV_CC,PFV_CH,PFV_TWF)
+#endif
+      for (; i<ido; ++i)
         {
         cmplx t;
         PMC (CH(i,k,0),t,CC(i,0,k),CC(i,1,k))
@@ -369,22 +594,41 @@ NOINLINE static void pass3b (size_t ido, size_t l1, const cmplx * restrict cc,
   cmplx * restrict ch, const cmplx * restrict wa)
   {
   const size_t cdim=3;
-  const double tw1r=-0.5, tw1i= 0.86602540378443864676;
+  const pfreal tw1r=-0.5, tw1i= 0.86602540378443864676;
 
   if (ido==1)
-    for (size_t k=0; k<l1; ++k)
+    {
+    size_t k=0;
+#ifdef PFV_LEN
+    for (; k+PFV_LEN<=l1; k+=PFV_LEN)
+      PFV_PASS3(PFV_CCS,PFV_CH0,PFV_TW0)
+#endif
+    for (; k<l1; ++k)
       {
       PREP3(0)
       PARTSTEP3a(1,2,tw1r,tw1i)
       }
+    }
+  else
+#ifdef PFV_LEN
+  if (ido%PFV_LEN==0)
+    for (size_t k=0; k<l1; ++k)
+      for (size_t i=0; i<ido; i+=PFV_LEN)
+        PFV_PASS3(PFV_CC,PFV_CH,PFV_TWB)
   else
+#endif
     for (size_t k=0; k<l1; ++k)
       {
       {
       PREP3(0)
       PARTSTEP3a(1,2,tw1r,tw1i)
       }
-      for (size_t i=1; i<ido; ++i)
+      size_t i=1;
+#ifdef PFV_LEN
+      for (; i+PFV_LEN<=ido; i+=PFV_LEN)
+        PFV_PASS3(PFV_CC,PFV_CH,PFV_TWB)
+#endif
+      for (; i<ido; ++i)
         {
         PREP3(i)
         PARTSTEP3b(1,2,tw1r,tw1i)
@@ -406,22 +650,41 @@ NOINLINE static void pass3f (size_t ido, size_t l1, const cmplx * restrict cc,
   cmplx * restrict ch, const cmplx * restrict wa)
   {
   const size_t cdim=3;
-  const double tw1r=-0.5, tw1i= -0.86602540378443864676;
+  const pfreal tw1r=-0.5, tw1i= -0.86602540378443864676;
 
   if (ido==1)
-    for (size_t k=0; k<l1; ++k)
+    {
+    size_t k=0;
+#ifdef PFV_LEN
+    for (; k+PFV_LEN<=l1; k+=PFV_LEN)
+      PFV_PASS3(PFV_CCS,PFV_CH0,PFV_TW0)
+#endif
+    for (; k<l1; ++k)
       {
       PREP3(0)
       PARTSTEP3a(1,2,tw1r,tw1i)
       }
+    }
   else
+#ifdef PFV_LEN
+  if (ido%PFV_LEN==0)
+    for (size_t k=0; k<l1; ++k)
+      for (size_t i=0; i<ido; i+=PFV_LEN)
+        PFV_PASS3(PFV_CC,PFV_CH,PFV_TWF)
+  else
+#endif
     for (size_t k=0; k<l1; ++k)
       {
       {
       PREP3(0)
       PARTSTEP3a(1,2,tw1r,tw1i)
       }
-      for (size_t i=1; i<ido; ++i)
+      size_t i=1;
+#ifdef PFV_LEN
+      for (; i+PFV_LEN<=ido; i+=PFV_LEN)
+        PFV_PASS3(PFV_CC,PFV_CH,PFV_TWF)
+#endif
+      for (; i<ido; ++i)
         {
         PREP3(i)
         PARTSTEP3f(1,2,tw1r,tw1i)
@@ -435,7 +698,13 @@ NOINLINE static void pass4b (size_t ido, size_t l1, const cmplx * restrict cc,
   const size_t cdim=4;
 
   if (ido==1)
-    for (size_t k=0; k<l1; ++k)
+    {
+    size_t k=0;
+#ifdef PFV_LEN
+    for (; k+PFV_LEN<=l1; k+=PFV_LEN)
+      PFV_PASS4(PFV_CCS,PFV_CH0,PFV_TW0,PFV_ROT90)
+#endif
+    for (; k<l1; ++k)
       {
       cmplx t1, t2, t3, t4;
       PMC(t2,t1,CC(0,0,k),CC(0,2,k))
@@ -444,7 +713,15 @@ NOINLINE static void pass4b (size_t ido, size_t l1, const cmplx * restrict cc,
       PMC(CH(0,k,0),CH(0,k,2),t2,t3)
       PMC(CH(0,k,1),CH(0,k,3),t1,t4)
       }
+    }
+  else
+#ifdef PFV_LEN
+  if (ido%PFV_LEN==0)
+    for (size_t k=0; k<l1; ++k)
+      for (size_t i=0; i<ido; i+=PFV_LEN)
+        PFV_PASS4(PFV_CC,PFV_CH,PFV_TWB,PFV_ROT90)
   else
+#endif
     for (size_t k=0; k<l1; ++k)
       {
       {
@@ -455,7 +732,12 @@ NOINLINE static void pass4b (size_t ido, size_t l1, const cmplx * restrict cc,
       PMC(CH(0,k,0),CH(0,k,2),t2,t3)
       PMC(CH(0,k,1),CH(0,k,3),t1,t4)
       }
-      for (size_t i=1; i<ido; ++i)
+      size_t i=1;
+#ifdef PFV_LEN
+      for (; i+PFV_LEN<=ido; i+=PFV_LEN)
+        PFV_PASS4(PFV_CC,PFV_CH,PFV_TWB,PFV_ROT90)
+#endif
+      for (; i<ido; ++i)
         {
         cmplx c2, c3, c4, t1, t2, t3, t4;
         cmplx cc0=CC(i,0,k), cc1=CC(i,1,k),cc2=CC(i,2,k),cc3=CC(i,3,k);
@@ -477,7 +759,13 @@ NOINLINE static void pass4f (size_t ido, size_t l1, const cmplx * restrict cc,
   const size_t cdim=4;
 
   if (ido==1)
-    for (size_t k=0; k<l1; ++k)
+    {
+    size_t k=0;
+#ifdef PFV_LEN
+    for (; k+PFV_LEN<=l1; k+=PFV_LEN)
+      PFV_PASS4(PFV_CCS,PFV_CH0,PFV_TW0,PFV_ROTM90)
+#endif
+    for (; k<l1; ++k)
       {
       cmplx t1, t2, t3, t4;
       PMC(t2,t1,CC(0,0,k),CC(0,2,k))
@@ -486,7 +774,15 @@ NOINLINE static void pass4f (size_t ido, size_t l1, const cmplx * restrict cc,
       PMC(CH(0,k,0),CH(0,k,2),t2,t3)
       PMC(CH(0,k,1),CH(0,k,3),t1,t4)
       }
+    }
   else
+#ifdef PFV_LEN
+  if (ido%PFV_LEN==0)
+    for (size_t k=0; k<l1; ++k)
+      for (size_t i=0; i<ido; i+=PFV_LEN)
+        PFV_PASS4(PFV_CC,PFV_CH,PFV_TWF,PFV_ROTM90)
+  else
+#endif
     for (size_t k=0; k<l1; ++k)
       {
       {
@@ -497,7 +793,12 @@ NOINLINE static void pass4f (size_t ido, size_t l1, const cmplx * restrict cc,
       PMC(CH(0,k,0),CH(0,k,2),t2,t3)
       PMC (CH(0,k,1),CH(0,k,3),t1,t4)
       }
-      for (size_t i=1; i<ido; ++i)
+      size_t i=1;
+#ifdef PFV_LEN
+      for (; i+PFV_LEN<=ido; i+=PFV_LEN)
+        PFV_PASS4(PFV_CC,PFV_CH,PFV_TWF,PFV_ROTM90)
+#endif
+      for (; i<ido; ++i)
         {
         cmplx c2, c3, c4, t1, t2, t3, t4;
         cmplx cc0=CC(i,0,k), cc1=CC(i,1,k),cc2=CC(i,2,k),cc3=CC(i,3,k);
@@ -546,19 +847,33 @@ NOINLINE static void pass5b (size_t ido, size_t l1, const cmplx * restrict cc,
   cmplx * restrict ch, const cmplx * restrict wa)
   {
   const size_t cdim=5;
-  const double tw1r= 0.3090169943749474241,
+  const pfreal tw1r= 0.3090169943749474241,
                tw1i= 0.95105651629515357212,
                tw2r= -0.8090169943749474241,
                tw2i= 0.58778525229247312917;
 
   if (ido==1)
-    for (size_t k=0; k<l1; ++k)
+    {
+    size_t k=0;
+#ifdef PFV_LEN
+    for (; k+PFV_LEN<=l1; k+=PFV_LEN)
+      PFV_PASS5(PFV_CCS,PFV_CH0,PFV_TW0)
+#endif
+    for (; k<l1; ++k)
       {
       PREP5(0)
       PARTSTEP5a(1,4,tw1r,tw2r,+tw1i,+tw2i)
       PARTSTEP5a(2,3,tw2r,tw1r,+tw2i,-tw1i)
       }
+    }
+  else
+#ifdef PFV_LEN
+  if (ido%PFV_LEN==0)
+    for (size_t k=0; k<l1; ++k)
+      for (size_t i=0; i<ido; i+=PFV_LEN)
+        PFV_PASS5(PFV_CC,PFV_CH,PFV_TWB)
   else
+#endif
     for (size_t k=0; k<l1; ++k)
       {
       {
@@ -566,7 +881,12 @@ NOINLINE static void pass5b (size_t ido, size_t l1, const cmplx * restrict cc,
       PARTSTEP5a(1,4,tw1r,tw2r,+tw1i,+tw2i)
       PARTSTEP5a(2,3,tw2r,tw1r,+tw2i,-tw1i)
       }
-      for (size_t i=1; i<ido; ++i)
+      size_t i=1;
+#ifdef PFV_LEN
+      for (; i+PFV_LEN<=ido; i+=PFV_LEN)
+        PFV_PASS5(PFV_CC,PFV_CH,PFV_TWB)
+#endif
+      for (; i<ido; ++i)
         {
         PREP5(i)
         PARTSTEP5b(1,4,tw1r,tw2r,+tw1i,+tw2i)
@@ -589,19 +909,33 @@ NOINLINE static void pass5f (size_t ido, size_t l1, const cmplx * restrict cc,
   cmplx * restrict ch, const cmplx * restrict wa)
   {
   const size_t cdim=5;
-  const double tw1r= 0.3090169943749474241,
+  const pfreal tw1r= 0.3090169943749474241,
                tw1i= -0.95105651629515357212,
                tw2r= -0.8090169943749474241,
                tw2i= -0.58778525229247312917;
 
   if (ido==1)
-    for (size_t k=0; k<l1; ++k)
+    {
+    size_t k=0;
+#ifdef PFV_LEN
+    for (; k+PFV_LEN<=l1; k+=PFV_LEN)
+      PFV_PASS5(PFV_CCS,PFV_CH0,PFV_TW0)
+#endif
+    for (; k<l1; ++k)
       {
       PREP5(0)
       PARTSTEP5a(1,4,tw1r,tw2r,+tw1i,+tw2i)
       PARTSTEP5a(2,3,tw2r,tw1r,+tw2i,-tw1i)
       }
+    }
+  else
+#ifdef PFV_LEN
+  if (ido%PFV_LEN==0)
+    for (size_t k=0; k<l1; ++k)
+      for (size_t i=0; i<ido; i+=PFV_LEN)
+        PFV_PASS5(PFV_CC,PFV_CH,PFV_TWF)
   else
+#endif
     for (size_t k=0; k<l1; ++k)
       {
       {
@@ -609,7 +943,12 @@ NOINLINE static void pass5f (size_t ido, size_t l1, const cmplx * restrict cc,
       PARTSTEP5a(1,4,tw1r,tw2r,+tw1i,+tw2i)
       PARTSTEP5a(2,3,tw2r,tw1r,+tw2i,-tw1i)
       }
-      for (size_t i=1; i<ido; ++i)
+      size_t i=1;
+#ifdef PFV_LEN
+      for (; i+PFV_LEN<=ido; i+=PFV_LEN)
+        PFV_PASS5(PFV_CC,PFV_CH,PFV_TWF)
+#endif
+      for (; i<ido; ++i)
         {
         PREP5(i)
         PARTSTEP5f(1,4,tw1r,tw2r,+tw1i,+tw2i)
@@ -649,7 +988,7 @@ NOINLINE static void pass7(size_t ido, size_t l1, const cmplx * restrict cc,
   cmplx * restrict ch, const cmplx * restrict wa, const int sign)
   {
   const size_t cdim=7;
-  const double tw1r= 0.623489801858733530525,
+  const pfreal tw1r= 0.623489801858733530525,
                tw1i= sign * 0.7818314824680298087084,
                tw2r= -0.222520933956314404289,
                tw2i= sign * 0.9749279121818236070181,
@@ -657,14 +996,34 @@ NOINLINE static void pass7(size_t ido, size_t l1, const cmplx * restrict cc,
                tw3i= sign * 0.4338837391175581204758;
 
   if (ido==1)
-    for (size_t k=0; k<l1; ++k)
+    {
+    size_t k=0;
+#ifdef PFV_LEN
+    for (; k+PFV_LEN<=l1; k+=PFV_LEN)
+      PFV_PASS7(PFV_CCS,PFV_CH0,PFV_TW0)
+#endif
+    for (; k<l1; ++k)
       {
       PREP7(0)
       PARTSTEP7a(1,6,tw1r,tw2r,tw3r,+tw1i,+tw2i,+tw3i)
       PARTSTEP7a(2,5,tw2r,tw3r,tw1r,+tw2i,-tw3i,-tw1i)
       PARTSTEP7a(3,4,tw3r,tw1r,tw2r,+tw3i,-tw1i,+tw2i)
       }
+    }
   else
+#ifdef PFV_LEN
+  if (ido%PFV_LEN==0)
+    for (size_t k=0; k<l1; ++k)
+      {
+      if (sign>0)
+        for (size_t i=0; i<ido; i+=PFV_LEN)
+          PFV_PASS7(PFV_CC,PFV_CH,PFV_TWB)
+      else
+        for (size_t i=0; i<ido; i+=PFV_LEN)
+          PFV_PASS7(PFV_CC,PFV_CH,PFV_TWF)
+      }
+  else
+#endif
     for (size_t k=0; k<l1; ++k)
       {
       {
@@ -673,7 +1032,16 @@ NOINLINE static void pass7(size_t ido, size_t l1, const cmplx * restrict cc,
       PARTSTEP7a(2,5,tw2r,tw3r,tw1r,+tw2i,-tw3i,-tw1i)
       PARTSTEP7a(3,4,tw3r,tw1r,tw2r,+tw3i,-tw1i,+tw2i)
       }
-      for (size_t i=1; i<ido; ++i)
+      size_t i=1;
+#ifdef PFV_LEN
+      if (sign>0)
+        for (; i+PFV_LEN<=ido; i+=PFV_LEN)
+          PFV_PASS7(PFV_CC,PFV_CH,PFV_TWB)
+      else
+        for (; i+PFV_LEN<=ido; i+=PFV_LEN)
+          PFV_PASS7(PFV_CC,PFV_CH,PFV_TWF)
+#endif
+      for (; i<ido; ++i)
         {
         PREP7(i)
         PARTSTEP7(1,6,tw1r,tw2r,tw3r,+tw1i,+tw2i,+tw3i)
@@ -683,6 +1051,212 @@ NOINLINE static void pass7(size_t ido, size_t l1, const cmplx * restrict cc,
       }
   }
 
+/* Straight-line 8-point DFT of x[0], x[s], ..., x[7s]: two radix-4 halves,
+   the odd half rotated by w^1..w^3 with w = e^(sign*i*pi/4) */
+static inline void dft8(const cmplx * restrict x, size_t s, cmplx * restrict y,
+  const int sign)
+  {
+  const pfreal hsqt2=0.707106781186547524400844362104849;
+  cmplx t1,t2,t3,t4,e0,e1,e2,e3,o0,o1,o2,o3,r;
+  PMC(t1,t2,x[0],x[4*s])
+  PMC(t3,t4,x[2*s],x[6*s])
+  ROTX90(t4)
+  PMC(e0,e2,t1,t3)
+  PMC(e1,e3,t2,t4)
+  PMC(t1,t2,x[s],x[5*s])
+  PMC(t3,t4,x[3*s],x[7*s])
+  ROTX90(t4)
+  PMC(o0,o2,t1,t3)
+  PMC(o1,o3,t2,t4)
+  ROTX90(o2)
+  r=o1; ROTX90(r)
+  o1.r=hsqt2*(o1.r+r.r); o1.i=hsqt2*(o1.i+r.i);
+  r=o3; ROTX90(r)
+  o3.r=hsqt2*(r.r-o3.r); o3.i=hsqt2*(r.i-o3.i);
+  PMC(y[0],y[4],e0,o0)
+  PMC(y[1],y[5],e1,o1)
+  PMC(y[2],y[6],e2,o2)
+  PMC(y[3],y[7],e3,o3)
+  }
+
+NOINLINE static void pass8(size_t ido, size_t l1, const cmplx * restrict cc,
+  cmplx * restrict ch, const cmplx * restrict wa, const int sign)
+  {
+  const size_t cdim=8;
+#ifdef PFV_LEN
+  const pfreal hsqt2=0.707106781186547524400844362104849;
+#endif
+
+  if (ido==1)
+    {
+    size_t k=0;
+#ifdef PFV_LEN
+    if (sign>0)
+      for (; k+PFV_LEN<=l1; k+=PFV_LEN)
+        PFV_PASS8(PFV_CCS,PFV_CH0,PFV_TW0,PFV_ROT90)
+    else
+      for (; k+PFV_LEN<=l1; k+=PFV_LEN)
+        PFV_PASS8(PFV_CCS,PFV_CH0,PFV_TW0,PFV_ROTM90)
+#endif
+    for (; k<l1; ++k)
+      {
+      cmplx y[8];
+      dft8(&CC(0,0,k),1,y,sign);
+      for (size_t u=0; u<8; ++u)
+        CH(0,k,u)=y[u];
+      }
+    }
+  else
+#ifdef PFV_LEN
+  if (ido%PFV_LEN==0)
+    for (size_t k=0; k<l1; ++k)
+      {
+      if (sign>0)
+        for (size_t i=0; i<ido; i+=PFV_LEN)
+          PFV_PASS8(PFV_CC,PFV_CH,PFV_TWB,PFV_ROT90)
+      else
+        for (size_t i=0; i<ido; i+=PFV_LEN)
+          PFV_PASS8(PFV_CC,PFV_CH,PFV_TWF,PFV_ROTM90)
+      }
+  else
+#endif
+    for (size_t k=0; k<l1; ++k)
+      {
+      cmplx y[8];
+      dft8(&CC(0,0,k),ido,y,sign);
+      for (size_t u=0; u<8; ++u)
+        CH(0,k,u)=y[u];
+      size_t i=1;
+#ifdef PFV_LEN
+      if (sign>0)
+        for (; i+PFV_LEN<=ido; i+=PFV_LEN)
+          PFV_PASS8(PFV_CC,PFV_CH,PFV_TWB,PFV_ROT90)
+      else
+        for (; i+PFV_LEN<=ido; i+=PFV_LEN)
+          PFV_PASS8(PFV_CC,PFV_CH,PFV_TWF,PFV_ROTM90)
+#endif
+      for (; i<ido; ++i)
+        {
+        dft8(&CC(i,0,k),ido,y,sign);
+        CH(i,k,0)=y[0];
+        if (sign>0)
+          for (size_t u=1; u<8; ++u)
+            A_EQ_B_MUL_C (CH(i,k,u),WA(u-1,i),y[u])
+        else
+          for (size_t u=1; u<8; ++u)
+            A_EQ_CB_MUL_C (CH(i,k,u),WA(u-1,i),y[u])
+        }
+      }
+  }
+
+/* Straight-line 16-point DFT of x[0], x[s], ..., x[15s]: radix-4 butterflies
+   over n1, twiddles w^(n2*k1) with w = e^(sign*i*pi/8), radix-4 over n2 */
+static inline void dft16(const cmplx * restrict x, size_t s, cmplx * restrict y,
+  const int sign)
+  {
+  const pfreal c1=0.923879532511286756128183189397,
+               s1=0.382683432365089771728459984030,
+               hsqt2=0.707106781186547524400844362104849;
+  const cmplx w[9]={ {c1,sign*s1}, {hsqt2,sign*hsqt2}, {s1,sign*c1},
+                     {hsqt2,sign*hsqt2}, {0,sign}, {-hsqt2,sign*hsqt2},
+                     {s1,sign*c1}, {-hsqt2,sign*hsqt2}, {-c1,-sign*s1} };
+  cmplx a[16], t1, t2, t3, t4;
+  for (size_t n2=0; n2<4; ++n2)
+    {
+    PMC(t1,t2,x[n2*s],x[(n2+8)*s])
+    PMC(t3,t4,x[(n2+4)*s],x[(n2+12)*s])
+    ROTX90(t4)
+    PMC(a[4*n2],a[4*n2+2],t1,t3)
+    PMC(a[4*n2+1],a[4*n2+3],t2,t4)
+    }
+  for (size_t n2=1; n2<4; ++n2)
+    for (size_t k1=1; k1<4; ++k1)
+      {
+      cmplx v=a[4*n2+k1];
+      A_EQ_B_MUL_C (a[4*n2+k1],w[3*(n2-1)+k1-1],v)
+      }
+  for (size_t k1=0; k1<4; ++k1)
+    {
+    PMC(t1,t2,a[k1],a[k1+8])
+    PMC(t3,t4,a[k1+4],a[k1+12])
+    ROTX90(t4)
+    PMC(y[k1],y[k1+8],t1,t3)
+    PMC(y[k1+4],y[k1+12],t2,t4)
+    }
+  }
+
+NOINLINE static void pass16(size_t ido, size_t l1, const cmplx * restrict cc,
+  cmplx * restrict ch, const cmplx * restrict wa, const int sign)
+  {
+  const size_t cdim=16;
+#ifdef PFV_LEN
+  const pfreal c1=0.923879532511286756128183189397,
+               s1=0.382683432365089771728459984030,
+               hsqt2=0.707106781186547524400844362104849;
+#endif
+
+  if (ido==1)
+    {
+    size_t k=0;
+#ifdef PFV_LEN
+    if (sign>0)
+      for (; k+PFV_LEN<=l1; k+=PFV_LEN)
+        PFV_PASS16(PFV_CCS,PFV_CH0,PFV_TW0,PFV_ROT90)
+    else
+      for (; k+PFV_LEN<=l1; k+=PFV_LEN)
+        PFV_PASS16(PFV_CCS,PFV_CH0,PFV_TW0,PFV_ROTM90)
+#endif
+    for (; k<l1; ++k)
+      {
+      cmplx y[16];
+      dft16(&CC(0,0,k),1,y,sign);
+      for (size_t u=0; u<16; ++u)
+        CH(0,k,u)=y[u];
+      }
+    }
+  else
+#ifdef PFV_LEN
+  if (ido%PFV_LEN==0)
+    for (size_t k=0; k<l1; ++k)
+      {
+      if (sign>0)
+        for (size_t i=0; i<ido; i+=PFV_LEN)
+          PFV_PASS16(PFV_CC,PFV_CH,PFV_TWB,PFV_ROT90)
+      else
+        for (size_t i=0; i<ido; i+=PFV_LEN)
+          PFV_PASS16(PFV_CC,PFV_CH,PFV_TWF,PFV_ROTM90)
+      }
+  else
+#endif
+    for (size_t k=0; k<l1; ++k)
+      {
+      cmplx y[16];
+      dft16(&CC(0,0,k),ido,y,sign);
+      for (size_t u=0; u<16; ++u)
+        CH(0,k,u)=y[u];
+      size_t i=1;
+#ifdef PFV_LEN
+      if (sign>0)
+        for (; i+PFV_LEN<=ido; i+=PFV_LEN)
+          PFV_PASS16(PFV_CC,PFV_CH,PFV_TWB,PFV_ROT90)
+      else
+        for (; i+PFV_LEN<=ido; i+=PFV_LEN)
+          PFV_PASS16(PFV_CC,PFV_CH,PFV_TWF,PFV_ROTM90)
+#endif
+      for (; i<ido; ++i)
+        {
+        dft16(&CC(i,0,k),ido,y,sign);
+        CH(i,k,0)=y[0];
+        if (sign>0)
+          for (size_t u=1; u<16; ++u)
+            A_EQ_B_MUL_C (CH(i,k,u),WA(u-1,i),y[u])
+        else
+          for (size_t u=1; u<16; ++u)
+            A_EQ_CB_MUL_C (CH(i,k,u),WA(u-1,i),y[u])
+        }
+      }
+  }
+
 #define PREP11(idx) \
         cmplx t1 = CC(idx,0,k), t2, t3, t4, t5, t6, t7, t8, t9, t10, t11; \
         PMC (t2,t11,CC(idx,1,k),CC(idx,10,k)) \
@@ -716,7 +1290,7 @@ NOINLINE static void pass11 (size_t ido, size_t l1, const cmplx * restrict cc,
   cmplx * restrict ch, const cmplx * restrict wa, const int sign)
   {
   const size_t cdim=11;
-  const double tw1r =        0.8412535328311811688618,
+  const pfreal tw1r =        0.8412535328311811688618,
                tw1i = sign * 0.5406408174555975821076,
                tw2r =        0.4154150130018864255293,
                tw2i = sign * 0.9096319953545183714117,
@@ -772,7 +1346,7 @@ NOINLINE static int passg (size_t ido, size_t ip, size_t l1,
   size_t ipph = (ip+1)/2;
   size_t idl1 = ido*l1;
 
-  cmplx * restrict wal=RALLOC(cmplx,ip);
+  cmplx * restrict wal=WALLOC(cmplx,ip);
   if (!wal) return -1;
   wal[0]=(cmplx){1.,0.};
   for (size_t i=1; i<ip; ++i)
@@ -833,7 +1407,7 @@ NOINLINE static int passg (size_t ido, size_t ip, size_t l1,
         }
       }
     }
-  DEALLOC(wal);
+  WDEALLOC(wal);
 
   // shuffling and twiddling
   if (ido==1)
@@ -854,9 +1428,9 @@ NOINLINE static int passg (size_t ido, size_t ip, size_t l1,
           {
           cmplx x1, x2;
           PMC(x1,x2,CX(i,k,j),CX(i,k,jc))
-          size_t idij=(j-1)*(ido-1)+i-1;
+          size_t idij=(j-1)*ido+i;
           MULPMSIGNC (CX(i,k,j),wa[idij],x1)
-          idij=(jc-1)*(ido-1)+i-1;
+          idij=(jc-1)*ido+i;
           MULPMSIGNC (CX(i,k,jc),wa[idij],x2)
           }
         }
@@ -868,13 +1442,13 @@ NOINLINE static int passg (size_t ido, size_t ip, size_t l1,
 #undef CX2
 #undef CX
 
-NOINLINE WARN_UNUSED_RESULT static int pass_all(cfftp_plan plan, cmplx c[], double fct,
+NOINLINE WARN_UNUSED_RESULT static int pass_all(cfftp_plan plan, cmplx c[], pfreal fct,
   const int sign)
   {
   if (plan->length==1) return 0;
   size_t len=plan->length;
   size_t l1=1, nf=plan->nfct;
-  cmplx *ch = RALLOC(cmplx, len);
+  cmplx *ch = WALLOC(cmplx, len);
   if (!ch) return -1;
   cmplx *p1=c, *p2=ch;
 
@@ -896,11 +1470,13 @@ NOINLINE WARN_UNUSED_RESULT static int pass_all(cfftp_plan plan, cmplx c[], doub
       sign>0 ? pass5b (ido, l1, p1, p2, plan->fct[k1].tw)
              : pass5f (ido, l1, p1, p2, plan->fct[k1].tw);
     else if(ip==7)  pass7 (ido, l1, p1, p2, plan->fct[k1].tw, sign);
+    else if(ip==8)  pass8 (ido, l1, p1, p2, plan->fct[k1].tw, sign);
+    else if(ip==16) pass16(ido, l1, p1, p2, plan->fct[k1].tw, sign);
     else if(ip==11) pass11(ido, l1, p1, p2, plan->fct[k1].tw, sign);
     else
       {
       if (passg(ido, ip, l1, p1, p2, plan->fct[k1].tw, plan->fct[k1].tws, sign))
-        { DEALLOC(ch); return -1; }
+        { WDEALLOC(ch); return -1; }
       SWAP(p1,p2,cmplx *);
       }
     SWAP(p1,p2,cmplx *);
@@ -924,10 +1500,186 @@ NOINLINE WARN_UNUSED_RESULT static int pass_all(cfftp_plan plan, cmplx c[], doub
         c[i].r *= fct;
         c[i].i *= fct;
         }
-  DEALLOC(ch);
+  WDEALLOC(ch);
   return 0;
   }
 
+#ifdef PFV_LEN
+/* Vertical passes: PFV_LEN independent transforms interleaved element by
+   element, c[j*PFV_LEN+l] is element j of transform l. Each lane runs the
+   same butterflies as the scalar passes, the twiddles are broadcast. */
+#define PFV_VCC(m)    PFV_LOAD(cc+PFV_LEN*((i)+ido*((m)+cdim*(k))))
+#define PFV_VCH(u,v)  PFV_STORE(ch+PFV_LEN*((i)+ido*((k)+l1*(u))),v)
+#define PFV_VTWB(u,v) PFV_CMUL(PFV_BCAST(&WA(u-1,i)),v)
+#define PFV_VTWF(u,v) PFV_CMULC(PFV_BCAST(&WA(u-1,i)),v)
+#define PFV_PASS4B(LD,ST,TW) PFV_PASS4(LD,ST,TW,PFV_ROT90)
+#define PFV_PASS4F(LD,ST,TW) PFV_PASS4(LD,ST,TW,PFV_ROTM90)
+#define PFV_PASS8B(LD,ST,TW) PFV_PASS8(LD,ST,TW,PFV_ROT90)
+#define PFV_PASS8F(LD,ST,TW) PFV_PASS8(LD,ST,TW,PFV_ROTM90)
+
+#define PFV_VLOOP(PASSB,PASSF) \
+  for (size_t k=0; k<l1; ++k) \
+    { \
+    size_t i=0; \
+    if (sign>0) \
+      { \
+      PASSB(PFV_VCC,PFV_VCH,PFV_TW0) \
+      for (i=1; i<ido; ++i) \
+        PASSB(PFV_VCC,PFV_VCH,PFV_VTWB) \
+      } \
+    else \
+      { \
+      PASSF(PFV_VCC,PFV_VCH,PFV_TW0) \
+      for (i=1; i<ido; ++i) \
+        PASSF(PFV_VCC,PFV_VCH,PFV_VTWF) \
+      } \
+    }
+
+NOINLINE static void passv2 (size_t ido, size_t l1, const cmplx * restrict cc,
+  cmplx * restrict ch, const cmplx * restrict wa, const int sign)
+  {
+  const size_t cdim=2;
+  PFV_VLOOP(PFV_PASS2,PFV_PASS2)
+  }
+
+NOINLINE static void passv3 (size_t ido, size_t l1, const cmplx * restrict cc,
+  cmplx * restrict ch, const cmplx * restrict wa, const int sign)
+  {
+  const size_t cdim=3;
+  const pfreal tw1r=-0.5, tw1i= sign * 0.86602540378443864676;
+  PFV_VLOOP(PFV_PASS3,PFV_PASS3)
+  }
+
+NOINLINE static void passv4 (size_t ido, size_t l1, const cmplx * restrict cc,
+  cmplx * restrict ch, const cmplx * restrict wa, const int sign)
+  {
+  const size_t cdim=4;
+  PFV_VLOOP(PFV_PASS4B,PFV_PASS4F)
+  }
+
+NOINLINE static void passv5 (size_t ido, size_t l1, const cmplx * restrict cc,
+  cmplx * restrict ch, const cmplx * restrict wa, const int sign)
+  {
+  const size_t cdim=5;
+  const pfreal tw1r= 0.3090169943749474241,
+               tw1i= sign * 0.95105651629515357212,
+               tw2r= -0.8090169943749474241,
+               tw2i= sign * 0.58778525229247312917;
+  PFV_VLOOP(PFV_PASS5,PFV_PASS5)
+  }
+
+NOINLINE static void passv7 (size_t ido, size_t l1, const cmplx * restrict cc,
+  cmplx * restrict ch, const cmplx * restrict wa, const int sign)
+  {
+  const size_t cdim=7;
+  const pfreal tw1r= 0.623489801858733530525,
+               tw1i= sign * 0.7818314824680298087084,
+               tw2r= -0.222520933956314404289,
+               tw2i= sign * 0.9749279121818236070181,
+               tw3r= -0.9009688679024191262361,
+               tw3i= sign * 0.4338837391175581204758;
+  PFV_VLOOP(PFV_PASS7,PFV_PASS7)
+  }
+
+NOINLINE static void passv8 (size_t ido, size_t l1, const cmplx * restrict cc,
+  cmplx * restrict ch, const cmplx * restrict wa, const int sign)
+  {
+  const size_t cdim=8;
+  const pfreal hsqt2=0.707106781186547524400844362104849;
+  PFV_VLOOP(PFV_PASS8B,PFV_PASS8F)
+  }
+
+/* Only radices with a vertical pass qualify */
+static int cfftp_has_multi(cfftp_plan plan)
+  {
+  for (size_t k=0; k<plan->nfct; ++k)
+    {
+    size_t ip=plan->fct[k].fct;
+    if (ip!=2 && ip!=3 && ip!=4 && ip!=5 && ip!=7 && ip!=8) return 0;
+    }
+  return 1;
+  }
+
+NOINLINE WARN_UNUSED_RESULT static int pass_all_multi(cfftp_plan plan,
+  cmplx c[], pfreal fct, const int sign)
+  {
+  if (plan->length==1) return 0;
+  size_t len=plan->length*PFV_LEN;
+  size_t l1=1, nf=plan->nfct;
+  cmplx *ch = WALLOC(cmplx, len);
+  if (!ch) return -1;
+  cmplx *p1=c, *p2=ch;
+
+  for(size_t k1=0; k1<nf; k1++)
+    {
+    size_t ip=plan->fct[k1].fct;
+    size_t l2=ip*l1;
+    size_t ido = plan->length/l2;
+    if     (ip==4) passv4 (ido, l1, p1, p2, plan->fct[k1].tw, sign);
+    else if(ip==2) passv2 (ido, l1, p1, p2, plan->fct[k1].tw, sign);
+    else if(ip==3) passv3 (ido, l1, p1, p2, plan->fct[k1].tw, sign);
+    else if(ip==5) passv5 (ido, l1, p1, p2, plan->fct[k1].tw, sign);
+    else if(ip==7) passv7 (ido, l1, p1, p2, plan->fct[k1].tw, sign);
+    else if(ip==8) passv8 (ido, l1, p1, p2, plan->fct[k1].tw, sign);
+    else
+      { WDEALLOC(ch); return -1; }
+    SWAP(p1,p2,cmplx *);
+    l1=l2;
+    }
+  if (p1!=c)
+    {
+    if (fct!=1.)
+      for (size_t i=0; i<len; ++i)
+        {
+        c[i].r = ch[i].r*fct;
+        c[i].i = ch[i].i*fct;
+        }
+    else
+      memcpy (c,p1,len*sizeof(cmplx));
+    }
+  else
+    if (fct!=1.)
+      for (size_t i=0; i<len; ++i)
+        {
+        c[i].r *= fct;
+        c[i].i *= fct;
+        }
+  WDEALLOC(ch);
+  return 0;
+  }
+
+#undef PFV_VLOOP
+#undef PFV_PASS8F
+#undef PFV_PASS8B
+#undef PFV_PASS4F
+#undef PFV_PASS4B
+#undef PFV_VTWF
+#undef PFV_VTWB
+#undef PFV_VCH
+#undef PFV_VCC
+#endif
+
+#ifdef PFV_LEN
+#undef PFV_PASS16
+#undef PFV_ROTW
+#undef PFV_DFT4
+#undef PFV_PASS8
+#undef PFV_PASS7
+#undef PFV_PART7
+#undef PFV_PASS5
+#undef PFV_PART5
+#undef PFV_PASS4
+#undef PFV_PASS3
+#undef PFV_PASS2
+#undef PFV_TW0
+#undef PFV_TWF
+#undef PFV_TWB
+#undef PFV_CH0
+#undef PFV_CH
+#undef PFV_CCS
+#undef PFV_CC
+#endif
+
 #undef PMSIGNC
 #undef A_EQ_B_MUL_C
 #undef A_EQ_CB_MUL_C
@@ -937,17 +1689,18 @@ NOINLINE WARN_UNUSED_RESULT static int pass_all(cfftp_plan plan, cmplx c[], doub
 #undef WA
 #undef CC
 #undef CH
+#undef ROTX90
 #undef ROT90
 #undef SCALEC
 #undef ADDC
 #undef PMC
 
 NOINLINE WARN_UNUSED_RESULT
-static int cfftp_forward(cfftp_plan plan, double c[], double fct)
+static int cfftp_forward(cfftp_plan plan, pfreal c[], pfreal fct)
   { return pass_all(plan,(cmplx *)c, fct, -1); }
 
 NOINLINE WARN_UNUSED_RESULT
-static int cfftp_backward(cfftp_plan plan, double c[], double fct)
+static int cfftp_backward(cfftp_plan plan, pfreal c[], pfreal fct)
   { return pass_all(plan,(cmplx *)c, fct, 1); }
 
 NOINLINE WARN_UNUSED_RESULT
@@ -955,6 +1708,19 @@ static int cfftp_factorize (cfftp_plan plan)
   {
   size_t length=plan->length;
   size_t nfct=0;
+#ifdef PFV_LEN
+  /* from 2048 points the vector passes run at L2 speed, radix 16 saves
+     another pass over memory; its output legs lie length/16 points apart,
+     all in one L1 set when length is a multiple of 4096, so those keep 8 */
+  if (length>=2048 && (length%4096)!=0)
+    while ((length%16)==0)
+      { if (nfct>=NFCT) return -1; plan->fct[nfct++].fct=16; length>>=4; }
+#endif
+  /* radix 8 saves passes over memory once a transform outgrows L1,
+     shorter ones run faster with radix 4 */
+  if (plan->length>=1024)
+    while ((length%8)==0)
+      { if (nfct>=NFCT) return -1; plan->fct[nfct++].fct=8; length>>=3; }
   while ((length%4)==0)
     { if (nfct>=NFCT) return -1; plan->fct[nfct++].fct=4; length>>=2; }
   if ((length%2)==0)
@@ -979,6 +1745,19 @@ static int cfftp_factorize (cfftp_plan plan)
       }
   if (length>1) plan->fct[nfct++].fct=length;
   plan->nfct=nfct;
+#ifdef PFV_LEN
+  /* odd factors go right after the leading 2, so the radix 4 and 8 passes
+     keep power-of-two ido and their vector loops cover whole rows */
+  size_t first=(nfct>0 && plan->fct[0].fct==2) ? 1 : 0;
+  for (size_t k=first; k<nfct; ++k)
+    if (plan->fct[k].fct&1)
+      {
+      size_t odd=plan->fct[k].fct;
+      for (size_t m=k; m>first; --m)
+        plan->fct[m].fct=plan->fct[m-1].fct;
+      plan->fct[first++].fct=odd;
+      }
+#endif
   return 0;
   }
 
@@ -988,7 +1767,7 @@ NOINLINE static size_t cfftp_twsize (cfftp_plan plan)
   for (size_t k=0; k<plan->nfct; ++k)
     {
     size_t ip=plan->fct[k].fct, ido= plan->length/(l1*ip);
-    twsize+=(ip-1)*(ido-1);
+    twsize+=(ip-1)*ido;
     if (ip>11)
       twsize+=ip;
     l1*=ip;
@@ -1008,12 +1787,12 @@ NOINLINE WARN_UNUSED_RESULT static int cfftp_comp_twiddle (cfftp_plan plan)
     {
     size_t ip=plan->fct[k].fct, ido= length/(l1*ip);
     plan->fct[k].tw=plan->mem+memofs;
-    memofs+=(ip-1)*(ido-1);
+    memofs+=(ip-1)*ido;
     for (size_t j=1; j<ip; ++j)
-      for (size_t i=1; i<ido; ++i)
+      for (size_t i=0; i<ido; ++i)
         {
-        plan->fct[k].tw[(j-1)*(ido-1)+i-1].r = twid[2*j*l1*i];
-        plan->fct[k].tw[(j-1)*(ido-1)+i-1].i = twid[2*j*l1*i+1];
+        plan->fct[k].tw[(j-1)*ido+i].r = twid[2*j*l1*i];
+        plan->fct[k].tw[(j-1)*ido+i].i = twid[2*j*l1*i+1];
         }
     if (ip>11)
       {
@@ -1060,13 +1839,13 @@ static void destroy_cfftp_plan (cfftp_plan plan)
 typedef struct rfftp_fctdata
   {
   size_t fct;
-  double *tw, *tws;
+  pfreal *tw, *tws;
   } rfftp_fctdata;
 
 typedef struct rfftp_plan_i
   {
   size_t length, nfct;
-  double *mem;
+  pfreal *mem;
   rfftp_fctdata fct[NFCT];
   } rfftp_plan_i;
 typedef struct rfftp_plan_i * rfftp_plan;
@@ -1079,8 +1858,8 @@ typedef struct rfftp_plan_i * rfftp_plan;
 #define CC(a,b,c) cc[(a)+ido*((b)+l1*(c))]
 #define CH(a,b,c) ch[(a)+ido*((b)+cdim*(c))]
 
-NOINLINE static void radf2 (size_t ido, size_t l1, const double * restrict cc,
-  double * restrict ch, const double * restrict wa)
+NOINLINE static void radf2 (size_t ido, size_t l1, const pfreal * restrict cc,
+  pfreal * restrict ch, const pfreal * restrict wa)
   {
   const size_t cdim=2;
 
@@ -1097,22 +1876,22 @@ NOINLINE static void radf2 (size_t ido, size_t l1, const double * restrict cc,
     for (size_t i=2; i<ido; i+=2)
       {
       size_t ic=ido-i;
-      double tr2, ti2;
+      pfreal tr2, ti2;
       MULPM (tr2,ti2,WA(0,i-2),WA(0,i-1),CC(i-1,k,1),CC(i,k,1))
       PM (CH(i-1,0,k),CH(ic-1,1,k),CC(i-1,k,0),tr2)
       PM (CH(i  ,0,k),CH(ic  ,1,k),ti2,CC(i  ,k,0))
       }
   }
 
-NOINLINE static void radf3(size_t ido, size_t l1, const double * restrict cc,
-  double * restrict ch, const double * restrict wa)
+NOINLINE static void radf3(size_t ido, size_t l1, const pfreal * restrict cc,
+  pfreal * restrict ch, const pfreal * restrict wa)
   {
   const size_t cdim=3;
-  static const double taur=-0.5, taui=0.86602540378443864676;
+  static const pfreal taur=-0.5, taui=0.86602540378443864676;
 
   for (size_t k=0; k<l1; k++)
     {
-    double cr2=CC(0,k,1)+CC(0,k,2);
+    pfreal cr2=CC(0,k,1)+CC(0,k,2);
     CH(0,0,k) = CC(0,k,0)+cr2;
     CH(0,2,k) = taui*(CC(0,k,2)-CC(0,k,1));
     CH(ido-1,1,k) = CC(0,k,0)+taur*cr2;
@@ -1122,31 +1901,31 @@ NOINLINE static void radf3(size_t ido, size_t l1, const double * restrict cc,
     for (size_t i=2; i<ido; i+=2)
       {
       size_t ic=ido-i;
-      double di2, di3, dr2, dr3;
+      pfreal di2, di3, dr2, dr3;
       MULPM (dr2,di2,WA(0,i-2),WA(0,i-1),CC(i-1,k,1),CC(i,k,1)) // d2=conj(WA0)*CC1
       MULPM (dr3,di3,WA(1,i-2),WA(1,i-1),CC(i-1,k,2),CC(i,k,2)) // d3=conj(WA1)*CC2
-      double cr2=dr2+dr3; // c add
-      double ci2=di2+di3;
+      pfreal cr2=dr2+dr3; // c add
+      pfreal ci2=di2+di3;
       CH(i-1,0,k) = CC(i-1,k,0)+cr2; // c add
       CH(i  ,0,k) = CC(i  ,k,0)+ci2;
-      double tr2 = CC(i-1,k,0)+taur*cr2; // c add
-      double ti2 = CC(i  ,k,0)+taur*ci2;
-      double tr3 = taui*(di2-di3);  // t3 = taui*i*(d3-d2)?
-      double ti3 = taui*(dr3-dr2);
+      pfreal tr2 = CC(i-1,k,0)+taur*cr2; // c add
+      pfreal ti2 = CC(i  ,k,0)+taur*ci2;
+      pfreal tr3 = taui*(di2-di3);  // t3 = taui*i*(d3-d2)?
+      pfreal ti3 = taui*(dr3-dr2);
       PM(CH(i-1,2,k),CH(ic-1,1,k),tr2,tr3) // PM(i) = t2+t3
       PM(CH(i  ,2,k),CH(ic  ,1,k),ti3,ti2) // PM(ic) = conj(t2-t3)
       }
   }
 
-NOINLINE static void radf4(size_t ido, size_t l1, const double * restrict cc,
-  double * restrict ch, const double * restrict wa)
+NOINLINE static void radf4(size_t ido, size_t l1, const pfreal * restrict cc,
+  pfreal * restrict ch, const pfreal * restrict wa)
   {
   const size_t cdim=4;
-  static const double hsqt2=0.70710678118654752440;
+  static const pfreal hsqt2=0.70710678118654752440;
 
   for (size_t k=0; k<l1; k++)
     {
-    double tr1,tr2;
+    pfreal tr1,tr2;
     PM (tr1,CH(0,2,k),CC(0,k,3),CC(0,k,1))
     PM (tr2,CH(ido-1,1,k),CC(0,k,0),CC(0,k,2))
     PM (CH(0,0,k),CH(ido-1,3,k),tr2,tr1)
@@ -1154,8 +1933,8 @@ NOINLINE static void radf4(size_t ido, size_t l1, const double * restrict cc,
   if ((ido&1)==0)
     for (size_t k=0; k<l1; k++)
       {
-      double ti1=-hsqt2*(CC(ido-1,k,1)+CC(ido-1,k,3));
-      double tr1= hsqt2*(CC(ido-1,k,1)-CC(ido-1,k,3));
+      pfreal ti1=-hsqt2*(CC(ido-1,k,1)+CC(ido-1,k,3));
+      pfreal tr1= hsqt2*(CC(ido-1,k,1)-CC(ido-1,k,3));
       PM (CH(ido-1,0,k),CH(ido-1,2,k),CC(ido-1,k,0),tr1)
       PM (CH(    0,3,k),CH(    0,1,k),ti1,CC(ido-1,k,2))
       }
@@ -1164,7 +1943,7 @@ NOINLINE static void radf4(size_t ido, size_t l1, const double * restrict cc,
     for (size_t i=2; i<ido; i+=2)
       {
       size_t ic=ido-i;
-      double ci2, ci3, ci4, cr2, cr3, cr4, ti1, ti2, ti3, ti4, tr1, tr2, tr3, tr4;
+      pfreal ci2, ci3, ci4, cr2, cr3, cr4, ti1, ti2, ti3, ti4, tr1, tr2, tr3, tr4;
       MULPM(cr2,ci2,WA(0,i-2),WA(0,i-1),CC(i-1,k,1),CC(i,k,1))
       MULPM(cr3,ci3,WA(1,i-2),WA(1,i-1),CC(i-1,k,2),CC(i,k,2))
       MULPM(cr4,ci4,WA(2,i-2),WA(2,i-1),CC(i-1,k,3),CC(i,k,3))
@@ -1179,16 +1958,16 @@ NOINLINE static void radf4(size_t ido, size_t l1, const double * restrict cc,
       }
   }
 
-NOINLINE static void radf5(size_t ido, size_t l1, const double * restrict cc,
-  double * restrict ch, const double * restrict wa)
+NOINLINE static void radf5(size_t ido, size_t l1, const pfreal * restrict cc,
+  pfreal * restrict ch, const pfreal * restrict wa)
   {
   const size_t cdim=5;
-  static const double tr11= 0.3090169943749474241, ti11=0.95105651629515357212,
+  static const pfreal tr11= 0.3090169943749474241, ti11=0.95105651629515357212,
                       tr12=-0.8090169943749474241, ti12=0.58778525229247312917;
 
   for (size_t k=0; k<l1; k++)
     {
-    double cr2, cr3, ci4, ci5;
+    pfreal cr2, cr3, ci4, ci5;
     PM (cr2,ci5,CC(0,k,4),CC(0,k,1))
     PM (cr3,ci4,CC(0,k,3),CC(0,k,2))
     CH(0,0,k)=CC(0,k,0)+cr2+cr3;
@@ -1201,7 +1980,7 @@ NOINLINE static void radf5(size_t ido, size_t l1, const double * restrict cc,
   for (size_t k=0; k<l1;++k)
     for (size_t i=2; i<ido; i+=2)
       {
-      double ci2, di2, ci4, ci5, di3, di4, di5, ci3, cr2, cr3, dr2, dr3,
+      pfreal ci2, di2, ci4, ci5, di3, di4, di5, ci3, cr2, cr3, dr2, dr3,
          dr4, dr5, cr5, cr4, ti2, ti3, ti5, ti4, tr2, tr3, tr4, tr5;
       size_t ic=ido-i;
       MULPM (dr2,di2,WA(0,i-2),WA(0,i-1),CC(i-1,k,1),CC(i,k,1))
@@ -1235,8 +2014,8 @@ NOINLINE static void radf5(size_t ido, size_t l1, const double * restrict cc,
 #define CC(a,b,c) cc[(a)+ido*((b)+cdim*(c))]
 #define CH(a,b,c) ch[(a)+ido*((b)+l1*(c))]
 NOINLINE static void radfg(size_t ido, size_t ip, size_t l1,
-  double * restrict cc, double * restrict ch, const double * restrict wa,
-  const double * restrict csarr)
+  pfreal * restrict cc, pfreal * restrict ch, const pfreal * restrict wa,
+  const pfreal * restrict csarr)
   {
   const size_t cdim=ip;
   size_t ipph=(ip+1)/2;
@@ -1254,9 +2033,9 @@ NOINLINE static void radfg(size_t ido, size_t ip, size_t l1,
         size_t idij2=is2;
         for (size_t i=1; i<=ido-2; i+=2)                      // 112
           {
-          double t1=C1(i,k,j ), t2=C1(i+1,k,j ),
+          pfreal t1=C1(i,k,j ), t2=C1(i+1,k,j ),
                  t3=C1(i,k,jc), t4=C1(i+1,k,jc);
-          double x1=wa[idij]*t1 + wa[idij+1]*t2,
+          pfreal x1=wa[idij]*t1 + wa[idij+1]*t2,
                  x2=wa[idij]*t2 - wa[idij+1]*t1,
                  x3=wa[idij2]*t3 + wa[idij2+1]*t4,
                  x4=wa[idij2]*t4 - wa[idij2+1]*t3;
@@ -1274,13 +2053,13 @@ NOINLINE static void radfg(size_t ido, size_t ip, size_t l1,
   for (size_t j=1, jc=ip-1; j<ipph; ++j,--jc)                // 123
     for (size_t k=0; k<l1; ++k)                              // 122
       {
-      double t1=C1(0,k,j), t2=C1(0,k,jc);
+      pfreal t1=C1(0,k,j), t2=C1(0,k,jc);
       C1(0,k,j ) = t1+t2;
       C1(0,k,jc) = t2-t1;
       }
 
 //everything in C
-//memset(ch,0,ip*l1*ido*sizeof(double));
+//memset(ch,0,ip*l1*ido*sizeof(pfreal));
 
   for (size_t l=1,lc=ip-1; l<ipph; ++l,--lc)                 // 127
     {
@@ -1294,13 +2073,13 @@ NOINLINE static void radfg(size_t ido, size_t ip, size_t l1,
     for (; j<ipph-3; j+=4,jc-=4)              // 126
       {
       iang+=l; if (iang>=ip) iang-=ip;
-      double ar1=csarr[2*iang], ai1=csarr[2*iang+1];
+      pfreal ar1=csarr[2*iang], ai1=csarr[2*iang+1];
       iang+=l; if (iang>=ip) iang-=ip;
-      double ar2=csarr[2*iang], ai2=csarr[2*iang+1];
+      pfreal ar2=csarr[2*iang], ai2=csarr[2*iang+1];
       iang+=l; if (iang>=ip) iang-=ip;
-      double ar3=csarr[2*iang], ai3=csarr[2*iang+1];
+      pfreal ar3=csarr[2*iang], ai3=csarr[2*iang+1];
       iang+=l; if (iang>=ip) iang-=ip;
-      double ar4=csarr[2*iang], ai4=csarr[2*iang+1];
+      pfreal ar4=csarr[2*iang], ai4=csarr[2*iang+1];
       for (size_t ik=0; ik<idl1; ++ik)                       // 125
         {
         CH2(ik,l ) += ar1*C2(ik,j )+ar2*C2(ik,j +1)
@@ -1312,9 +2091,9 @@ NOINLINE static void radfg(size_t ido, size_t ip, size_t l1,
     for (; j<ipph-1; j+=2,jc-=2)              // 126
       {
       iang+=l; if (iang>=ip) iang-=ip;
-      double ar1=csarr[2*iang], ai1=csarr[2*iang+1];
+      pfreal ar1=csarr[2*iang], ai1=csarr[2*iang+1];
       iang+=l; if (iang>=ip) iang-=ip;
-      double ar2=csarr[2*iang], ai2=csarr[2*iang+1];
+      pfreal ar2=csarr[2*iang], ai2=csarr[2*iang+1];
       for (size_t ik=0; ik<idl1; ++ik)                       // 125
         {
         CH2(ik,l ) += ar1*C2(ik,j )+ar2*C2(ik,j +1);
@@ -1324,7 +2103,7 @@ NOINLINE static void radfg(size_t ido, size_t ip, size_t l1,
     for (; j<ipph; ++j,--jc)              // 126
       {
       iang+=l; if (iang>=ip) iang-=ip;
-      double ar=csarr[2*iang], ai=csarr[2*iang+1];
+      pfreal ar=csarr[2*iang], ai=csarr[2*iang+1];
       for (size_t ik=0; ik<idl1; ++ik)                       // 125
         {
         CH2(ik,l ) += ar*C2(ik,j );
@@ -1339,7 +2118,7 @@ NOINLINE static void radfg(size_t ido, size_t ip, size_t l1,
       CH2(ik,0) += C2(ik,j);
 
 // everything in CH at this point!
-//memset(cc,0,ip*l1*ido*sizeof(double));
+//memset(cc,0,ip*l1*ido*sizeof(pfreal));
 
   for (size_t k=0; k<l1; ++k)                                // 131
     for (size_t i=0; i<ido; ++i)                             // 130
@@ -1379,8 +2158,8 @@ NOINLINE static void radfg(size_t ido, size_t ip, size_t l1,
 #define CH(a,b,c) ch[(a)+ido*((b)+l1*(c))]
 #define CC(a,b,c) cc[(a)+ido*((b)+cdim*(c))]
 
-NOINLINE static void radb2(size_t ido, size_t l1, const double * restrict cc,
-  double * restrict ch, const double * restrict wa)
+NOINLINE static void radb2(size_t ido, size_t l1, const pfreal * restrict cc,
+  pfreal * restrict ch, const pfreal * restrict wa)
   {
   const size_t cdim=2;
 
@@ -1397,25 +2176,25 @@ NOINLINE static void radb2(size_t ido, size_t l1, const double * restrict cc,
     for (size_t i=2; i<ido; i+=2)
       {
       size_t ic=ido-i;
-      double ti2, tr2;
+      pfreal ti2, tr2;
       PM (CH(i-1,k,0),tr2,CC(i-1,0,k),CC(ic-1,1,k))
       PM (ti2,CH(i  ,k,0),CC(i  ,0,k),CC(ic  ,1,k))
       MULPM (CH(i,k,1),CH(i-1,k,1),WA(0,i-2),WA(0,i-1),ti2,tr2)
       }
   }
 
-NOINLINE static void radb3(size_t ido, size_t l1, const double * restrict cc,
-  double * restrict ch, const double * restrict wa)
+NOINLINE static void radb3(size_t ido, size_t l1, const pfreal * restrict cc,
+  pfreal * restrict ch, const pfreal * restrict wa)
   {
   const size_t cdim=3;
-  static const double taur=-0.5, taui=0.86602540378443864676;
+  static const pfreal taur=-0.5, taui=0.86602540378443864676;
 
   for (size_t k=0; k<l1; k++)
     {
-    double tr2=2.*CC(ido-1,1,k);
-    double cr2=CC(0,0,k)+taur*tr2;
+    pfreal tr2=2.*CC(ido-1,1,k);
+    pfreal cr2=CC(0,0,k)+taur*tr2;
     CH(0,k,0)=CC(0,0,k)+tr2;
-    double ci3=2.*taui*CC(0,2,k);
+    pfreal ci3=2.*taui*CC(0,2,k);
     PM (CH(0,k,2),CH(0,k,1),cr2,ci3);
     }
   if (ido==1) return;
@@ -1423,15 +2202,15 @@ NOINLINE static void radb3(size_t ido, size_t l1, const double * restrict cc,
     for (size_t i=2; i<ido; i+=2)
       {
       size_t ic=ido-i;
-      double tr2=CC(i-1,2,k)+CC(ic-1,1,k); // t2=CC(I) + conj(CC(ic))
-      double ti2=CC(i  ,2,k)-CC(ic  ,1,k);
-      double cr2=CC(i-1,0,k)+taur*tr2;     // c2=CC +taur*t2
-      double ci2=CC(i  ,0,k)+taur*ti2;
+      pfreal tr2=CC(i-1,2,k)+CC(ic-1,1,k); // t2=CC(I) + conj(CC(ic))
+      pfreal ti2=CC(i  ,2,k)-CC(ic  ,1,k);
+      pfreal cr2=CC(i-1,0,k)+taur*tr2;     // c2=CC +taur*t2
+      pfreal ci2=CC(i  ,0,k)+taur*ti2;
       CH(i-1,k,0)=CC(i-1,0,k)+tr2;         // CH=CC+t2
       CH(i  ,k,0)=CC(i  ,0,k)+ti2;
-      double cr3=taui*(CC(i-1,2,k)-CC(ic-1,1,k));// c3=taui*(CC(i)-conj(CC(ic)))
-      double ci3=taui*(CC(i  ,2,k)+CC(ic  ,1,k));
-      double di2, di3, dr2, dr3;
+      pfreal cr3=taui*(CC(i-1,2,k)-CC(ic-1,1,k));// c3=taui*(CC(i)-conj(CC(ic)))
+      pfreal ci3=taui*(CC(i  ,2,k)+CC(ic  ,1,k));
+      pfreal di2, di3, dr2, dr3;
       PM(dr3,dr2,cr2,ci3) // d2= (cr2-ci3, ci2+cr3) = c2+i*c3
       PM(di2,di3,ci2,cr3) // d3= (cr2+ci3, ci2-cr3) = c2-i*c3
       MULPM(CH(i,k,1),CH(i-1,k,1),WA(0,i-2),WA(0,i-1),di2,dr2) // ch = WA*d2
@@ -1439,25 +2218,25 @@ NOINLINE static void radb3(size_t ido, size_t l1, const double * restrict cc,
       }
   }
 
-NOINLINE static void radb4(size_t ido, size_t l1, const double * restrict cc,
-  double * restrict ch, const double * restrict wa)
+NOINLINE static void radb4(size_t ido, size_t l1, const pfreal * restrict cc,
+  pfreal * restrict ch, const pfreal * restrict wa)
   {
   const size_t cdim=4;
-  static const double sqrt2=1.41421356237309504880;
+  static const pfreal sqrt2=1.41421356237309504880;
 
   for (size_t k=0; k<l1; k++)
     {
-    double tr1, tr2;
+    pfreal tr1, tr2;
     PM (tr2,tr1,CC(0,0,k),CC(ido-1,3,k))
-    double tr3=2.*CC(ido-1,1,k);
-    double tr4=2.*CC(0,2,k);
+    pfreal tr3=2.*CC(ido-1,1,k);
+    pfreal tr4=2.*CC(0,2,k);
     PM (CH(0,k,0),CH(0,k,2),tr2,tr3)
     PM (CH(0,k,3),CH(0,k,1),tr1,tr4)
     }
   if ((ido&1)==0)
     for (size_t k=0; k<l1; k++)
       {
-      double tr1,tr2,ti1,ti2;
+      pfreal tr1,tr2,ti1,ti2;
       PM (ti1,ti2,CC(0    ,3,k),CC(0    ,1,k))
       PM (tr2,tr1,CC(ido-1,0,k),CC(ido-1,2,k))
       CH(ido-1,k,0)=tr2+tr2;
@@ -1469,7 +2248,7 @@ NOINLINE static void radb4(size_t ido, size_t l1, const double * restrict cc,
   for (size_t k=0; k<l1;++k)
     for (size_t i=2; i<ido; i+=2)
       {
-      double ci2, ci3, ci4, cr2, cr3, cr4, ti1, ti2, ti3, ti4, tr1, tr2, tr3, tr4;
+      pfreal ci2, ci3, ci4, cr2, cr3, cr4, ti1, ti2, ti3, ti4, tr1, tr2, tr3, tr4;
       size_t ic=ido-i;
       PM (tr2,tr1,CC(i-1,0,k),CC(ic-1,3,k))
       PM (ti1,ti2,CC(i  ,0,k),CC(ic  ,3,k))
@@ -1485,23 +2264,23 @@ NOINLINE static void radb4(size_t ido, size_t l1, const double * restrict cc,
       }
   }
 
-NOINLINE static void radb5(size_t ido, size_t l1, const double * restrict cc,
-  double * restrict ch, const double * restrict wa)
+NOINLINE static void radb5(size_t ido, size_t l1, const pfreal * restrict cc,
+  pfreal * restrict ch, const pfreal * restrict wa)
   {
   const size_t cdim=5;
-  static const double tr11= 0.3090169943749474241, ti11=0.95105651629515357212,
+  static const pfreal tr11= 0.3090169943749474241, ti11=0.95105651629515357212,
                       tr12=-0.8090169943749474241, ti12=0.58778525229247312917;
 
   for (size_t k=0; k<l1; k++)
     {
-    double ti5=CC(0,2,k)+CC(0,2,k);
-    double ti4=CC(0,4,k)+CC(0,4,k);
-    double tr2=CC(ido-1,1,k)+CC(ido-1,1,k);
-    double tr3=CC(ido-1,3,k)+CC(ido-1,3,k);
+    pfreal ti5=CC(0,2,k)+CC(0,2,k);
+    pfreal ti4=CC(0,4,k)+CC(0,4,k);
+    pfreal tr2=CC(ido-1,1,k)+CC(ido-1,1,k);
+    pfreal tr3=CC(ido-1,3,k)+CC(ido-1,3,k);
     CH(0,k,0)=CC(0,0,k)+tr2+tr3;
-    double cr2=CC(0,0,k)+tr11*tr2+tr12*tr3;
-    double cr3=CC(0,0,k)+tr12*tr2+tr11*tr3;
-    double ci4, ci5;
+    pfreal cr2=CC(0,0,k)+tr11*tr2+tr12*tr3;
+    pfreal cr3=CC(0,0,k)+tr12*tr2+tr11*tr3;
+    pfreal ci4, ci5;
     MULPM(ci5,ci4,ti5,ti4,ti11,ti12)
     PM(CH(0,k,4),CH(0,k,1),cr2,ci5)
     PM(CH(0,k,3),CH(0,k,2),cr3,ci4)
@@ -1511,21 +2290,21 @@ NOINLINE static void radb5(size_t ido, size_t l1, const double * restrict cc,
     for (size_t i=2; i<ido; i+=2)
       {
       size_t ic=ido-i;
-      double tr2, tr3, tr4, tr5, ti2, ti3, ti4, ti5;
+      pfreal tr2, tr3, tr4, tr5, ti2, ti3, ti4, ti5;
       PM(tr2,tr5,CC(i-1,2,k),CC(ic-1,1,k))
       PM(ti5,ti2,CC(i  ,2,k),CC(ic  ,1,k))
       PM(tr3,tr4,CC(i-1,4,k),CC(ic-1,3,k))
       PM(ti4,ti3,CC(i  ,4,k),CC(ic  ,3,k))
       CH(i-1,k,0)=CC(i-1,0,k)+tr2+tr3;
       CH(i  ,k,0)=CC(i  ,0,k)+ti2+ti3;
-      double cr2=CC(i-1,0,k)+tr11*tr2+tr12*tr3;
-      double ci2=CC(i  ,0,k)+tr11*ti2+tr12*ti3;
-      double cr3=CC(i-1,0,k)+tr12*tr2+tr11*tr3;
-      double ci3=CC(i  ,0,k)+tr12*ti2+tr11*ti3;
-      double ci4, ci5, cr5, cr4;
+      pfreal cr2=CC(i-1,0,k)+tr11*tr2+tr12*tr3;
+      pfreal ci2=CC(i  ,0,k)+tr11*ti2+tr12*ti3;
+      pfreal cr3=CC(i-1,0,k)+tr12*tr2+tr11*tr3;
+      pfreal ci3=CC(i  ,0,k)+tr12*ti2+tr11*ti3;
+      pfreal ci4, ci5, cr5, cr4;
       MULPM(cr5,cr4,tr5,tr4,ti11,ti12)
       MULPM(ci5,ci4,ti5,ti4,ti11,ti12)
-      double dr2, dr3, dr4, dr5, di2, di3, di4, di5;
+      pfreal dr2, dr3, dr4, dr5, di2, di3, di4, di5;
       PM(dr4,dr3,cr3,ci4)
       PM(di3,di4,ci3,cr4)
       PM(dr5,dr2,cr2,ci5)
@@ -1546,8 +2325,8 @@ NOINLINE static void radb5(size_t ido, size_t l1, const double * restrict cc,
 #define CH2(a,b) ch[(a)+idl1*(b)]
 
 NOINLINE static void radbg(size_t ido, size_t ip, size_t l1,
-  double * restrict cc, double * restrict ch, const double * restrict wa,
-  const double * restrict csarr)
+  pfreal * restrict cc, pfreal * restrict ch, const pfreal * restrict wa,
+  const pfreal * restrict csarr)
   {
   const size_t cdim=ip;
   size_t ipph=(ip+1)/ 2;
@@ -1593,13 +2372,13 @@ NOINLINE static void radbg(size_t ido, size_t ip, size_t l1,
     for(; j<ipph-3; j+=4,jc-=4)
       {
       iang+=l; if(iang>ip) iang-=ip;
-      double ar1=csarr[2*iang], ai1=csarr[2*iang+1];
+      pfreal ar1=csarr[2*iang], ai1=csarr[2*iang+1];
       iang+=l; if(iang>ip) iang-=ip;
-      double ar2=csarr[2*iang], ai2=csarr[2*iang+1];
+      pfreal ar2=csarr[2*iang], ai2=csarr[2*iang+1];
       iang+=l; if(iang>ip) iang-=ip;
-      double ar3=csarr[2*iang], ai3=csarr[2*iang+1];
+      pfreal ar3=csarr[2*iang], ai3=csarr[2*iang+1];
       iang+=l; if(iang>ip) iang-=ip;
-      double ar4=csarr[2*iang], ai4=csarr[2*iang+1];
+      pfreal ar4=csarr[2*iang], ai4=csarr[2*iang+1];
       for (size_t ik=0; ik<idl1; ++ik)
         {
         C2(ik,l ) += ar1*CH2(ik,j )+ar2*CH2(ik,j +1)
@@ -1611,9 +2390,9 @@ NOINLINE static void radbg(size_t ido, size_t ip, size_t l1,
     for(; j<ipph-1; j+=2,jc-=2)
       {
       iang+=l; if(iang>ip) iang-=ip;
-      double ar1=csarr[2*iang], ai1=csarr[2*iang+1];
+      pfreal ar1=csarr[2*iang], ai1=csarr[2*iang+1];
       iang+=l; if(iang>ip) iang-=ip;
-      double ar2=csarr[2*iang], ai2=csarr[2*iang+1];
+      pfreal ar2=csarr[2*iang], ai2=csarr[2*iang+1];
       for (size_t ik=0; ik<idl1; ++ik)
         {
         C2(ik,l ) += ar1*CH2(ik,j )+ar2*CH2(ik,j +1);
@@ -1623,7 +2402,7 @@ NOINLINE static void radbg(size_t ido, size_t ip, size_t l1,
     for(; j<ipph; ++j,--jc)
       {
       iang+=l; if(iang>ip) iang-=ip;
-      double war=csarr[2*iang], wai=csarr[2*iang+1];
+      pfreal war=csarr[2*iang], wai=csarr[2*iang+1];
       for (size_t ik=0; ik<idl1; ++ik)
         {
         C2(ik,l ) += war*CH2(ik,j );
@@ -1663,7 +2442,7 @@ NOINLINE static void radbg(size_t ido, size_t ip, size_t l1,
       size_t idij = is;
       for (size_t i=1; i<=ido-2; i+=2)
         {
-        double t1=CH(i,k,j), t2=CH(i+1,k,j);
+        pfreal t1=CH(i,k,j), t2=CH(i+1,k,j);
         CH(i  ,k,j) = wa[idij]*t1-wa[idij+1]*t2;
         CH(i+1,k,j) = wa[idij]*t2+wa[idij+1]*t1;
         idij+=2;
@@ -1681,7 +2460,7 @@ NOINLINE static void radbg(size_t ido, size_t ip, size_t l1,
 #undef MULPM
 #undef WA
 
-static void copy_and_norm(double *c, double *p1, size_t n, double fct)
+static void copy_and_norm(pfreal *c, pfreal *p1, size_t n, pfreal fct)
   {
   if (p1!=c)
     {
@@ -1689,7 +2468,7 @@ static void copy_and_norm(double *c, double *p1, size_t n, double fct)
       for (size_t i=0; i<n; ++i)
         c[i] = fct*p1[i];
     else
-      memcpy (c,p1,n*sizeof(double));
+      memcpy (c,p1,n*sizeof(pfreal));
     }
   else
     if (fct!=1.)
@@ -1698,14 +2477,14 @@ static void copy_and_norm(double *c, double *p1, size_t n, double fct)
   }
 
 WARN_UNUSED_RESULT
-static int rfftp_forward(rfftp_plan plan, double c[], double fct)
+static int rfftp_forward(rfftp_plan plan, pfreal c[], pfreal fct)
   {
   if (plan->length==1) return 0;
   size_t n=plan->length;
   size_t l1=n, nf=plan->nfct;
-  double *ch = RALLOC(double, n);
+  pfreal *ch = WALLOC(pfreal, n);
   if (!ch) return -1;
-  double *p1=c, *p2=ch;
+  pfreal *p1=c, *p2=ch;
 
   for(size_t k1=0; k1<nf;++k1)
     {
@@ -1724,24 +2503,24 @@ static int rfftp_forward(rfftp_plan plan, double c[], double fct)
     else
       {
       radfg(ido, ip, l1, p1, p2, plan->fct[k].tw, plan->fct[k].tws);
-      SWAP (p1,p2,double *);
+      SWAP (p1,p2,pfreal *);
       }
-    SWAP (p1,p2,double *);
+    SWAP (p1,p2,pfreal *);
     }
   copy_and_norm(c,p1,n,fct);
-  DEALLOC(ch);
+  WDEALLOC(ch);
   return 0;
   }
 
 WARN_UNUSED_RESULT
-static int rfftp_backward(rfftp_plan plan, double c[], double fct)
+static int rfftp_backward(rfftp_plan plan, pfreal c[], pfreal fct)
   {
   if (plan->length==1) return 0;
   size_t n=plan->length;
   size_t l1=1, nf=plan->nfct;
-  double *ch = RALLOC(double, n);
+  pfreal *ch = WALLOC(pfreal, n);
   if (!ch) return -1;
-  double *p1=c, *p2=ch;
+  pfreal *p1=c, *p2=ch;
 
   for(size_t k=0; k<nf; k++)
     {
@@ -1757,11 +2536,11 @@ static int rfftp_backward(rfftp_plan plan, double c[], double fct)
       radb5(ido, l1, p1, p2, plan->fct[k].tw);
     else
       radbg(ido, ip, l1, p1, p2, plan->fct[k].tw, plan->fct[k].tws);
-    SWAP (p1,p2,double *);
+    SWAP (p1,p2,pfreal *);
     l1*=ip;
     }
   copy_and_norm(c,p1,n,fct);
-  DEALLOC(ch);
+  WDEALLOC(ch);
   return 0;
   }
 
@@ -1818,7 +2597,7 @@ WARN_UNUSED_RESULT NOINLINE static int rfftp_comp_twiddle (rfftp_plan plan)
   if (!twid) return -1;
   sincos_2pibyn_half(length, twid);
   size_t l1=1;
-  double *ptr=plan->mem;
+  pfreal *ptr=plan->mem;
   for (size_t k=0; k<plan->nfct; ++k)
     {
     size_t ip=plan->fct[k].fct, ido=length/(l1*ip);
@@ -1864,7 +2643,7 @@ NOINLINE static rfftp_plan make_rfftp_plan (size_t length)
   if (length==1) return plan;
   if (rfftp_factorize(plan)!=0) { DEALLOC(plan); return NULL; }
   size_t tws=rfftp_twsize(plan);
-  plan->mem=RALLOC(double,tws);
+  plan->mem=RALLOC(pfreal,tws);
   if (!plan->mem) { DEALLOC(plan); return NULL; }
   if (rfftp_comp_twiddle(plan)!=0)
     { DEALLOC(plan->mem); DEALLOC(plan); return NULL; }
@@ -1881,8 +2660,8 @@ typedef struct fftblue_plan_i
   {
   size_t n, n2;
   cfftp_plan plan;
-  double *mem;
-  double *bk, *bkf;
+  pfreal *mem;
+  pfreal *bk, *bkf;
   } fftblue_plan_i;
 typedef struct fftblue_plan_i * fftblue_plan;
 
@@ -1892,7 +2671,7 @@ NOINLINE static fftblue_plan make_fftblue_plan (size_t length)
   if (!plan) return NULL;
   plan->n = length;
   plan->n2 = good_size(plan->n*2-1);
-  plan->mem = RALLOC(double, 2*plan->n+2*plan->n2);
+  plan->mem = RALLOC(pfreal, 2*plan->n+2*plan->n2);
   if (!plan->mem) { DEALLOC(plan); return NULL; }
   plan->bk  = plan->mem;
   plan->bkf = plan->bk+2*plan->n;
@@ -1942,13 +2721,13 @@ NOINLINE static void destroy_fftblue_plan (fftblue_plan plan)
   }
 
 NOINLINE WARN_UNUSED_RESULT
-static int fftblue_fft(fftblue_plan plan, double c[], int isign, double fct)
+static int fftblue_fft(fftblue_plan plan, pfreal c[], int isign, pfreal fct)
   {
   size_t n=plan->n;
   size_t n2=plan->n2;
-  double *bk  = plan->bk;
-  double *bkf = plan->bkf;
-  double *akf = RALLOC(double, 2*n2);
+  pfreal *bk  = plan->bk;
+  pfreal *bkf = plan->bkf;
+  pfreal *akf = WALLOC(pfreal, 2*n2);
   if (!akf) return -1;
 
 /* initialize a_k and FFT it */
@@ -1968,27 +2747,27 @@ static int fftblue_fft(fftblue_plan plan, double c[], int isign, double fct)
     akf[m]=0;
 
   if (cfftp_forward (plan->plan,akf,fct)!=0)
-    { DEALLOC(akf); return -1; }
+    { WDEALLOC(akf); return -1; }
 
 /* do the convolution */
   if (isign>0)
     for (size_t m=0; m<2*n2; m+=2)
       {
-      double im = -akf[m]*bkf[m+1] + akf[m+1]*bkf[m];
+      pfreal im = -akf[m]*bkf[m+1] + akf[m+1]*bkf[m];
       akf[m  ]  =  akf[m]*bkf[m]   + akf[m+1]*bkf[m+1];
       akf[m+1]  = im;
       }
   else
     for (size_t m=0; m<2*n2; m+=2)
       {
-      double im = akf[m]*bkf[m+1] + akf[m+1]*bkf[m];
+      pfreal im = akf[m]*bkf[m+1] + akf[m+1]*bkf[m];
       akf[m  ]  = akf[m]*bkf[m]   - akf[m+1]*bkf[m+1];
       akf[m+1]  = im;
       }
 
 /* inverse FFT */
   if (cfftp_backward (plan->plan,akf,1.)!=0)
-    { DEALLOC(akf); return -1; }
+    { WDEALLOC(akf); return -1; }
 
 /* multiply by b_k */
   if (isign>0)
@@ -2003,27 +2782,27 @@ static int fftblue_fft(fftblue_plan plan, double c[], int isign, double fct)
       c[m]   = bk[m]  *akf[m] + bk[m+1]*akf[m+1];
       c[m+1] =-bk[m+1]*akf[m] + bk[m]  *akf[m+1];
       }
-  DEALLOC(akf);
+  WDEALLOC(akf);
   return 0;
   }
 
 WARN_UNUSED_RESULT
-static int cfftblue_backward(fftblue_plan plan, double c[], double fct)
+static int cfftblue_backward(fftblue_plan plan, pfreal c[], pfreal fct)
   { return fftblue_fft(plan,c,1,fct); }
 
 WARN_UNUSED_RESULT
-static int cfftblue_forward(fftblue_plan plan, double c[], double fct)
+static int cfftblue_forward(fftblue_plan plan, pfreal c[], pfreal fct)
   { return fftblue_fft(plan,c,-1,fct); }
 
 WARN_UNUSED_RESULT
-static int rfftblue_backward(fftblue_plan plan, double c[], double fct)
+static int rfftblue_backward(fftblue_plan plan, pfreal c[], pfreal fct)
   {
   size_t n=plan->n;
-  double *tmp = RALLOC(double,2*n);
+  pfreal *tmp = WALLOC(pfreal,2*n);
   if (!tmp) return -1;
   tmp[0]=c[0];
   tmp[1]=0.;
-  memcpy (tmp+2,c+1, (n-1)*sizeof(double));
+  memcpy (tmp+2,c+1, (n-1)*sizeof(pfreal));
   if ((n&1)==0) tmp[n+1]=0.;
   for (size_t m=2; m<n; m+=2)
     {
@@ -2031,18 +2810,18 @@ static int rfftblue_backward(fftblue_plan plan, double c[], double fct)
     tmp[2*n-m+1]=-tmp[m+1];
     }
   if (fftblue_fft(plan,tmp,1,fct)!=0)
-    { DEALLOC(tmp); return -1; }
+    { WDEALLOC(tmp); return -1; }
   for (size_t m=0; m<n; ++m)
     c[m] = tmp[2*m];
-  DEALLOC(tmp);
+  WDEALLOC(tmp);
   return 0;
   }
 
 WARN_UNUSED_RESULT
-static int rfftblue_forward(fftblue_plan plan, double c[], double fct)
+static int rfftblue_forward(fftblue_plan plan, pfreal c[], pfreal fct)
   {
   size_t n=plan->n;
-  double *tmp = RALLOC(double,2*n);
+  pfreal *tmp = WALLOC(pfreal,2*n);
   if (!tmp) return -1;
   for (size_t m=0; m<n; ++m)
     {
@@ -2050,10 +2829,195 @@ static int rfftblue_forward(fftblue_plan plan, double c[], double fct)
     tmp[2*m+1] = 0.;
     }
   if (fftblue_fft(plan,tmp,-1,fct)!=0)
-    { DEALLOC(tmp); return -1; }
+    { WDEALLOC(tmp); return -1; }
   c[0] = tmp[0];
-  memcpy (c+1, tmp+2, (n-1)*sizeof(double));
+  memcpy (c+1, tmp+2, (n-1)*sizeof(pfreal));
+  WDEALLOC(tmp);
+  return 0;
+  }
+
+/* Rader's algorithm for prime lengths: reindexing by powers of a generator g
+   turns the DFT over the nonzero indices into a cyclic convolution of
+   length n-1, taken through a plan of that length. This beats Bluestein
+   whenever n-1 factors well, Bluestein needs a padded length >= 2n-1. */
+typedef struct fftrader_plan_i
+  {
+  size_t n;
+  cfft_plan plan;
+  size_t *perm;
+  pfreal *bkf;
+  } fftrader_plan_i;
+typedef struct fftrader_plan_i * fftrader_plan;
+
+static size_t powmod (size_t b, size_t e, size_t m)
+  {
+  unsigned long long r=1, x=b%m;
+  for (; e; e>>=1)
+    {
+    if (e&1) r=r*x%m;
+    x=x*x%m;
+    }
+  return (size_t)r;
+  }
+
+/* smallest generator of the multiplicative group modulo the prime n */
+NOINLINE static size_t primitive_root (size_t n)
+  {
+  size_t fct[64], nfct=0, m=n-1;
+  for (size_t d=2; d*d<=m; ++d)
+    if ((m%d)==0)
+      {
+      fct[nfct++]=d;
+      while ((m%d)==0) m/=d;
+      }
+  if (m>1) fct[nfct++]=m;
+  for (size_t g=2; g<n; ++g)
+    {
+    int ok=1;
+    for (size_t i=0; (i<nfct)&&ok; ++i)
+      if (powmod(g,(n-1)/fct[i],n)==1) ok=0;
+    if (ok) return g;
+    }
+  return 0;
+  }
+
+/* Estimated cost of a Rader plan, zero when n does not qualify */
+NOINLINE static double rader_cost (size_t n)
+  {
+  /* powmod squares residues in 64 bits */
+  if ((n<3) || (n>0xFFFFFFFFu) || (largest_prime_factor(n)!=n)) return 0.;
+  double conv = cost_guess(n-1);
+  double blue = 3*cost_guess(good_size(2*n-3));
+  return 2.2*(conv<blue ? conv : blue);
+  }
+
+NOINLINE static void destroy_fftrader_plan (fftrader_plan plan)
+  {
+  if (plan->plan) destroy_cfft_plan(plan->plan);
+  DEALLOC(plan->perm);
+  DEALLOC(plan->bkf);
+  DEALLOC(plan);
+  }
+
+NOINLINE static fftrader_plan make_fftrader_plan (size_t length)
+  {
+  size_t g=primitive_root(length);
+  if (!g) return NULL;
+  fftrader_plan plan = RALLOC(fftrader_plan_i,1);
+  if (!plan) return NULL;
+  size_t len=length-1;
+  plan->n = length;
+  plan->plan = make_cfft_plan(len);
+  plan->perm = RALLOC(size_t, len);
+  plan->bkf = RALLOC(pfreal, 2*len);
+  double *tmp = RALLOC(double, 2*length);
+  if (!plan->plan || !plan->perm || !plan->bkf || !tmp)
+    { DEALLOC(tmp); destroy_fftrader_plan(plan); return NULL; }
+
+  /* perm[q] = g^q mod n */
+  plan->perm[0]=1;
+  for (size_t q=1; q<len; ++q)
+    plan->perm[q]=(size_t)((unsigned long long)plan->perm[q-1]*g%length);
+
+  /* transformed e^(-2*pi*i*g^-q/n), normalisation included */
+  sincos_2pibyn(length,tmp);
+  double xn = 1./len;
+  for (size_t q=0; q<len; ++q)
+    {
+    size_t idx=plan->perm[(len-q)%len];
+    plan->bkf[2*q  ] = tmp[2*idx  ]*xn;
+    plan->bkf[2*q+1] =-tmp[2*idx+1]*xn;
+    }
   DEALLOC(tmp);
+  if (cfft_forward(plan->plan,plan->bkf,1.)!=0)
+    { destroy_fftrader_plan(plan); return NULL; }
+  return plan;
+  }
+
+/* The backward transform convolves with conj(b): conjugate on the way in
+   and out instead of keeping a second kernel */
+NOINLINE WARN_UNUSED_RESULT
+static int fftrader_fft(fftrader_plan plan, pfreal c[], int isign, pfreal fct)
+  {
+  size_t len=plan->n-1;
+  const size_t *perm=plan->perm;
+  const pfreal *bkf=plan->bkf;
+  pfreal *akf = WALLOC(pfreal, 2*len);
+  if (!akf) return -1;
+
+  pfreal x0r=c[0], x0i=c[1], sr=x0r, si=x0i;
+  for (size_t q=0; q<len; ++q)
+    {
+    size_t idx=perm[q];
+    sr+=c[2*idx];
+    si+=c[2*idx+1];
+    akf[2*q  ] = c[2*idx];
+    akf[2*q+1] = (isign>0) ? -c[2*idx+1] : c[2*idx+1];
+    }
+
+  if (cfft_forward(plan->plan,akf,1.)!=0)
+    { WDEALLOC(akf); return -1; }
+  for (size_t m=0; m<2*len; m+=2)
+    {
+    pfreal im = akf[m]*bkf[m+1] + akf[m+1]*bkf[m];
+    akf[m  ]  = akf[m]*bkf[m]   - akf[m+1]*bkf[m+1];
+    akf[m+1]  = im;
+    }
+  if (cfft_backward(plan->plan,akf,1.)!=0)
+    { WDEALLOC(akf); return -1; }
+
+  c[0]=sr*fct;
+  c[1]=si*fct;
+  for (size_t m=0; m<len; ++m)
+    {
+    size_t idx=perm[(len-m)%len];
+    pfreal im = (isign>0) ? -akf[2*m+1] : akf[2*m+1];
+    c[2*idx  ] = (x0r+akf[2*m])*fct;
+    c[2*idx+1] = (x0i+im)*fct;
+    }
+  WDEALLOC(akf);
+  return 0;
+  }
+
+WARN_UNUSED_RESULT
+static int rfftrader_backward(fftrader_plan plan, pfreal c[], pfreal fct)
+  {
+  size_t n=plan->n;
+  pfreal *tmp = WALLOC(pfreal,2*n);
+  if (!tmp) return -1;
+  tmp[0]=c[0];
+  tmp[1]=0.;
+  memcpy (tmp+2,c+1, (n-1)*sizeof(pfreal));
+  if ((n&1)==0) tmp[n+1]=0.;
+  for (size_t m=2; m<n; m+=2)
+    {
+    tmp[2*n-m]=tmp[m];
+    tmp[2*n-m+1]=-tmp[m+1];
+    }
+  if (fftrader_fft(plan,tmp,1,fct)!=0)
+    { WDEALLOC(tmp); return -1; }
+  for (size_t m=0; m<n; ++m)
+    c[m] = tmp[2*m];
+  WDEALLOC(tmp);
+  return 0;
+  }
+
+WARN_UNUSED_RESULT
+static int rfftrader_forward(fftrader_plan plan, pfreal c[], pfreal fct)
+  {
+  size_t n=plan->n;
+  pfreal *tmp = WALLOC(pfreal,2*n);
+  if (!tmp) return -1;
+  for (size_t m=0; m<n; ++m)
+    {
+    tmp[2*m] = c[m];
+    tmp[2*m+1] = 0.;
+    }
+  if (fftrader_fft(plan,tmp,-1,fct)!=0)
+    { WDEALLOC(tmp); return -1; }
+  c[0] = tmp[0];
+  memcpy (c+1, tmp+2, (n-1)*sizeof(pfreal));
+  WDEALLOC(tmp);
   return 0;
   }
 
@@ -2061,6 +3025,7 @@ typedef struct cfft_plan_i
   {
   cfftp_plan packplan;
   fftblue_plan blueplan;
+  fftrader_plan raderplan;
   } cfft_plan_i;
 
 cfft_plan make_cfft_plan (size_t length)
@@ -2070,6 +3035,7 @@ cfft_plan make_cfft_plan (size_t length)
   if (!plan) return NULL;
   plan->blueplan=0;
   plan->packplan=0;
+  plan->raderplan=0;
   if ((length<50) || (largest_prime_factor(length)<=sqrt(length)))
     {
     plan->packplan=make_cfftp_plan(length);
@@ -2079,7 +3045,13 @@ cfft_plan make_cfft_plan (size_t length)
   double comp1 = cost_guess(length);
   double comp2 = 2*cost_guess(good_size(2*length-1));
   comp2*=1.5; /* fudge factor that appears to give good overall performance */
-  if (comp2<comp1) // use Bluestein
+  double comp3 = rader_cost(length);
+  if ((comp3>0) && (comp3<comp1) && (comp3<comp2)) // use Rader
+    {
+    plan->raderplan=make_fftrader_plan(length);
+    if (!plan->raderplan) { DEALLOC(plan); return NULL; }
+    }
+  else if (comp2<comp1) // use Bluestein
     {
     plan->blueplan=make_fftblue_plan(length);
     if (!plan->blueplan) { DEALLOC(plan); return NULL; }
@@ -2094,6 +3066,8 @@ cfft_plan make_cfft_plan (size_t length)
 
 void destroy_cfft_plan (cfft_plan plan)
   {
+  if (plan->raderplan)
+    destroy_fftrader_plan(plan->raderplan);
   if (plan->blueplan)
     destroy_fftblue_plan(plan->blueplan);
   if (plan->packplan)
@@ -2101,26 +3075,65 @@ void destroy_cfft_plan (cfft_plan plan)
   DEALLOC(plan);
   }
 
-WARN_UNUSED_RESULT int cfft_backward(cfft_plan plan, double c[], double fct)
+WARN_UNUSED_RESULT int cfft_backward(cfft_plan plan, pfreal c[], pfreal fct)
   {
   if (plan->packplan)
     return cfftp_backward(plan->packplan,c,fct);
+  if (plan->raderplan)
+    return fftrader_fft(plan->raderplan,c,1,fct);
   // if (plan->blueplan)
   return cfftblue_backward(plan->blueplan,c,fct);
   }
 
-WARN_UNUSED_RESULT int cfft_forward(cfft_plan plan, double c[], double fct)
+WARN_UNUSED_RESULT int cfft_forward(cfft_plan plan, pfreal c[], pfreal fct)
   {
   if (plan->packplan)
     return cfftp_forward(plan->packplan,c,fct);
+  if (plan->raderplan)
+    return fftrader_fft(plan->raderplan,c,-1,fct);
   // if (plan->blueplan)
   return cfftblue_forward(plan->blueplan,c,fct);
   }
 
+size_t cfft_multi_width(cfft_plan plan)
+  {
+#ifdef PFV_LEN
+  /* With one complex per vector there is nothing to gain over cfft_* */
+  if (PFV_LEN > 1 && plan->packplan && cfftp_has_multi(plan->packplan))
+    return PFV_LEN;
+#else
+  (void)plan;
+#endif
+  return 0;
+  }
+
+WARN_UNUSED_RESULT int cfft_backward_multi(cfft_plan plan, pfreal c[], pfreal fct)
+  {
+#ifdef PFV_LEN
+  if (cfft_multi_width(plan))
+    return pass_all_multi(plan->packplan,(cmplx *)c, fct, 1);
+#else
+  (void)plan; (void)c; (void)fct;
+#endif
+  return -1;
+  }
+
+WARN_UNUSED_RESULT int cfft_forward_multi(cfft_plan plan, pfreal c[], pfreal fct)
+  {
+#ifdef PFV_LEN
+  if (cfft_multi_width(plan))
+    return pass_all_multi(plan->packplan,(cmplx *)c, fct, -1);
+#else
+  (void)plan; (void)c; (void)fct;
+#endif
+  return -1;
+  }
+
 typedef struct rfft_plan_i
   {
   rfftp_plan packplan;
   fftblue_plan blueplan;
+  fftrader_plan raderplan;
   } rfft_plan_i;
 
 rfft_plan make_rfft_plan (size_t length)
@@ -2130,6 +3143,7 @@ rfft_plan make_rfft_plan (size_t length)
   if (!plan) return NULL;
   plan->blueplan=0;
   plan->packplan=0;
+  plan->raderplan=0;
   if ((length<50) || (largest_prime_factor(length)<=sqrt(length)))
     {
     plan->packplan=make_rfftp_plan(length);
@@ -2139,7 +3153,13 @@ rfft_plan make_rfft_plan (size_t length)
   double comp1 = 0.5*cost_guess(length);
   double comp2 = 2*cost_guess(good_size(2*length-1));
   comp2*=1.5; /* fudge factor that appears to give good overall performance */
-  if (comp2<comp1) // use Bluestein
+  double comp3 = rader_cost(length);
+  if ((comp3>0) && (comp3<comp1) && (comp3<comp2)) // use Rader
+    {
+    plan->raderplan=make_fftrader_plan(length);
+    if (!plan->raderplan) { DEALLOC(plan); return NULL; }
+    }
+  else if (comp2<comp1) // use Bluestein
     {
     plan->blueplan=make_fftblue_plan(length);
     if (!plan->blueplan) { DEALLOC(plan); return NULL; }
@@ -2154,6 +3174,8 @@ rfft_plan make_rfft_plan (size_t length)
 
 void destroy_rfft_plan (rfft_plan plan)
   {
+  if (plan->raderplan)
+    destroy_fftrader_plan(plan->raderplan);
   if (plan->blueplan)
     destroy_fftblue_plan(plan->blueplan);
   if (plan->packplan)
@@ -2164,27 +3186,33 @@ void destroy_rfft_plan (rfft_plan plan)
 size_t rfft_length(rfft_plan plan)
   {
   if (plan->packplan) return plan->packplan->length;
+  if (plan->raderplan) return plan->raderplan->n;
   return plan->blueplan->n;
   }
 
 size_t cfft_length(cfft_plan plan)
   {
   if (plan->packplan) return plan->packplan->length;
+  if (plan->raderplan) return plan->raderplan->n;
   return plan->blueplan->n;
   }
 
-WARN_UNUSED_RESULT int rfft_backward(rfft_plan plan, double c[], double fct)
+WARN_UNUSED_RESULT int rfft_backward(rfft_plan plan, pfreal c[], pfreal fct)
   {
   if (plan->packplan)
     return rfftp_backward(plan->packplan,c,fct);
+  else if (plan->raderplan)
+    return rfftrader_backward(plan->raderplan,c,fct);
   else // if (plan->blueplan)
     return rfftblue_backward(plan->blueplan,c,fct);
   }
 
-WARN_UNUSED_RESULT int rfft_forward(rfft_plan plan, double c[], double fct)
+WARN_UNUSED_RESULT int rfft_forward(rfft_plan plan, pfreal c[], pfreal fct)
   {
   if (plan->packplan)
     return rfftp_forward(plan->packplan,c,fct);
+  else if (plan->raderplan)
+    return rfftrader_forward(plan->raderplan,c,fct);
   else // if (plan->blueplan)
     return rfftblue_forward(plan->blueplan,c,fct);
   }
\ No newline at end of file
@@ -23,6 +23,14 @@ int cfft_backward(cfft_plan plan, double c[], double fct);
 int cfft_forward(cfft_plan plan, double c[], double fct);
 size_t cfft_length(cfft_plan plan);
 
+/* Several transforms of one plan at once, interleaved element by element:
+   c holds cfft_multi_width(plan) transforms, element j of transform l at
+   complex index j*width+l. A width of 0 means the plan has no such mode,
+   the *_multi calls then return -1. */
+size_t cfft_multi_width(cfft_plan plan);
+int cfft_backward_multi(cfft_plan plan, double c[], double fct);
+int cfft_forward_multi(cfft_plan plan, double c[], double fct);
+
 struct rfft_plan_i;
 typedef struct rfft_plan_i * rfft_plan;
 rfft_plan make_rfft_plan (size_t length);
@@ -31,4 +39,24 @@ int rfft_backward(rfft_plan plan, double c[], double fct);
 int rfft_forward(rfft_plan plan, double c[], double fct);
 size_t rfft_length(rfft_plan plan);
 
+/* Single-precision flavour (pocketfft_f32.c), same semantics as above */
+struct cfft_plan_f32_i;
+typedef struct cfft_plan_f32_i * cfft_plan_f32;
+cfft_plan_f32 make_cfft_plan_f32 (size_t length);
+void destroy_cfft_plan_f32 (cfft_plan_f32 plan);
+int cfft_backward_f32(cfft_plan_f32 plan, float c[], float fct);
+int cfft_forward_f32(cfft_plan_f32 plan, float c[], float fct);
+size_t cfft_length_f32(cfft_plan_f32 plan);
+size_t cfft_multi_width_f32(cfft_plan_f32 plan);
+int cfft_backward_multi_f32(cfft_plan_f32 plan, float c[], float fct);
+int cfft_forward_multi_f32(cfft_plan_f32 plan, float c[], float fct);
+
+struct rfft_plan_f32_i;
+typedef struct rfft_plan_f32_i * rfft_plan_f32;
+rfft_plan_f32 make_rfft_plan_f32 (size_t length);
+void destroy_rfft_plan_f32 (rfft_plan_f32 plan);
+int rfft_backward_f32(rfft_plan_f32 plan, float c[], float fct);
+int rfft_forward_f32(rfft_plan_f32 plan, float c[], float fct);
+size_t rfft_length_f32(rfft_plan_f32 plan);
+
 #endif
\ No newline at end of file
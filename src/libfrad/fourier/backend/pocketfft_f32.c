@@ -0,0 +1,11 @@
+/*
+ * This file is part of pocketfft.
+ * Licensed under a 3-clause BSD style license - see LICENSE.md
+ */
+
+/*
+ *  Single-precision build of pocketfft.c, see POCKETFFT_FLOAT there.
+ */
+
+#define POCKETFFT_FLOAT
+#include "pocketfft.c"
@@ -0,0 +1,302 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// Copyright (C) 2025 HaמuL
+
+#ifndef POCKETFFT_SIMD_H
+#define POCKETFFT_SIMD_H
+
+// Packed complex vectors for the pocketfft butterfly passes
+// The instruction set is chosen at compile time (-march=native); with none of
+// the below available, or POCKETFFT_NO_SIMD defined, PFV_LEN stays undefined
+// and only the scalar passes build.
+//
+// A pfv holds PFV_LEN consecutive complex values as interleaved [re, im] pairs,
+// the same layout as pocketfft's cmplx arrays. With POCKETFFT_FLOAT the
+// components are float and a pfv holds twice as many values.
+//
+//   PFV_LOAD(p)        PFV_LEN complex from p
+//   PFV_LOADS(p, s)    PFV_LEN complex from p, p + s, p + 2s, ...
+//   PFV_BCAST(p)       the complex at p in every slot
+//   PFV_STORE(p, v)
+//   PFV_ADD / PFV_SUB
+//   PFV_MULS(v, s)     v * s for real s
+//   PFV_FMAS(a, v, s)  a + v * s for real s
+//   PFV_ROT90(v)       v * i
+//   PFV_ROTM90(v)      v * -i
+//   PFV_CMUL(w, v)     w * v
+//   PFV_CMULC(w, v)    conj(w) * v
+
+#if defined(POCKETFFT_NO_SIMD)
+
+// Scalar passes only
+
+#elif defined(__AVX512F__) && defined(POCKETFFT_FLOAT)
+
+#include <immintrin.h>
+#define PFV_LEN 8
+#define PFV_ISA "avx512"
+typedef __m512 pfv;
+
+// A complex float is one 64-bit lane
+static inline pfv pfv_loads(const void* p, size_t s) {
+    long long ls = (long long)s;
+    __m512i idx = _mm512_set_epi64(7 * ls, 6 * ls, 5 * ls, 4 * ls, 3 * ls, 2 * ls, ls, 0);
+    return _mm512_castpd_ps(_mm512_i64gather_pd(idx, p, 8));
+}
+static inline pfv pfv_bcast(const void* p) {
+    return _mm512_castsi512_ps(_mm512_broadcastq_epi64(_mm_loadl_epi64((const __m128i*)p)));
+}
+static inline pfv pfv_rot90(pfv v) {
+    pfv s = _mm512_permute_ps(v, 0xB1);
+    return _mm512_mask_sub_ps(s, 0x5555, _mm512_setzero_ps(), s);
+}
+static inline pfv pfv_rotm90(pfv v) {
+    pfv s = _mm512_permute_ps(v, 0xB1);
+    return _mm512_mask_sub_ps(s, 0xAAAA, _mm512_setzero_ps(), s);
+}
+static inline pfv pfv_cmul(pfv w, pfv v) {
+    pfv wi_vs = _mm512_mul_ps(_mm512_movehdup_ps(w), _mm512_permute_ps(v, 0xB1));
+    return _mm512_fmaddsub_ps(_mm512_moveldup_ps(w), v, wi_vs);
+}
+static inline pfv pfv_cmulc(pfv w, pfv v) {
+    pfv wi_vs = _mm512_mul_ps(_mm512_movehdup_ps(w), _mm512_permute_ps(v, 0xB1));
+    return _mm512_fmsubadd_ps(_mm512_moveldup_ps(w), v, wi_vs);
+}
+
+#define PFV_LOAD(p)       _mm512_loadu_ps((const float*)(p))
+#define PFV_LOADS(p, s)   pfv_loads((p), (s))
+#define PFV_BCAST(p)      pfv_bcast(p)
+#define PFV_STORE(p, v)   _mm512_storeu_ps((float*)(p), (v))
+#define PFV_ADD(a, b)     _mm512_add_ps((a), (b))
+#define PFV_SUB(a, b)     _mm512_sub_ps((a), (b))
+#define PFV_MULS(v, s)    _mm512_mul_ps((v), _mm512_set1_ps(s))
+#define PFV_FMAS(a, v, s) _mm512_fmadd_ps((v), _mm512_set1_ps(s), (a))
+#define PFV_ROT90(v)      pfv_rot90(v)
+#define PFV_ROTM90(v)     pfv_rotm90(v)
+#define PFV_CMUL(w, v)    pfv_cmul((w), (v))
+#define PFV_CMULC(w, v)   pfv_cmulc((w), (v))
+
+#elif defined(__AVX512F__)
+
+#include <immintrin.h>
+#define PFV_LEN 4
+#define PFV_ISA "avx512"
+typedef __m512d pfv;
+
+static inline pfv pfv_loads(const void* p, size_t s) {
+    const double* d = (const double*)p;
+    __m256d lo = _mm256_insertf128_pd(_mm256_castpd128_pd256(_mm_loadu_pd(d)), _mm_loadu_pd(d + 2 * s), 1);
+    __m256d hi = _mm256_insertf128_pd(_mm256_castpd128_pd256(_mm_loadu_pd(d + 4 * s)), _mm_loadu_pd(d + 6 * s), 1);
+    return _mm512_insertf64x4(_mm512_castpd256_pd512(lo), hi, 1);
+}
+static inline pfv pfv_bcast(const void* p) {
+    return _mm512_broadcast_f64x4(_mm256_broadcast_pd((const __m128d*)p));
+}
+static inline pfv pfv_rot90(pfv v) {
+    pfv s = _mm512_permute_pd(v, 0x55);
+    return _mm512_mask_sub_pd(s, 0x55, _mm512_setzero_pd(), s);
+}
+static inline pfv pfv_rotm90(pfv v) {
+    pfv s = _mm512_permute_pd(v, 0x55);
+    return _mm512_mask_sub_pd(s, 0xAA, _mm512_setzero_pd(), s);
+}
+static inline pfv pfv_cmul(pfv w, pfv v) {
+    pfv wi_vs = _mm512_mul_pd(_mm512_permute_pd(w, 0xFF), _mm512_permute_pd(v, 0x55));
+    return _mm512_fmaddsub_pd(_mm512_movedup_pd(w), v, wi_vs);
+}
+static inline pfv pfv_cmulc(pfv w, pfv v) {
+    pfv wi_vs = _mm512_mul_pd(_mm512_permute_pd(w, 0xFF), _mm512_permute_pd(v, 0x55));
+    return _mm512_fmsubadd_pd(_mm512_movedup_pd(w), v, wi_vs);
+}
+
+#define PFV_LOAD(p)       _mm512_loadu_pd((const double*)(p))
+#define PFV_LOADS(p, s)   pfv_loads((p), (s))
+#define PFV_BCAST(p)      pfv_bcast(p)
+#define PFV_STORE(p, v)   _mm512_storeu_pd((double*)(p), (v))
+#define PFV_ADD(a, b)     _mm512_add_pd((a), (b))
+#define PFV_SUB(a, b)     _mm512_sub_pd((a), (b))
+#define PFV_MULS(v, s)    _mm512_mul_pd((v), _mm512_set1_pd(s))
+#define PFV_FMAS(a, v, s) _mm512_fmadd_pd((v), _mm512_set1_pd(s), (a))
+#define PFV_ROT90(v)      pfv_rot90(v)
+#define PFV_ROTM90(v)     pfv_rotm90(v)
+#define PFV_CMUL(w, v)    pfv_cmul((w), (v))
+#define PFV_CMULC(w, v)   pfv_cmulc((w), (v))
+
+#elif defined(__AVX2__) && defined(__FMA__) && defined(POCKETFFT_FLOAT)
+
+#include <immintrin.h>
+#define PFV_LEN 4
+#define PFV_ISA "avx2"
+typedef __m256 pfv;
+
+static inline pfv pfv_loads(const void* p, size_t s) {
+    long long ls = (long long)s;
+    return _mm256_castpd_ps(_mm256_i64gather_pd((const double*)p, _mm256_set_epi64x(3 * ls, 2 * ls, ls, 0), 8));
+}
+static inline pfv pfv_bcast(const void* p) {
+    return _mm256_castsi256_ps(_mm256_broadcastq_epi64(_mm_loadl_epi64((const __m128i*)p)));
+}
+static inline pfv pfv_rot90(pfv v) {
+    pfv s = _mm256_permute_ps(v, 0xB1);
+    return _mm256_blend_ps(s, _mm256_sub_ps(_mm256_setzero_ps(), s), 0x55);
+}
+static inline pfv pfv_rotm90(pfv v) {
+    pfv s = _mm256_permute_ps(v, 0xB1);
+    return _mm256_blend_ps(s, _mm256_sub_ps(_mm256_setzero_ps(), s), 0xAA);
+}
+static inline pfv pfv_cmul(pfv w, pfv v) {
+    pfv wi_vs = _mm256_mul_ps(_mm256_movehdup_ps(w), _mm256_permute_ps(v, 0xB1));
+    return _mm256_fmaddsub_ps(_mm256_moveldup_ps(w), v, wi_vs);
+}
+static inline pfv pfv_cmulc(pfv w, pfv v) {
+    pfv wi_vs = _mm256_mul_ps(_mm256_movehdup_ps(w), _mm256_permute_ps(v, 0xB1));
+    return _mm256_fmsubadd_ps(_mm256_moveldup_ps(w), v, wi_vs);
+}
+
+#define PFV_LOAD(p)       _mm256_loadu_ps((const float*)(p))
+#define PFV_LOADS(p, s)   pfv_loads((p), (s))
+#define PFV_BCAST(p)      pfv_bcast(p)
+#define PFV_STORE(p, v)   _mm256_storeu_ps((float*)(p), (v))
+#define PFV_ADD(a, b)     _mm256_add_ps((a), (b))
+#define PFV_SUB(a, b)     _mm256_sub_ps((a), (b))
+#define PFV_MULS(v, s)    _mm256_mul_ps((v), _mm256_set1_ps(s))
+#define PFV_FMAS(a, v, s) _mm256_fmadd_ps((v), _mm256_set1_ps(s), (a))
+#define PFV_ROT90(v)      pfv_rot90(v)
+#define PFV_ROTM90(v)     pfv_rotm90(v)
+#define PFV_CMUL(w, v)    pfv_cmul((w), (v))
+#define PFV_CMULC(w, v)   pfv_cmulc((w), (v))
+
+#elif defined(__AVX2__) && defined(__FMA__)
+
+#include <immintrin.h>
+#define PFV_LEN 2
+#define PFV_ISA "avx2"
+typedef __m256d pfv;
+
+static inline pfv pfv_loads(const void* p, size_t s) {
+    const double* d = (const double*)p;
+    return _mm256_insertf128_pd(_mm256_castpd128_pd256(_mm_loadu_pd(d)), _mm_loadu_pd(d + 2 * s), 1);
+}
+// Negate by blending rather than xor with -0.0, -ffast-math may fold that constant to +0.0
+static inline pfv pfv_rot90(pfv v) {
+    pfv s = _mm256_permute_pd(v, 0x5);
+    return _mm256_blend_pd(s, _mm256_sub_pd(_mm256_setzero_pd(), s), 0x5);
+}
+static inline pfv pfv_rotm90(pfv v) {
+    pfv s = _mm256_permute_pd(v, 0x5);
+    return _mm256_blend_pd(s, _mm256_sub_pd(_mm256_setzero_pd(), s), 0xA);
+}
+static inline pfv pfv_cmul(pfv w, pfv v) {
+    pfv wi_vs = _mm256_mul_pd(_mm256_permute_pd(w, 0xF), _mm256_permute_pd(v, 0x5));
+    return _mm256_fmaddsub_pd(_mm256_movedup_pd(w), v, wi_vs);
+}
+static inline pfv pfv_cmulc(pfv w, pfv v) {
+    pfv wi_vs = _mm256_mul_pd(_mm256_permute_pd(w, 0xF), _mm256_permute_pd(v, 0x5));
+    return _mm256_fmsubadd_pd(_mm256_movedup_pd(w), v, wi_vs);
+}
+
+#define PFV_LOAD(p)       _mm256_loadu_pd((const double*)(p))
+#define PFV_LOADS(p, s)   pfv_loads((p), (s))
+#define PFV_BCAST(p)      _mm256_broadcast_pd((const __m128d*)(p))
+#define PFV_STORE(p, v)   _mm256_storeu_pd((double*)(p), (v))
+#define PFV_ADD(a, b)     _mm256_add_pd((a), (b))
+#define PFV_SUB(a, b)     _mm256_sub_pd((a), (b))
+#define PFV_MULS(v, s)    _mm256_mul_pd((v), _mm256_set1_pd(s))
+#define PFV_FMAS(a, v, s) _mm256_fmadd_pd((v), _mm256_set1_pd(s), (a))
+#define PFV_ROT90(v)      pfv_rot90(v)
+#define PFV_ROTM90(v)     pfv_rotm90(v)
+#define PFV_CMUL(w, v)    pfv_cmul((w), (v))
+#define PFV_CMULC(w, v)   pfv_cmulc((w), (v))
+
+#elif defined(__ARM_NEON) && defined(__aarch64__) && defined(POCKETFFT_FLOAT)
+
+#include <arm_neon.h>
+#define PFV_LEN 2
+#define PFV_ISA "neon"
+typedef float32x4_t pfv;
+
+// Sign patterns {-1, +1, -1, +1} and {+1, -1, +1, -1}
+static inline pfv pfv_neg_re(void) { float32x2_t s = {-1.0f, 1.0f}; return vcombine_f32(s, s); }
+static inline pfv pfv_neg_im(void) { float32x2_t s = {1.0f, -1.0f}; return vcombine_f32(s, s); }
+
+static inline pfv pfv_loads(const void* p, size_t s) {
+    const float* f = (const float*)p;
+    return vcombine_f32(vld1_f32(f), vld1_f32(f + 2 * s));
+}
+static inline pfv pfv_bcast(const void* p) {
+    float32x2_t c = vld1_f32((const float*)p);
+    return vcombine_f32(c, c);
+}
+static inline pfv pfv_rot90(pfv v) {
+    return vmulq_f32(vrev64q_f32(v), pfv_neg_re());
+}
+static inline pfv pfv_rotm90(pfv v) {
+    return vmulq_f32(vrev64q_f32(v), pfv_neg_im());
+}
+static inline pfv pfv_cmul(pfv w, pfv v) {
+    pfv wi_vs = vmulq_f32(vtrn2q_f32(w, w), vrev64q_f32(v));
+    return vfmaq_f32(vmulq_f32(vtrn1q_f32(w, w), v), wi_vs, pfv_neg_re());
+}
+static inline pfv pfv_cmulc(pfv w, pfv v) {
+    pfv wi_vs = vmulq_f32(vtrn2q_f32(w, w), vrev64q_f32(v));
+    return vfmaq_f32(vmulq_f32(vtrn1q_f32(w, w), v), wi_vs, pfv_neg_im());
+}
+
+#define PFV_LOAD(p)       vld1q_f32((const float*)(p))
+#define PFV_LOADS(p, s)   pfv_loads((p), (s))
+#define PFV_BCAST(p)      pfv_bcast(p)
+#define PFV_STORE(p, v)   vst1q_f32((float*)(p), (v))
+#define PFV_ADD(a, b)     vaddq_f32((a), (b))
+#define PFV_SUB(a, b)     vsubq_f32((a), (b))
+#define PFV_MULS(v, s)    vmulq_n_f32((v), (s))
+#define PFV_FMAS(a, v, s) vfmaq_n_f32((a), (v), (s))
+#define PFV_ROT90(v)      pfv_rot90(v)
+#define PFV_ROTM90(v)     pfv_rotm90(v)
+#define PFV_CMUL(w, v)    pfv_cmul((w), (v))
+#define PFV_CMULC(w, v)   pfv_cmulc((w), (v))
+
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+
+#include <arm_neon.h>
+#define PFV_LEN 1
+#define PFV_ISA "neon"
+typedef float64x2_t pfv;
+
+// Sign patterns {-1, +1} and {+1, -1}
+static inline pfv pfv_neg_re(void) { return vcombine_f64(vdup_n_f64(-1.0), vdup_n_f64(1.0)); }
+static inline pfv pfv_neg_im(void) { return vcombine_f64(vdup_n_f64(1.0), vdup_n_f64(-1.0)); }
+
+static inline pfv pfv_rot90(pfv v) {
+    return vmulq_f64(vextq_f64(v, v, 1), pfv_neg_re());
+}
+static inline pfv pfv_rotm90(pfv v) {
+    return vmulq_f64(vextq_f64(v, v, 1), pfv_neg_im());
+}
+static inline pfv pfv_cmul(pfv w, pfv v) {
+    pfv wi_vs = vmulq_f64(vdupq_laneq_f64(w, 1), vextq_f64(v, v, 1));
+    return vfmaq_f64(vmulq_f64(vdupq_laneq_f64(w, 0), v), wi_vs, pfv_neg_re());
+}
+static inline pfv pfv_cmulc(pfv w, pfv v) {
+    pfv wi_vs = vmulq_f64(vdupq_laneq_f64(w, 1), vextq_f64(v, v, 1));
+    return vfmaq_f64(vmulq_f64(vdupq_laneq_f64(w, 0), v), wi_vs, pfv_neg_im());
+}
+
+#define PFV_LOAD(p)       vld1q_f64((const double*)(p))
+#define PFV_LOADS(p, s)   vld1q_f64((const double*)(p))
+#define PFV_BCAST(p)      vld1q_f64((const double*)(p))
+#define PFV_STORE(p, v)   vst1q_f64((double*)(p), (v))
+#define PFV_ADD(a, b)     vaddq_f64((a), (b))
+#define PFV_SUB(a, b)     vsubq_f64((a), (b))
+#define PFV_MULS(v, s)    vmulq_n_f64((v), (s))
+#define PFV_FMAS(a, v, s) vfmaq_n_f64((a), (v), (s))
+#define PFV_ROT90(v)      pfv_rot90(v)
+#define PFV_ROTM90(v)     pfv_rotm90(v)
+#define PFV_CMUL(w, v)    pfv_cmul((w), (v))
+#define PFV_CMULC(w, v)   pfv_cmulc((w), (v))
+
+#endif
+
+#ifndef PFV_ISA
+#define PFV_ISA "scalar"
+#endif
+
+#endif // POCKETFFT_SIMD_H
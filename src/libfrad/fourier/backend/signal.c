@@ -1,6 +1,8 @@
 #include "signal.h"
 #include "../../backend/backend.h"
 #include "pocketfft.h"
+#include "fft_cache.h"
+#include "../../backend/arena.h"
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
@@ -19,12 +21,8 @@ vec_f64* impulse_filt(const vec_f64* b, const vec_f64* a, const vec_f64* input)
     }
 
     // Initialize history buffers with zeros
-    for (size_t i = 0; i < b->size; i++) {
-        vec_f64_push(x_hist, 0.0);
-    }
-    for (size_t i = 0; i < a->size - 1; i++) {
-        vec_f64_push(y_hist, 0.0);
-    }
+    vec_f64_resize(x_hist, b->size);
+    vec_f64_resize(y_hist, a->size - 1);
 
     for (size_t i = 0; i < input->size; i++) {
         // Shift x_hist
@@ -72,11 +70,11 @@ vec_f64* correlate_full(const vec_f64* x, const vec_f64* y) {
     size_t size = next_power_of_two(n);
 
     // Allocate complex arrays (interleaved real/imag)
-    double* x_fft = (double*)calloc(size * 2, sizeof(double));
-    double* y_fft = (double*)calloc(size * 2, sizeof(double));
+    double* x_fft = (double*)frad_calloc(size * 2, sizeof(double));
+    double* y_fft = (double*)frad_calloc(size * 2, sizeof(double));
     if (!x_fft || !y_fft) {
-        free(x_fft);
-        free(y_fft);
+        frad_free(x_fft);
+        frad_free(y_fft);
         return NULL;
     }
 
@@ -92,24 +90,24 @@ vec_f64* correlate_full(const vec_f64* x, const vec_f64* y) {
         y_fft[i * 2 + 1] = 0.0;
     }
 
-    // Create FFT plan
-    cfft_plan plan = make_cfft_plan(size);
+    // Get cached FFT plan
+    fft_cache_entry* plan = fft_cache_acquire(FFT_PLAN_COMPLEX, size);
     if (!plan) {
-        free(x_fft);
-        free(y_fft);
+        frad_free(x_fft);
+        frad_free(y_fft);
         return NULL;
     }
 
     // Forward FFT
-    cfft_forward(plan, x_fft, 1.0);
-    cfft_forward(plan, y_fft, 1.0);
+    cfft_forward(plan->cplan, x_fft, 1.0);
+    cfft_forward(plan->cplan, y_fft, 1.0);
 
     // Multiply in frequency domain
-    double* z = (double*)calloc(size * 2, sizeof(double));
+    double* z = (double*)frad_calloc(size * 2, sizeof(double));
     if (!z) {
-        destroy_cfft_plan(plan);
-        free(x_fft);
-        free(y_fft);
+        fft_cache_release(plan);
+        frad_free(x_fft);
+        frad_free(y_fft);
         return NULL;
     }
 
@@ -120,15 +118,15 @@ vec_f64* correlate_full(const vec_f64* x, const vec_f64* y) {
     }
 
     // Inverse FFT
-    cfft_backward(plan, z, 1.0);
+    cfft_backward(plan->cplan, z, 1.0);
 
     // Create output vector
     vec_f64* output = vec_f64_new(n);
     if (!output) {
-        destroy_cfft_plan(plan);
-        free(x_fft);
-        free(y_fft);
-        free(z);
+        fft_cache_release(plan);
+        frad_free(x_fft);
+        frad_free(y_fft);
+        frad_free(z);
         return NULL;
     }
 
@@ -138,10 +136,10 @@ vec_f64* correlate_full(const vec_f64* x, const vec_f64* y) {
     }
 
     // Cleanup
-    destroy_cfft_plan(plan);
-    free(x_fft);
-    free(y_fft);
-    free(z);
+    fft_cache_release(plan);
+    frad_free(x_fft);
+    frad_free(y_fft);
+    frad_free(z);
 
     return output;
 }
\ No newline at end of file
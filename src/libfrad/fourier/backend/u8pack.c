@@ -1,5 +1,6 @@
 #include "u8pack.h"
 #include "../../backend/bitcvt.h"
+#include "../../backend/arena.h"
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
@@ -83,7 +84,7 @@ static vec_u8* cut_float3s(vec_u8* bytes, size_t bits, bool little_endian) {
         // Create result bitstream
         size_t chunk_size = size * 4 / 3;
         size_t result_bit_count = 0;
-        bool* cut_bits = (bool*)malloc(bit_count * sizeof(bool));
+        bool* cut_bits = (bool*)frad_malloc(bit_count * sizeof(bool));
 
         for (size_t i = 0; i < bit_count; i += chunk_size) {
             size_t start = i + skip;
@@ -96,26 +97,26 @@ static vec_u8* cut_float3s(vec_u8* bytes, size_t bits, bool little_endian) {
         size_t byte_count;
         uint8_t* result_bytes = to_bytes(cut_bits, result_bit_count, &byte_count);
         vec_u8* result = vec_u8_new(byte_count);
-        for (size_t i = 0; i < byte_count; i++) {
-            vec_u8_push(result, result_bytes[i]);
-        }
+        if (result) vec_u8_extend(result, result_bytes, byte_count);
 
-        free(bitstream);
-        free(cut_bits);
-        free(result_bytes);
+        frad_free(bitstream);
+        frad_free(cut_bits);
+        frad_free(result_bytes);
         vec_u8_free(bytes);
         return result;
     } else {
         // Work with bytes directly
-        vec_u8* result = vec_u8_new(0);
         size_t chunk_size = size * 4 / 3;
+        vec_u8* result = vec_u8_new(bytes->size / chunk_size * size + size);
+        if (!result) {
+            vec_u8_free(bytes);
+            return NULL;
+        }
 
         for (size_t i = 0; i < bytes->size; i += chunk_size) {
             size_t start = i + skip;
             size_t end = (start + size < bytes->size) ? start + size : bytes->size;
-            for (size_t j = start; j < end; j++) {
-                vec_u8_push(result, bytes->data[j]);
-            }
+            if (start < end) vec_u8_extend(result, bytes->data + start, end - start);
         }
 
         vec_u8_free(bytes);
@@ -125,7 +126,7 @@ static vec_u8* cut_float3s(vec_u8* bytes, size_t bits, bool little_endian) {
 
 // pad_float3s
 // Pads floats to make them readable directly as 16, 32, or 64 bit floats
-static vec_u8* pad_float3s(vec_u8* bstr, size_t bits, bool little_endian) {
+static vec_u8* pad_float3s(const vec_u8* bstr, size_t bits, bool little_endian) {
     if (bits % 8 != 0) {
         // Convert to bitstream, pad, convert back
         size_t bit_count;
@@ -133,7 +134,7 @@ static vec_u8* pad_float3s(vec_u8* bstr, size_t bits, bool little_endian) {
 
         size_t pad_bits_count = bits / 3;
         size_t padded_size = (bit_count / bits) * (bits + pad_bits_count);
-        bool* padded = (bool*)calloc(padded_size, sizeof(bool));
+        bool* padded = (bool*)frad_calloc(padded_size, sizeof(bool));
         size_t padded_idx = 0;
 
         for (size_t i = 0; i < bit_count; i += bits) {
@@ -161,39 +162,30 @@ static vec_u8* pad_float3s(vec_u8* bstr, size_t bits, bool little_endian) {
         size_t byte_count;
         uint8_t* result_bytes = to_bytes(padded, padded_idx, &byte_count);
         vec_u8* result = vec_u8_new(byte_count);
-        for (size_t i = 0; i < byte_count; i++) {
-            vec_u8_push(result, result_bytes[i]);
-        }
+        if (result) vec_u8_extend(result, result_bytes, byte_count);
 
-        free(bitstream);
-        free(padded);
-        free(result_bytes);
+        frad_free(bitstream);
+        frad_free(padded);
+        frad_free(result_bytes);
         return result;
     } else {
         // Work with bytes directly
-        vec_u8* result = vec_u8_new(0);
         size_t chunk_size = bits / 8;
         size_t pad_bytes = bits / 24;
+        vec_u8* result = vec_u8_new(bstr->size / chunk_size * (chunk_size + pad_bytes));
+        if (!result) return NULL;
 
         for (size_t i = 0; i < bstr->size; i += chunk_size) {
             if (i + chunk_size > bstr->size) break;
 
             if (!little_endian) {
                 // Add original bytes then padding
-                for (size_t j = i; j < i + chunk_size; j++) {
-                    vec_u8_push(result, bstr->data[j]);
-                }
-                for (size_t j = 0; j < pad_bytes; j++) {
-                    vec_u8_push(result, 0);
-                }
+                vec_u8_extend(result, bstr->data + i, chunk_size);
+                vec_u8_resize(result, result->size + pad_bytes);
             } else {
                 // Add padding then original bytes
-                for (size_t j = 0; j < pad_bytes; j++) {
-                    vec_u8_push(result, 0);
-                }
-                for (size_t j = i; j < i + chunk_size; j++) {
-                    vec_u8_push(result, bstr->data[j]);
-                }
+                vec_u8_resize(result, result->size + pad_bytes);
+                vec_u8_extend(result, bstr->data + i, chunk_size);
             }
         }
 
@@ -204,16 +196,18 @@ static vec_u8* pad_float3s(vec_u8* bstr, size_t bits, bool little_endian) {
 static vec_u8* pack_f16(const vec_f64* input, bool little_endian) {
     vec_u8* bytes = vec_u8_new(input->size * 2);
     if (!bytes) return NULL;
+    vec_u8_resize(bytes, input->size * 2);
+    uint8_t* out = bytes->data;
 
-    for (size_t i = 0; i < input->size; i++) {
+    for (size_t i = 0; i < input->size; i++, out += 2) {
         uint16_t f16_bits = f64_to_f16(input->data[i]);
 
         if (!little_endian) {
-            vec_u8_push(bytes, (f16_bits >> 8) & 0xFF);
-            vec_u8_push(bytes, f16_bits & 0xFF);
+            out[0] = (f16_bits >> 8) & 0xFF;
+            out[1] = f16_bits & 0xFF;
         } else {
-            vec_u8_push(bytes, f16_bits & 0xFF);
-            vec_u8_push(bytes, (f16_bits >> 8) & 0xFF);
+            out[0] = f16_bits & 0xFF;
+            out[1] = (f16_bits >> 8) & 0xFF;
         }
     }
     return bytes;
@@ -222,20 +216,16 @@ static vec_u8* pack_f16(const vec_f64* input, bool little_endian) {
 static vec_u8* pack_f32(const vec_f64* input, bool little_endian) {
     vec_u8* bytes = vec_u8_new(input->size * 4);
     if (!bytes) return NULL;
+    vec_u8_resize(bytes, input->size * 4);
+    uint8_t* out = bytes->data;
 
-    for (size_t i = 0; i < input->size; i++) {
+    for (size_t i = 0; i < input->size; i++, out += 4) {
         float val = (float)input->data[i];
         uint32_t bits;
         memcpy(&bits, &val, 4);
 
-        if (!little_endian) {
-            for (int j = 3; j >= 0; j--) {
-                vec_u8_push(bytes, (bits >> (j * 8)) & 0xFF);
-            }
-        } else {
-            for (int j = 0; j < 4; j++) {
-                vec_u8_push(bytes, (bits >> (j * 8)) & 0xFF);
-            }
+        for (int j = 0; j < 4; j++) {
+            out[little_endian ? j : 3 - j] = (bits >> (j * 8)) & 0xFF;
         }
     }
     return bytes;
@@ -244,19 +234,15 @@ static vec_u8* pack_f32(const vec_f64* input, bool little_endian) {
 static vec_u8* pack_f64(const vec_f64* input, bool little_endian) {
     vec_u8* bytes = vec_u8_new(input->size * 8);
     if (!bytes) return NULL;
+    vec_u8_resize(bytes, input->size * 8);
+    uint8_t* out = bytes->data;
 
-    for (size_t i = 0; i < input->size; i++) {
+    for (size_t i = 0; i < input->size; i++, out += 8) {
         uint64_t bits;
         memcpy(&bits, &input->data[i], 8);
 
-        if (!little_endian) {
-            for (int j = 7; j >= 0; j--) {
-                vec_u8_push(bytes, (bits >> (j * 8)) & 0xFF);
-            }
-        } else {
-            for (int j = 0; j < 8; j++) {
-                vec_u8_push(bytes, (bits >> (j * 8)) & 0xFF);
-            }
+        for (int j = 0; j < 8; j++) {
+            out[little_endian ? j : 7 - j] = (bits >> (j * 8)) & 0xFF;
         }
     }
     return bytes;
@@ -360,17 +346,13 @@ vec_f64* u8pack_unpack(const vec_u8* input, uint16_t bits, bool little_endian) {
     size_t bits_size = bits;
     if (bits % 8 != 0) little_endian = false;
 
-    // Create a mutable copy if we need to pad
+    // Pad into a new vector if the floats are cut
     vec_u8* work_input = NULL;
     const vec_u8* input_to_use = input;
 
     if (bits % 3 == 0) {
-        // Create a copy for padding
-        vec_u8* input_copy = vec_u8_new(input->size);
-        for (size_t i = 0; i < input->size; i++) {
-            vec_u8_push(input_copy, input->data[i]);
-        }
-        work_input = pad_float3s(input_copy, bits_size, little_endian);
+        work_input = pad_float3s(input, bits_size, little_endian);
+        if (!work_input) return NULL;
         input_to_use = work_input;
     }
 
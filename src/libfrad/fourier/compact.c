@@ -64,6 +64,16 @@ uint32_t get_samples_min_ge(uint32_t value) {
     return 0;
 }
 
+// Get maximum sample count less than or equal to given value, the smallest one if none is
+uint32_t get_samples_max_le(uint32_t value) {
+    for (size_t i = COMPACT_SAMPLES_SIZE; i > 0; i--) {
+        if (COMPACT_SAMPLES[i - 1] <= value) {
+            return COMPACT_SAMPLES[i - 1];
+        }
+    }
+    return COMPACT_SAMPLES[0];
+}
+
 // Get sample count index of given value
 uint16_t get_samples_index(uint32_t value) {
     value = get_samples_min_ge(value);
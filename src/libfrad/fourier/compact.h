@@ -20,6 +20,9 @@ uint16_t get_srate_index(uint32_t srate);
 // Get minimum sample count greater than or equal to given value
 uint32_t get_samples_min_ge(uint32_t value);
 
+// Get maximum sample count less than or equal to given value, the smallest one if none is
+uint32_t get_samples_max_le(uint32_t value);
+
 // Get sample count index of given value
 uint16_t get_samples_index(uint32_t value);
 
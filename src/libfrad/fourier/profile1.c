@@ -2,10 +2,10 @@
 #include "backend/dct_core.h"
 #include "tools/p1tools.h"
 #include "compact.h"
+#include "../backend/arena.h"
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
-#include <zlib.h>
 
 const uint16_t PROFILE1_DEPTHS[] = {8, 12, 16, 24, 32, 48, 64, 0};
 const size_t PROFILE1_DEPTHS_COUNT = 7;
@@ -14,125 +14,189 @@ static double get_scale_factor(uint16_t bit_depth) {
     return pow(2.0, (double)bit_depth - 1.0);
 }
 
-encoded_packet* profile1_analogue(const double* pcm, size_t pcm_len, uint16_t bit_depth,
-                                 uint16_t channels, uint32_t srate, double loss_level, bool little_endian) {
-    (void)little_endian; // Not used in encoding
+// Deepest bit depth the single precision path is used for, beyond it float
+// rounding of the coefficients reaches the quantisation step
+#define PROFILE1_F32_MAX_DEPTH 16
 
-    if (bit_depth == 0) bit_depth = 16;
-    double pcm_scale = get_scale_factor(bit_depth);
-    loss_level = fmax(fabs(loss_level), 0.125);
-    srate = get_valid_srate(srate);
-
-    // 1. Pad PCM to nearest valid sample count
-    size_t samples_per_channel = pcm_len / channels;
-    size_t padded_samples = get_samples_min_ge(samples_per_channel);
+// Padded interleaved PCM to interleaved DCT bins in single precision
+static float* analogue_dct_f32(const double* pcm, size_t pcm_len, size_t padded_samples, uint16_t channels,
+                               workpool_t* pool) {
     size_t padded_len = padded_samples * channels;
-
-    vec_f64* pcm_vec = vec_f64_new(padded_len);
-    if (!pcm_vec) return NULL;
-
-    // Copy original PCM and pad with zeros
-    for (size_t i = 0; i < pcm_len; i++) {
-        vec_f64_push(pcm_vec, pcm[i]);
-    }
-    for (size_t i = pcm_len; i < padded_len; i++) {
-        vec_f64_push(pcm_vec, 0.0);
-    }
-
-    // Prepare arrays for all channels
-    int64_t* freqs_masked_all = (int64_t*)calloc(padded_len, sizeof(int64_t));
-    int64_t* thres_all = (int64_t*)calloc(MOSLEN * channels, sizeof(int64_t));
-
-    if (!freqs_masked_all || !thres_all) {
-        vec_f64_free(pcm_vec);
-        free(freqs_masked_all);
-        free(thres_all);
+    float* buf = (float*)frad_malloc(padded_len * 2 * sizeof(float));
+    if (!buf) return NULL;
+
+    float* freqs = buf + padded_len;
+    for (size_t i = 0; i < pcm_len; i++) buf[i] = (float)pcm[i];
+    for (size_t i = pcm_len; i < padded_len; i++) buf[i] = 0.0f;
+    if (!dct_batch_f32_parallel(buf, freqs, padded_samples, channels, pool)) {
+        frad_free(buf);
         return NULL;
     }
+    // Bins first, the PCM half is scratch from here on
+    memmove(buf, freqs, padded_len * sizeof(float));
+    return buf;
+}
 
-    // 2. Process each channel separately
-    for (size_t c = 0; c < channels; c++) {
-        // Extract channel data
-        vec_f64* pcm_chnl = vec_f64_new(0);
-        for (size_t i = c; i < padded_len; i += channels) {
-            vec_f64_push(pcm_chnl, pcm_vec->data[i]);
-        }
-
-        // 2.1 DCT
-        vec_f64* freqs_chnl = dct(pcm_chnl);
-        vec_f64_free(pcm_chnl);
-        if (!freqs_chnl) {
-            vec_f64_free(pcm_vec);
-            free(freqs_masked_all);
-            free(thres_all);
-            return NULL;
-        }
+// Steps 2.1 to 2.3 of profile1_analogue, channels are independent
+typedef struct {
+    const double* freqs;
+    const float* freqs_f32;  // Used instead of freqs when set
+    size_t padded_samples;
+    uint16_t channels;
+    uint32_t srate;
+    double loss_level;
+    double pcm_scale;
+    int64_t* freqs_masked_all;
+    int64_t* thres_all;
+    bool* failed;  // Per channel
+} analogue_mask_job;
+
+static void analogue_mask_channels(void* ctx, size_t begin, size_t end) {
+    analogue_mask_job* job = (analogue_mask_job*)ctx;
+    size_t padded_samples = job->padded_samples;
+    size_t channels = job->channels;
+    double pcm_scale = job->pcm_scale;
+
+    vec_f64* freqs_scaled = vec_f64_new(padded_samples);
+    double* div_factor = (double*)frad_malloc(padded_samples * sizeof(double));
+    float* masked_f32 = job->freqs_f32 ? (float*)frad_malloc(padded_samples * sizeof(float)) : NULL;
+    if (!freqs_scaled || !div_factor || (job->freqs_f32 && !masked_f32)) {
+        for (size_t c = begin; c < end; c++) job->failed[c] = true;
+        vec_f64_free(freqs_scaled);
+        frad_free(div_factor);
+        frad_free(masked_f32);
+        return;
+    }
+    freqs_scaled->size = padded_samples;
 
+    for (size_t c = begin; c < end; c++) {
         // Scale frequencies for masking calculation
-        vec_f64* freqs_scaled = vec_f64_new(freqs_chnl->size);
-        for (size_t i = 0; i < freqs_chnl->size; i++) {
-            vec_f64_push(freqs_scaled, freqs_chnl->data[i] * pcm_scale);
+        for (size_t i = 0; i < padded_samples; i++) {
+            double freq = job->freqs_f32 ? job->freqs_f32[i * channels + c] : job->freqs[i * channels + c];
+            freqs_scaled->data[i] = freq * pcm_scale;
         }
 
-        // 2.2 Calculate masking threshold
-        vec_f64* thres_chnl = mask_thres_mos(freqs_scaled, srate, loss_level, SPREAD_ALPHA);
-        vec_f64_free(freqs_scaled);
+        // 2.1 Calculate masking threshold
+        vec_f64* thres_chnl = mask_thres_mos(freqs_scaled, job->srate, job->loss_level, SPREAD_ALPHA);
         if (!thres_chnl) {
-            vec_f64_free(pcm_vec);
-            vec_f64_free(freqs_chnl);
-            free(freqs_masked_all);
-            free(thres_all);
-            return NULL;
-        }
-
-        // 2.3 Remap thresholds to DCT bins
-        vec_f64* div_factor = mapping_from_opus(thres_chnl, freqs_chnl->size, srate);
-        if (!div_factor) {
-            vec_f64_free(pcm_vec);
-            vec_f64_free(freqs_chnl);
-            vec_f64_free(thres_chnl);
-            free(freqs_masked_all);
-            free(thres_all);
-            return NULL;
+            job->failed[c] = true;
+            continue;
         }
 
-        // Replace zeros with infinity
-        for (size_t i = 0; i < div_factor->size; i++) {
-            if (div_factor->data[i] == 0.0) {
-                div_factor->data[i] = INFINITY;
+        // 2.2 Remap thresholds to DCT bins
+        mapping_from_opus(thres_chnl, padded_samples, job->srate, div_factor);
+
+        // 2.3 Apply psychoacoustic masking and quantise, zero divisors mask to zero.
+        // The scaled spectrum is no longer needed and holds the masked one.
+        if (job->freqs_f32) {
+            float scale = (float)pcm_scale;
+            for (size_t i = 0; i < padded_samples; i++) {
+                float div = div_factor[i] == 0.0 ? INFINITY : (float)div_factor[i];
+                float masked = job->freqs_f32[i * channels + c] / div;
+                masked_f32[i] = masked * scale;
             }
+            quant_array_f32(masked_f32, padded_samples, job->freqs_masked_all + c, channels);
+        } else {
+            for (size_t i = 0; i < padded_samples; i++) {
+                double div = div_factor[i] == 0.0 ? INFINITY : div_factor[i];
+                double masked = job->freqs[i * channels + c] / div;
+                freqs_scaled->data[i] = masked * pcm_scale;
+            }
+            quant_array(freqs_scaled->data, padded_samples, job->freqs_masked_all + c, channels);
         }
 
-        // 2.4 Apply psychoacoustic masking
-        vec_f64* freqs_masked_chnl = vec_f64_new(freqs_chnl->size);
-        for (size_t i = 0; i < freqs_chnl->size; i++) {
-            vec_f64_push(freqs_masked_chnl, freqs_chnl->data[i] / div_factor->data[i]);
-        }
-        vec_f64_free(freqs_chnl);
-        vec_f64_free(div_factor);
-
-        // 2.5 Quantization
-        for (size_t i = 0; i < freqs_masked_chnl->size; i++) {
-            freqs_masked_all[i * channels + c] = (int64_t)round(quant(freqs_masked_chnl->data[i] * pcm_scale));
-        }
-        vec_f64_free(freqs_masked_chnl);
-
         // Store thresholds
         for (size_t i = 0; i < MOSLEN && i < thres_chnl->size; i++) {
             double val = fmax(1.0, thres_chnl->data[i]);
-            thres_all[i * channels + c] = (int64_t)round(dequant(log(val) / log(M_E / 2.0)));
+            job->thres_all[i * channels + c] = (int64_t)round(dequant(log(val) / log(M_E / 2.0)));
         }
         vec_f64_free(thres_chnl);
     }
+    vec_f64_free(freqs_scaled);
+    frad_free(div_factor);
+    frad_free(masked_f32);
+}
+
+encoded_packet* profile1_analogue(const double* pcm, size_t pcm_len, uint16_t bit_depth,
+                                 uint16_t channels, uint32_t srate, double loss_level, bool little_endian,
+                                 bool f32, workpool_t* pool, zstream_cache* zs) {
+    (void)little_endian; // Not used in encoding
+
+    if (bit_depth == 0) bit_depth = 16;
+    double pcm_scale = get_scale_factor(bit_depth);
+    loss_level = fmax(fabs(loss_level), 0.125);
+    srate = get_valid_srate(srate);
+    f32 = f32 && bit_depth <= PROFILE1_F32_MAX_DEPTH;
+
+    // 1. Pad PCM to nearest valid sample count
+    size_t samples_per_channel = pcm_len / channels;
+    size_t padded_samples = get_samples_min_ge(samples_per_channel);
+    size_t padded_len = padded_samples * channels;
+
+    // Prepare arrays for all channels
+    int64_t* freqs_masked_all = (int64_t*)frad_calloc(padded_len, sizeof(int64_t));
+    int64_t* thres_all = (int64_t*)frad_calloc(MOSLEN * channels, sizeof(int64_t));
+    bool* failed = (bool*)frad_calloc(channels, sizeof(bool));
+
+    if (!freqs_masked_all || !thres_all || !failed) {
+        frad_free(freqs_masked_all);
+        frad_free(thres_all);
+        frad_free(failed);
+        return NULL;
+    }
+
+    // 2. DCT of every channel at once, interleaved, in the selected precision
+    vec_f64* freqs = NULL;
+    float* freqs_f32 = NULL;
+    if (f32) {
+        freqs_f32 = analogue_dct_f32(pcm, pcm_len, padded_samples, channels, pool);
+    } else {
+        vec_f64* pcm_vec = vec_f64_new(padded_len);
+        freqs = vec_f64_new(padded_len);
+        if (pcm_vec && freqs) {
+            // Copy original PCM and pad with zeros
+            vec_f64_extend(pcm_vec, pcm, pcm_len);
+            vec_f64_resize(pcm_vec, padded_len);
+            if (dct_batch_parallel(pcm_vec->data, freqs->data, padded_samples, channels, pool)) {
+                freqs->size = padded_len;
+            } else {
+                vec_f64_free(freqs);
+                freqs = NULL;
+            }
+        }
+        vec_f64_free(pcm_vec);
+    }
+    if (!freqs && !freqs_f32) {
+        frad_free(failed);
+        frad_free(freqs_masked_all);
+        frad_free(thres_all);
+        return NULL;
+    }
 
-    vec_f64_free(pcm_vec);
+    // 2.1-2.3. Masking and quantisation, fanned out across the pool if there is one
+    analogue_mask_job job = {
+        freqs ? freqs->data : NULL, freqs_f32, padded_samples, channels, srate, loss_level, pcm_scale,
+        freqs_masked_all, thres_all, failed
+    };
+    workpool_parallel_for(pool, channels, 1, analogue_mask_channels, &job);
+    bool ok = true;
+    for (size_t c = 0; c < channels; c++) ok = ok && !failed[c];
+
+    vec_f64_free(freqs);
+    frad_free(freqs_f32);
+    frad_free(failed);
+    if (!ok) {
+        frad_free(freqs_masked_all);
+        frad_free(thres_all);
+        return NULL;
+    }
 
     // 3. Exponential Golomb-Rice encoding
     vec_u8* freqs_gol = exp_golomb_encode(freqs_masked_all, padded_len);
     vec_u8* thres_gol = exp_golomb_encode(thres_all, MOSLEN * channels);
 
-    free(freqs_masked_all);
-    free(thres_all);
+    frad_free(freqs_masked_all);
+    frad_free(thres_all);
 
     if (!freqs_gol || !thres_gol) {
         vec_u8_free(freqs_gol);
@@ -150,60 +214,26 @@ encoded_packet* profile1_analogue(const double* pcm, size_t pcm_len, uint16_t bi
 
     // Add threshold length as big-endian u32
     uint32_t thres_len = thres_gol->size;
-    vec_u8_push(combined, (thres_len >> 24) & 0xFF);
-    vec_u8_push(combined, (thres_len >> 16) & 0xFF);
-    vec_u8_push(combined, (thres_len >> 8) & 0xFF);
-    vec_u8_push(combined, thres_len & 0xFF);
+    uint8_t thres_len_be[4] = {
+        (thres_len >> 24) & 0xFF, (thres_len >> 16) & 0xFF, (thres_len >> 8) & 0xFF, thres_len & 0xFF
+    };
+    vec_u8_extend(combined, thres_len_be, 4);
 
     // Add thresholds
-    for (size_t i = 0; i < thres_gol->size; i++) {
-        vec_u8_push(combined, thres_gol->data[i]);
-    }
+    vec_u8_extend(combined, thres_gol->data, thres_gol->size);
 
     // Add frequencies
-    for (size_t i = 0; i < freqs_gol->size; i++) {
-        vec_u8_push(combined, freqs_gol->data[i]);
-    }
+    vec_u8_extend(combined, freqs_gol->data, freqs_gol->size);
 
     vec_u8_free(freqs_gol);
     vec_u8_free(thres_gol);
 
     // 5. Raw Deflate compression (no zlib header)
-    z_stream strm;
-    memset(&strm, 0, sizeof(strm));
-
-    // Use deflateInit2 with -15 for raw deflate (no header)
-    if (deflateInit2(&strm, Z_BEST_COMPRESSION, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
-        vec_u8_free(combined);
-        return NULL;
-    }
-
-    uLongf dest_len = deflateBound(&strm, combined->size);
-    vec_u8* frad = vec_u8_new(dest_len);
-    if (!frad) {
-        deflateEnd(&strm);
-        vec_u8_free(combined);
-        return NULL;
-    }
-
-    strm.avail_in = combined->size;
-    strm.next_in = combined->data;
-    strm.avail_out = dest_len;
-    strm.next_out = frad->data;
-
-    int res = deflate(&strm, Z_FINISH);
-    if (res != Z_STREAM_END) {
-        deflateEnd(&strm);
-        vec_u8_free(frad);
-        vec_u8_free(combined);
-        return NULL;
-    }
-
-    frad->size = strm.total_out;
-    deflateEnd(&strm);
+    vec_u8* frad = zstream_deflate(zs, combined->data, combined->size);
     vec_u8_free(combined);
+    if (!frad) return NULL;
 
-    encoded_packet* packet = (encoded_packet*)malloc(sizeof(encoded_packet));
+    encoded_packet* packet = (encoded_packet*)frad_malloc(sizeof(encoded_packet));
     if (!packet) {
         vec_u8_free(frad);
         return NULL;
@@ -226,80 +256,124 @@ encoded_packet* profile1_analogue(const double* pcm, size_t pcm_len, uint16_t bi
     return packet;
 }
 
-vec_f64* profile1_digital(const uint8_t* frad, size_t frad_len, uint16_t bit_depth_index,
-                         uint16_t channels, uint32_t srate, uint32_t fsize, bool little_endian) {
-    (void)little_endian; // Not used in profile1
-
-    if (bit_depth_index >= PROFILE1_DEPTHS_COUNT) return NULL;
-
-    uint16_t bit_depth = PROFILE1_DEPTHS[bit_depth_index];
-    double pcm_scale = get_scale_factor(bit_depth);
+// Step 4.1 of profile1_digital, channels are independent
+typedef struct {
+    double* freqs;
+    float* freqs_f32;  // Used instead of freqs when set
+    const vec_f64* thres;
+    uint16_t channels;
+    uint32_t srate;
+    uint32_t fsize;
+    bool* failed;  // Per channel
+} digital_unmask_job;
+
+static void digital_unmask_channels(void* ctx, size_t begin, size_t end) {
+    digital_unmask_job* job = (digital_unmask_job*)ctx;
+    size_t channels = job->channels;
+
+    vec_f64* thres_chnl = vec_f64_new(MOSLEN);
+    double* mapping = (double*)frad_malloc(job->fsize * sizeof(double));
+    if (!thres_chnl || (!mapping && job->fsize > 0)) {
+        for (size_t c = begin; c < end; c++) job->failed[c] = true;
+        vec_f64_free(thres_chnl);
+        frad_free(mapping);
+        return;
+    }
+    thres_chnl->size = MOSLEN;
 
-    // 1. Raw Deflate decompression (no zlib header)
-    z_stream strm;
-    memset(&strm, 0, sizeof(strm));
+    for (size_t c = begin; c < end; c++) {
+        for (size_t i = 0; i < MOSLEN; i++) {
+            thres_chnl->data[i] = job->thres->data[i * channels + c];
+        }
 
-    if (inflateInit2(&strm, -15) != Z_OK) {
-        // Return silent frame on decompression error
-        vec_f64* pcm = vec_f64_new(fsize * channels);
-        if (pcm) {
-            for (size_t i = 0; i < fsize * channels; i++) {
-                vec_f64_push(pcm, 0.0);
+        // 4.1. Inverse masking, in place on the interleaved frequencies
+        mapping_from_opus(thres_chnl, job->fsize, job->srate, mapping);
+        if (job->freqs_f32) {
+            for (size_t i = 0; i < job->fsize; i++) {
+                job->freqs_f32[i * channels + c] *= (float)mapping[i];
+            }
+        } else {
+            for (size_t i = 0; i < job->fsize; i++) {
+                job->freqs[i * channels + c] *= mapping[i];
             }
         }
-        return pcm;
     }
+    vec_f64_free(thres_chnl);
+    frad_free(mapping);
+}
 
-    // Start with a reasonable initial size
-    size_t decomp_capacity = frad_len * 4; // Typical compression ratio
-    uint8_t* decompressed = (uint8_t*)malloc(decomp_capacity);
-    if (!decompressed) {
-        inflateEnd(&strm);
+// Inverse masking of every channel, false if any of them failed
+static bool digital_unmask(double* freqs, float* freqs_f32, const vec_f64* thres, uint16_t channels,
+                           uint32_t srate, uint32_t fsize, workpool_t* pool) {
+    bool* failed = (bool*)frad_calloc(channels, sizeof(bool));
+    if (!failed) return false;
+
+    digital_unmask_job job = { freqs, freqs_f32, thres, channels, srate, fsize, failed };
+    workpool_parallel_for(pool, channels, 1, digital_unmask_channels, &job);
+    bool ok = true;
+    for (size_t c = 0; c < channels; c++) ok = ok && !failed[c];
+    frad_free(failed);
+    return ok;
+}
+
+// Dequantisation, inverse masking and inverse DCT of profile1_digital in single precision
+static vec_f64* digital_synth_f32(const vec_i64* freqs_decoded, const vec_f64* thres, double pcm_scale,
+                                  uint16_t channels, uint32_t srate, uint32_t fsize, workpool_t* pool) {
+    size_t len = (size_t)fsize * channels;
+    float* buf = (float*)frad_malloc(len * 2 * sizeof(float));
+    vec_f64* pcm = vec_f64_new(len);
+    if (!buf || !pcm) {
+        frad_free(buf);
+        vec_f64_free(pcm);
         return NULL;
     }
-
-    strm.avail_in = frad_len;
-    strm.next_in = (Bytef*)frad;
-    strm.avail_out = decomp_capacity;
-    strm.next_out = decompressed;
-
-    int result;
-    while ((result = inflate(&strm, Z_NO_FLUSH)) == Z_OK) {
-        if (strm.avail_out == 0) {
-            // Need more output space
-            size_t used = decomp_capacity;
-            decomp_capacity *= 2;
-            uint8_t* new_buf = (uint8_t*)realloc(decompressed, decomp_capacity);
-            if (!new_buf) {
-                free(decompressed);
-                inflateEnd(&strm);
-                return NULL;
-            }
-            decompressed = new_buf;
-            strm.avail_out = decomp_capacity - used;
-            strm.next_out = decompressed + used;
-        }
+    float* freqs = buf;
+    float* out = buf + len;
+    float scale = (float)(1.0 / pcm_scale);
+    size_t count = freqs_decoded->size < len ? freqs_decoded->size : len;
+    dequant_array_f32(freqs_decoded->data, count, scale, freqs);
+    for (size_t i = count; i < len; i++) freqs[i] = 0.0f;
+
+    if (!digital_unmask(NULL, freqs, thres, channels, srate, fsize, pool) ||
+        (fsize > 0 && !idct_batch_f32_parallel(freqs, out, fsize, channels, pool))) {
+        frad_free(buf);
+        vec_f64_free(pcm);
+        return NULL;
     }
+    for (size_t i = 0; i < len; i++) pcm->data[i] = out[i];
+    pcm->size = len;
+    frad_free(buf);
+    return pcm;
+}
+
+vec_f64* profile1_digital(const uint8_t* frad, size_t frad_len, uint16_t bit_depth_index,
+                         uint16_t channels, uint32_t srate, uint32_t fsize, bool little_endian,
+                         bool f32, workpool_t* pool, zstream_cache* zs) {
+    (void)little_endian; // Not used in profile1
+
+    if (bit_depth_index >= PROFILE1_DEPTHS_COUNT) return NULL;
 
-    if (result != Z_STREAM_END) {
-        inflateEnd(&strm);
-        free(decompressed);
+    uint16_t bit_depth = PROFILE1_DEPTHS[bit_depth_index];
+    double pcm_scale = get_scale_factor(bit_depth);
+    f32 = f32 && bit_depth <= PROFILE1_F32_MAX_DEPTH;
+
+    // 1. Raw Deflate decompression (no zlib header), sized for the frame's
+    // coefficients: they share one Golomb k, so each code is at most k + 3
+    // bits, and k follows the quantised bit depth, 3/4 of the PCM one, plus
+    // the gain of the transform
+    size_t decomp_hint = 4 + ((size_t)fsize + MOSLEN) * channels * (bit_depth * 3 / 4 + 8) / 8;
+    size_t decomp_len = 0;
+    uint8_t* decompressed = zstream_inflate(zs, frad, frad_len, decomp_hint, &decomp_len);
+    if (!decompressed) {
         // Return silent frame on decompression error
         vec_f64* pcm = vec_f64_new(fsize * channels);
-        if (pcm) {
-            for (size_t i = 0; i < fsize * channels; i++) {
-                vec_f64_push(pcm, 0.0);
-            }
-        }
+        if (pcm) vec_f64_resize(pcm, fsize * channels);
         return pcm;
     }
 
-    unsigned long decomp_len = strm.total_out;
-    inflateEnd(&strm);
-
     // 2. Split thresholds and frequencies
     if (decomp_len < 4) {
-        free(decompressed);
+        frad_free(decompressed);
         return NULL;
     }
 
@@ -309,120 +383,80 @@ vec_f64* profile1_digital(const uint8_t* frad, size_t frad_len, uint16_t bit_dep
                          ((uint32_t)decompressed[3]);
 
     if (thres_len > decomp_len - 4) {
-        free(decompressed);
+        frad_free(decompressed);
         return NULL;
     }
 
-    // 3. Exponential Golomb-Rice decoding
-    vec_u8* thres_gol = vec_u8_new(thres_len);
-    for (size_t i = 0; i < thres_len; i++) {
-        vec_u8_push(thres_gol, decompressed[4 + i]);
-    }
-
-    vec_u8* freqs_gol = vec_u8_new(decomp_len - 4 - thres_len);
-    for (size_t i = 0; i < decomp_len - 4 - thres_len; i++) {
-        vec_u8_push(freqs_gol, decompressed[4 + thres_len + i]);
-    }
-
-    free(decompressed);
+    // 3. Exponential Golomb-Rice decoding, read in place from the inflated buffer
+    vec_u8 thres_gol = vec_u8_view(decompressed + 4, thres_len);
+    vec_u8 freqs_gol = vec_u8_view(decompressed + 4 + thres_len, decomp_len - 4 - thres_len);
 
     // Decode thresholds and frequencies
     size_t thres_count = 0, freqs_count = 0;
-    int64_t* thres_decoded_raw = exp_golomb_decode(thres_gol, &thres_count);
-    int64_t* freqs_decoded_raw = exp_golomb_decode(freqs_gol, &freqs_count);
-    vec_u8_free(thres_gol);
-    vec_u8_free(freqs_gol);
+    int64_t* thres_decoded_raw = exp_golomb_decode(&thres_gol, MOSLEN * channels, &thres_count);
+    int64_t* freqs_decoded_raw = exp_golomb_decode(&freqs_gol, (size_t)fsize * channels, &freqs_count);
+    frad_free(decompressed);
 
     if (!thres_decoded_raw || !freqs_decoded_raw) {
-        free(thres_decoded_raw);
-        free(freqs_decoded_raw);
+        frad_free(thres_decoded_raw);
+        frad_free(freqs_decoded_raw);
         return NULL;
     }
 
-    // Convert to vec_i64
-    vec_i64* thres_decoded = vec_i64_new(thres_count);
-    vec_i64* freqs_decoded = vec_i64_new(freqs_count);
-    if (!thres_decoded || !freqs_decoded) {
-        free(thres_decoded_raw);
-        free(freqs_decoded_raw);
-        vec_i64_free(thres_decoded);
-        vec_i64_free(freqs_decoded);
-        return NULL;
-    }
+    vec_i64 freqs_decoded = vec_i64_view(freqs_decoded_raw, freqs_count);
 
-    for (size_t i = 0; i < thres_count; i++) {
-        vec_i64_push(thres_decoded, thres_decoded_raw[i]);
+    vec_f64* thres = vec_f64_new(MOSLEN * channels);
+    if (!thres) {
+        frad_free(thres_decoded_raw);
+        frad_free(freqs_decoded_raw);
+        return NULL;
     }
-    for (size_t i = 0; i < freqs_count; i++) {
-        vec_i64_push(freqs_decoded, freqs_decoded_raw[i]);
+    for (size_t i = 0; i < thres_count && i < MOSLEN * channels; i++) {
+        double val = pow(M_E / 2.0, quant((double)thres_decoded_raw[i]));
+        vec_f64_push(thres, val);
     }
+    // Pad with zeros if needed
+    vec_f64_resize(thres, MOSLEN * channels);
 
-    free(thres_decoded_raw);
-    free(freqs_decoded_raw);
+    frad_free(thres_decoded_raw);
 
-    // Convert to floating point and dequantize
-    vec_f64* freqs_masked = vec_f64_new(0);
-    for (size_t i = 0; i < freqs_decoded->size && i < fsize * channels; i++) {
-        double val = dequant((double)freqs_decoded->data[i]) / pcm_scale;
-        vec_f64_push(freqs_masked, val);
-    }
-    // Pad with zeros if needed
-    while (freqs_masked->size < fsize * channels) {
-        vec_f64_push(freqs_masked, 0.0);
+    if (f32) {
+        vec_f64* pcm = digital_synth_f32(&freqs_decoded, thres, pcm_scale, channels, srate, fsize, pool);
+        frad_free(freqs_decoded_raw);
+        vec_f64_free(thres);
+        return pcm;
     }
 
-    vec_f64* thres = vec_f64_new(0);
-    for (size_t i = 0; i < thres_decoded->size && i < MOSLEN * channels; i++) {
-        double val = pow(M_E / 2.0, quant((double)thres_decoded->data[i]));
-        vec_f64_push(thres, val);
+    // Convert to floating point and dequantize
+    vec_f64* freqs_masked = vec_f64_new(fsize * channels);
+    if (!freqs_masked) {
+        frad_free(freqs_decoded_raw);
+        vec_f64_free(thres);
+        return NULL;
     }
+    size_t count = freqs_count < (size_t)fsize * channels ? freqs_count : (size_t)fsize * channels;
+    dequant_array(freqs_decoded_raw, count, pcm_scale, freqs_masked->data);
+    freqs_masked->size = count;
     // Pad with zeros if needed
-    while (thres->size < MOSLEN * channels) {
-        vec_f64_push(thres, 0.0);
-    }
-
-    vec_i64_free(thres_decoded);
-    vec_i64_free(freqs_decoded);
+    vec_f64_resize(freqs_masked, fsize * channels);
+    frad_free(freqs_decoded_raw);
 
     // 4. Dequantisation and inverse masking
     vec_f64* pcm = vec_f64_new(fsize * channels);
-
-    for (uint16_t c = 0; c < channels; c++) {
-        // Extract channel data
-        vec_f64* freqs_masked_chnl = vec_f64_new(0);
-        vec_f64* thres_chnl = vec_f64_new(0);
-
-        for (size_t i = c; i < fsize * channels; i += channels) {
-            vec_f64_push(freqs_masked_chnl, freqs_masked->data[i]);
-        }
-
-        for (size_t i = c; i < MOSLEN * channels; i += channels) {
-            vec_f64_push(thres_chnl, thres->data[i]);
-        }
-
-        // 4.1. Inverse masking
-        vec_f64* mapping = mapping_from_opus(thres_chnl, fsize, srate);
-        vec_f64* freqs_chnl = vec_f64_new(freqs_masked_chnl->size);
-
-        for (size_t i = 0; i < freqs_masked_chnl->size && i < mapping->size; i++) {
-            vec_f64_push(freqs_chnl, freqs_masked_chnl->data[i] * mapping->data[i]);
-        }
-
-        // 4.2. Inverse DCT
-        vec_f64* pcm_chnl = idct(freqs_chnl);
-
-        // Store results directly in interleaved format
-        for (size_t i = 0; i < pcm_chnl->size && i < fsize; i++) {
-            pcm->data[i * channels + c] = pcm_chnl->data[i];
-        }
-
-        vec_f64_free(freqs_masked_chnl);
-        vec_f64_free(thres_chnl);
-        vec_f64_free(mapping);
-        vec_f64_free(freqs_chnl);
-        vec_f64_free(pcm_chnl);
+    if (!pcm || !digital_unmask(freqs_masked->data, NULL, thres, channels, srate, fsize, pool)) {
+        vec_f64_free(pcm);
+        vec_f64_free(freqs_masked);
+        vec_f64_free(thres);
+        return NULL;
     }
 
+    // 4.2. Inverse DCT of every channel at once
+    if (fsize > 0 && !idct_batch_parallel(freqs_masked->data, pcm->data, fsize, channels, pool)) {
+        vec_f64_free(pcm);
+        vec_f64_free(freqs_masked);
+        vec_f64_free(thres);
+        return NULL;
+    }
     pcm->size = fsize * channels;
 
     vec_f64_free(freqs_masked);
@@ -5,15 +5,22 @@
 #include <stddef.h>
 #include <stdbool.h>
 #include "../common.h"
+#include "../backend/workpool.h"
+#include "tools/zstream.h"
 
 // Bit depth table
 extern const uint16_t PROFILE1_DEPTHS[];
 extern const size_t PROFILE1_DEPTHS_COUNT;
 
 // Profile 1 functions (lossy with psychoacoustic masking)
+// f32 runs the transform and quantisation in single precision, honoured for bit depths up to 16
+// pool, if not NULL, takes the channels of the frame in parallel
+// zs, if not NULL, holds the deflate/inflate stream reused from frame to frame
 encoded_packet* profile1_analogue(const double* pcm, size_t pcm_len, uint16_t bit_depth,
-                                 uint16_t channels, uint32_t srate, double loss_level, bool little_endian);
+                                 uint16_t channels, uint32_t srate, double loss_level, bool little_endian,
+                                 bool f32, workpool_t* pool, zstream_cache* zs);
 vec_f64* profile1_digital(const uint8_t* frad, size_t frad_len, uint16_t bit_depth_index,
-                         uint16_t channels, uint32_t srate, uint32_t fsize, bool little_endian);
+                         uint16_t channels, uint32_t srate, uint32_t fsize, bool little_endian,
+                         bool f32, workpool_t* pool, zstream_cache* zs);
 
 #endif
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "profile4.h"
 #include "backend/u8pack.h"
+#include "../backend/arena.h"
 #include <stdlib.h>
 #include <math.h>
 
@@ -31,20 +32,12 @@ encoded_packet* profile4_analogue(const double* pcm, size_t pcm_len, uint16_t bi
         return NULL; // Overflow
     }
 
-    // Create vec_f64 from pcm data
-    vec_f64* pcm_vec = vec_f64_new(pcm_len);
-    if (!pcm_vec) return NULL;
-
-    for (size_t i = 0; i < pcm_len; i++) {
-        vec_f64_push(pcm_vec, pcm[i]);
-    }
-
-    // Pack the data
-    vec_u8* frad = u8pack_pack(pcm_vec, PROFILE4_DEPTHS[bit_depth_index], little_endian);
-    vec_f64_free(pcm_vec);
+    // Pack the data, read in place through a view
+    vec_f64 pcm_vec = vec_f64_view(pcm, pcm_len);
+    vec_u8* frad = u8pack_pack(&pcm_vec, PROFILE4_DEPTHS[bit_depth_index], little_endian);
     if (!frad) return NULL;
 
-    encoded_packet* packet = (encoded_packet*)malloc(sizeof(encoded_packet));
+    encoded_packet* packet = (encoded_packet*)frad_malloc(sizeof(encoded_packet));
     if (!packet) {
         vec_u8_free(frad);
         return NULL;
@@ -66,17 +59,9 @@ vec_f64* profile4_digital(const uint8_t* frad, size_t frad_len, uint16_t bit_dep
         return NULL;
     }
 
-    // Create vec_u8 wrapper for frad data
-    vec_u8* frad_vec = vec_u8_new(frad_len);
-    if (!frad_vec) return NULL;
-
-    for (size_t i = 0; i < frad_len; i++) {
-        vec_u8_push(frad_vec, frad[i]);
-    }
-
     // Unpack the data
-    vec_f64* pcm = u8pack_unpack(frad_vec, PROFILE4_DEPTHS[bit_depth_index], little_endian);
-    vec_u8_free(frad_vec);
+    vec_u8 frad_vec = vec_u8_view(frad, frad_len);
+    vec_f64* pcm = u8pack_unpack(&frad_vec, PROFILE4_DEPTHS[bit_depth_index], little_endian);
 
     return pcm;
 }
\ No newline at end of file
@@ -1,7 +1,10 @@
 #include "p1tools.h"
 #include "../../backend/backend.h"
+#include "../../backend/arena.h"
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
 
 const double SPREAD_ALPHA_P1 = 0.8;
 const double QUANT_ALPHA = 0.75;
@@ -13,6 +16,8 @@ const uint32_t MODIFIED_OPUS_SUBBANDS[] = {
     34400, 40800, 48000, 0xFFFFFFFF
 };
 
+#define SUBBAND_COUNT (sizeof(MODIFIED_OPUS_SUBBANDS) / sizeof(MODIFIED_OPUS_SUBBANDS[0]) - 1)
+
 static void get_bin_range(size_t len, uint32_t srate, int i, size_t* start, size_t* end) {
     *start = (size_t)round((double)MODIFIED_OPUS_SUBBANDS[i] / (srate / 2.0) * len);
     *end = (size_t)round((double)MODIFIED_OPUS_SUBBANDS[i + 1] / (srate / 2.0) * len);
@@ -20,59 +25,284 @@ static void get_bin_range(size_t len, uint32_t srate, int i, size_t* start, size
     if (*end > len) *end = len;
 }
 
+// Bin ranges of every subband for one (srate, len) pair
+typedef struct {
+    uint32_t srate;
+    size_t len;
+    size_t start[SUBBAND_COUNT];
+    size_t end[SUBBAND_COUNT];
+} band_table;
+
+// Process-wide band tables, like the transform plans: built on first use,
+// read-only after that and kept for good. Only a few pairs occur per
+// stream, past the limit tables are built on the caller's stack instead.
+#define BAND_TABLES_MAX 128
+
+static struct {
+    pthread_mutex_t lock;
+    band_table* tables[BAND_TABLES_MAX];
+    size_t count;
+} band_cache = { .lock = PTHREAD_MUTEX_INITIALIZER };
+
+static void band_table_fill(band_table* table, size_t len, uint32_t srate) {
+    table->srate = srate;
+    table->len = len;
+    for (size_t i = 0; i < SUBBAND_COUNT; i++) {
+        get_bin_range(len, srate, (int)i, &table->start[i], &table->end[i]);
+    }
+}
+
+static const band_table* band_table_get(size_t len, uint32_t srate, band_table* scratch) {
+    pthread_mutex_lock(&band_cache.lock);
+    for (size_t i = 0; i < band_cache.count; i++) {
+        band_table* table = band_cache.tables[i];
+        if (table->len == len && table->srate == srate) {
+            pthread_mutex_unlock(&band_cache.lock);
+            return table;
+        }
+    }
+
+    // Plain heap memory, the caller may be inside a frame arena
+    band_table* table = band_cache.count < BAND_TABLES_MAX ? (band_table*)malloc(sizeof(band_table)) : NULL;
+    if (table) {
+        band_table_fill(table, len, srate);
+        band_cache.tables[band_cache.count++] = table;
+    }
+    pthread_mutex_unlock(&band_cache.lock);
+    if (table) return table;
+
+    band_table_fill(scratch, len, srate);
+    return scratch;
+}
+
+// Absolute threshold of hearing at the centre of each subband, capped at 1
+static double ATH_FLOOR[SUBBAND_COUNT];
+static pthread_once_t ath_floor_once = PTHREAD_ONCE_INIT;
+
+static void build_ath_floor(void) {
+    for (size_t i = 0; i < SUBBAND_COUNT; i++) {
+        double f = (MODIFIED_OPUS_SUBBANDS[i] + MODIFIED_OPUS_SUBBANDS[i + 1]) / 2.0;
+        double ath = pow(10.0, (3.64 * pow(f / 1000.0, -0.8) - 6.5 * exp(-0.6 * pow(f / 1000.0 - 3.3, 2)) + 1e-3 * pow(f / 1000.0, 4)) / 20.0);
+        ATH_FLOOR[i] = fmin(ath, 1.0);
+    }
+}
+
 vec_f64* mask_thres_mos(const vec_f64* freqs, uint32_t srate, double loss_level, double alpha) {
     vec_f64* thres = vec_f64_new(MOSLEN_P1);
     if (!thres) return NULL;
 
+    pthread_once(&ath_floor_once, build_ath_floor);
+    band_table scratch;
+    const band_table* bands = band_table_get(freqs->size, srate, &scratch);
+
     for (int i = 0; i < MOSLEN_P1; i++) {
-        size_t start, end;
-        get_bin_range(freqs->size, srate, i, &start, &end);
+        size_t start = bands->start[i], end = bands->end[i];
         if (start >= end) {
             vec_f64_push(thres, 0.0);
             continue;
         }
 
+        // One pass over the band, vectorised under the release flags
+        const double* band = freqs->data + start;
+        size_t n = end - start;
         double sum_sq = 0.0;
-        for (size_t j = start; j < end; j++) {
-            sum_sq += freqs->data[j] * freqs->data[j];
+        for (size_t j = 0; j < n; j++) {
+            sum_sq += band[j] * band[j];
         }
-        double rms = sqrt(sum_sq / (end - start));
-        double f = (MODIFIED_OPUS_SUBBANDS[i] + MODIFIED_OPUS_SUBBANDS[i + 1]) / 2.0;
-        double ath = pow(10.0, (3.64 * pow(f / 1000.0, -0.8) - 6.5 * exp(-0.6 * pow(f / 1000.0 - 3.3, 2)) + 1e-3 * pow(f / 1000.0, 4)) / 20.0);
+        double rms = sqrt(sum_sq / n);
         double sfq = pow(rms, alpha);
-        vec_f64_push(thres, fmax(sfq, fmin(ath, 1.0)) * loss_level);
+        vec_f64_push(thres, fmax(sfq, ATH_FLOOR[i]) * loss_level);
     }
     return thres;
 }
 
-vec_f64* mapping_from_opus(const vec_f64* thres, size_t freq_len, uint32_t srate) {
-    vec_f64* output = vec_f64_new(freq_len);
-    if (!output) return NULL;
+void mapping_from_opus(const vec_f64* thres, size_t freq_len, uint32_t srate, double* out) {
+    band_table scratch;
+    const band_table* bands = band_table_get(freq_len, srate, &scratch);
 
+    // The subbands are back to back from bin 0, each spread linearly from its
+    // threshold towards the next one with linspace's step, bit for bit
+    size_t covered = 0;
     for (int i = 0; i < MOSLEN_P1 - 1; i++) {
-        size_t start, end;
-        get_bin_range(freq_len, srate, i, &start, &end);
-        size_t num = end - start;
+        size_t start = bands->start[i], num = bands->end[i] - start;
         if (num == 0) continue;
 
-        vec_f64* spaced = linspace(thres->data[i], thres->data[i + 1], num, false);
-        if (!spaced) {
-            vec_f64_free(output);
-            return NULL;
+        // Bands past the stored thresholds are fully masked
+        double lo = (size_t)i < thres->size ? thres->data[i] : 0.0;
+        double hi = (size_t)i + 1 < thres->size ? thres->data[i + 1] : 0.0;
+        double step = (hi - lo) / num;
+        double* band = out + start;
+        for (size_t j = 0; j < num; j++) band[j] = lo + j * step;
+        covered = bands->end[i];
+    }
+    // As are the bins above the last subband
+    for (size_t i = covered; i < freq_len; i++) out[i] = 0.0;
+}
+
+// Out of line so every caller rounds the same way: inlined into a vector
+// loop, -ffast-math may swap the square roots pow() becomes for estimates
+__attribute__((noinline)) int64_t quant(double x) { return (int64_t)(x > 0 ? 1 : -1) * pow(fabs(x), QUANT_ALPHA); }
+double dequant(double y) { return (y > 0 ? 1 : -1) * pow(fabs(y), 1.0 / QUANT_ALPHA); }
+__attribute__((noinline)) int64_t quant_f32(float x) { return (int64_t)((x > 0 ? 1 : -1) * powf(fabsf(x), 0.75f)); }
+float dequant_f32(float y) { return (y > 0 ? 1 : -1) * powf(fabsf(y), 1.0f / 0.75f); }
+
+// The array kernels estimate |x|^0.75 with multiplies alone, which
+// vectorise where pow() and square roots do not, to within 1e-9 of the true
+// value; the scalar functions are within an ulp or two. Both truncate to the
+// same integer unless they straddle one, so estimates closer than the margin
+// to an integer go through the scalar function instead. Relative margins,
+// they hold QUANT_ALPHA at 0.75.
+#define QUANT_MARGIN 1e-8
+#define QUANT_MARGIN_F32 (1.0 / (1 << 20))
+#define QUANT_BLOCK 256
+
+// a * a^-1/4: a first guess at a^-1/4 from the exponent bits, 3% off, and
+// three Newton steps. a is clamped so the steps cannot overflow, anything
+// that far out is an integer already and takes the scalar path.
+static inline double pow_three_quarters(double a) {
+    a = a < 0x1p-600 ? 0x1p-600 : a > 0x1p600 ? 0x1p600 : a;
+    uint64_t bits;
+    memcpy(&bits, &a, sizeof(bits));
+    bits = 0x4FEB0C0000000000ull - (bits >> 2);
+    double w;
+    memcpy(&w, &bits, sizeof(w));
+    for (int i = 0; i < 3; i++) w = w * (5.0 - a * (w * w) * (w * w)) * 0.25;
+    return a * w;
+}
+
+// Truncated magnitude of one estimate, flagging those too near an integer to trust
+static inline int64_t quant_truncate(double y, double margin, unsigned char* near) {
+    double f = floor(y);
+    *near = !(y - f > margin * y && f + 1.0 - y > margin * y);
+    return (int64_t)(f < 0x1p62 ? f : 0x1p62);
+}
+
+void quant_array(const double* in, size_t len, int64_t* out, size_t stride) {
+    int64_t q[QUANT_BLOCK];
+    unsigned char near[QUANT_BLOCK];
+    for (size_t base = 0; base < len; base += QUANT_BLOCK) {
+        size_t n = len - base < QUANT_BLOCK ? len - base : QUANT_BLOCK;
+        const double* x = in + base;
+        unsigned char any_near = 0;
+        for (size_t i = 0; i < n; i++) {
+            int64_t t = quant_truncate(pow_three_quarters(fabs(x[i])), QUANT_MARGIN, &near[i]);
+            q[i] = x[i] > 0 ? t : -t;
+            any_near |= near[i];
         }
-        for (size_t j = 0; j < num; j++) {
-            if (start + j < freq_len) {
-                output->data[start + j] = spaced->data[j];
-            }
+        for (size_t i = 0; i < n; i++) out[(base + i) * stride] = q[i];
+        if (!any_near) continue;
+        for (size_t i = 0; i < n; i++) {
+            if (near[i]) out[(base + i) * stride] = quant(x[i]);
         }
-        output->size = freq_len;
-        vec_f64_free(spaced);
     }
-    return output;
 }
 
-int64_t quant(double x) { return (int64_t)(x > 0 ? 1 : -1) * pow(fabs(x), QUANT_ALPHA); }
-double dequant(double y) { return (y > 0 ? 1 : -1) * pow(fabs(y), 1.0 / QUANT_ALPHA); }
+void quant_array_f32(const float* in, size_t len, int64_t* out, size_t stride) {
+    int64_t q[QUANT_BLOCK];
+    unsigned char near[QUANT_BLOCK];
+    for (size_t base = 0; base < len; base += QUANT_BLOCK) {
+        size_t n = len - base < QUANT_BLOCK ? len - base : QUANT_BLOCK;
+        const float* x = in + base;
+        unsigned char any_near = 0;
+        for (size_t i = 0; i < n; i++) {
+            int64_t t = quant_truncate(pow_three_quarters(fabs((double)x[i])), QUANT_MARGIN_F32, &near[i]);
+            q[i] = x[i] > 0 ? t : -t;
+            any_near |= near[i];
+        }
+        for (size_t i = 0; i < n; i++) out[(base + i) * stride] = q[i];
+        if (!any_near) continue;
+        for (size_t i = 0; i < n; i++) {
+            if (near[i]) out[(base + i) * stride] = quant_f32(x[i]);
+        }
+    }
+}
+
+// Dequantised magnitudes of the small coefficients, which are nearly all of
+// them, filled by the scalar functions so lookups match them exactly
+#define DEQUANT_TABLE_SIZE 8192
+static double DEQUANT_TABLE[DEQUANT_TABLE_SIZE];
+// Single precision values held as doubles, which gather with 64-bit indices
+static double DEQUANT_TABLE_F32[DEQUANT_TABLE_SIZE];
+static pthread_once_t dequant_table_once = PTHREAD_ONCE_INIT;
+
+static void build_dequant_table(void) {
+    for (size_t i = 0; i < DEQUANT_TABLE_SIZE; i++) {
+        DEQUANT_TABLE[i] = fabs(dequant((double)i));
+        DEQUANT_TABLE_F32[i] = fabsf(dequant_f32((float)i));
+    }
+}
+
+static inline uint64_t magnitude(int64_t v) { return v < 0 ? 0 - (uint64_t)v : (uint64_t)v; }
+
+// Coefficients past the table are rare, they look up a wrong entry and are
+// patched up afterwards so the main loop stays free of calls
+void dequant_array(const int64_t* in, size_t len, double divisor, double* restrict out) {
+    pthread_once(&dequant_table_once, build_dequant_table);
+    int64_t lo = 0, hi = 0;
+    for (size_t i = 0; i < len; i++) {
+        int64_t v = in[i];
+        out[i] = (v > 0 ? 1 : -1) * DEQUANT_TABLE[magnitude(v) & (DEQUANT_TABLE_SIZE - 1)] / divisor;
+        lo = v < lo ? v : lo;
+        hi = v > hi ? v : hi;
+    }
+    if (lo > -DEQUANT_TABLE_SIZE && hi < DEQUANT_TABLE_SIZE) return;
+    for (size_t i = 0; i < len; i++) {
+        if (magnitude(in[i]) >= DEQUANT_TABLE_SIZE) out[i] = dequant((double)in[i]) / divisor;
+    }
+}
+
+void dequant_array_f32(const int64_t* in, size_t len, float scale, float* restrict out) {
+    pthread_once(&dequant_table_once, build_dequant_table);
+    int64_t lo = 0, hi = 0;
+    for (size_t i = 0; i < len; i++) {
+        int64_t v = in[i];
+        out[i] = (v > 0 ? 1 : -1) * (float)DEQUANT_TABLE_F32[magnitude(v) & (DEQUANT_TABLE_SIZE - 1)] * scale;
+        lo = v < lo ? v : lo;
+        hi = v > hi ? v : hi;
+    }
+    if (lo > -DEQUANT_TABLE_SIZE && hi < DEQUANT_TABLE_SIZE) return;
+    for (size_t i = 0; i < len; i++) {
+        if (magnitude(in[i]) >= DEQUANT_TABLE_SIZE) out[i] = dequant_f32((float)in[i]) * scale;
+    }
+}
+
+// MSB-first bit writer: bits gather in a 64-bit word that is stored whole
+// once full, the buffer must have room for every byte the bits will take
+typedef struct {
+    uint8_t* out;
+    uint64_t acc;   // Pending bits, left-aligned
+    unsigned fill;  // Pending bit count, always below 64
+} bit_writer;
+
+static inline void bit_writer_store(uint8_t* out, uint64_t word) {
+    for (int i = 0; i < 8; i++) out[i] = (uint8_t)(word >> (56 - 8 * i));
+}
+
+// The low bits of value, 1 to 64 of them, nothing above them may be set
+static inline void bit_writer_put(bit_writer* w, uint64_t value, unsigned bits) {
+    unsigned room = 64 - w->fill;
+    if (bits < room) {
+        w->acc |= value << (room - bits);
+        w->fill += bits;
+        return;
+    }
+    unsigned rest = bits - room;
+    bit_writer_store(w->out, w->acc | (value >> rest));
+    w->out += 8;
+    w->acc = rest ? value << (64 - rest) : 0;
+    w->fill = rest;
+}
+
+// Store the pending bits, zero-padded to a byte, returns the end of the output
+static inline uint8_t* bit_writer_finish(bit_writer* w) {
+    for (unsigned i = 0; i < w->fill; i += 8) *w->out++ = (uint8_t)(w->acc >> (56 - i));
+    w->fill = 0;
+    return w->out;
+}
+
+static inline unsigned bit_length(uint64_t x) {
+    return 64 - __builtin_clzll(x);
+}
 
 // Exponential Golomb encoding
 vec_u8* exp_golomb_encode(const int64_t* data, size_t len) {
@@ -83,9 +313,9 @@ vec_u8* exp_golomb_encode(const int64_t* data, size_t len) {
     }
 
     // Find maximum absolute value to determine k
-    int64_t dmax = 0;
+    uint64_t dmax = 0;
     for (size_t i = 0; i < len; i++) {
-        int64_t abs_val = data[i] < 0 ? -data[i] : data[i];
+        uint64_t abs_val = data[i] < 0 ? -(uint64_t)data[i] : (uint64_t)data[i];
         if (abs_val > dmax) dmax = abs_val;
     }
 
@@ -95,136 +325,159 @@ vec_u8* exp_golomb_encode(const int64_t* data, size_t len) {
         k = (uint8_t)ceil(log2((double)dmax));
     }
 
-    // Calculate required size
-    size_t total_bits = 8; // for k parameter
-    for (size_t i = 0; i < len; i++) {
-        int64_t n = data[i];
-        int64_t x = (n > 0 ? (n << 1) - 1 : (-n) << 1) + (1LL << k);
-        int bits_needed = 0;
-        int64_t temp = x;
-        while (temp > 0) {
-            bits_needed++;
-            temp >>= 1;
-        }
-        if (bits_needed == 0) bits_needed = 1;
-        total_bits += (bits_needed << 1) - (k + 1);
-    }
-
-    vec_u8* encoded = vec_u8_new((total_bits + 7) / 8);
+    // A value of magnitude dmax has the longest code, size the buffer for
+    // that many bits per value and write everything in one go
+    uint64_t kx = (uint64_t)1 << k;
+    unsigned max_bits = 2 * bit_length(2 * dmax + kx) - (k + 1);
+    size_t cap = 1 + (len * max_bits + 7) / 8;
+    vec_u8* encoded = vec_u8_new(cap);
     if (!encoded) return NULL;
 
-    // Initialize with zeros
-    for (size_t i = 0; i < (total_bits + 7) / 8; i++) {
-        vec_u8_push(encoded, 0);
-    }
-
     // Store k parameter
     encoded->data[0] = k;
 
-    // Encode each value
-    size_t bit_pos = 8;
+    bit_writer w = { encoded->data + 1, 0, 0 };
     for (size_t i = 0; i < len; i++) {
         int64_t n = data[i];
-        int64_t x = (n > 0 ? (n << 1) - 1 : (-n) << 1) + (1LL << k);
-
-        // Calculate number of bits
-        int x_bits = 0;
-        int64_t temp = x;
-        while (temp > 0) {
-            x_bits++;
-            temp >>= 1;
+        uint64_t x = (n > 0 ? ((uint64_t)n << 1) - 1 : (-(uint64_t)n) << 1) + kx;
+
+        // x_bits - (k + 1) zeros, then x itself
+        unsigned x_bits = bit_length(x);
+        unsigned code_bits = (x_bits << 1) - (k + 1);
+        if (code_bits <= 64) {
+            bit_writer_put(&w, x, code_bits);
+        } else {
+            bit_writer_put(&w, 0, code_bits - x_bits);
+            bit_writer_put(&w, x, x_bits);
         }
-        if (x_bits == 0) x_bits = 1;
+    }
+    encoded->size = bit_writer_finish(&w) - encoded->data;
 
-        int total_bits = (x_bits << 1) - (k + 1);
+    return encoded;
+}
 
-        // Write bits
-        for (int j = 0; j < total_bits; j++) {
-            size_t byte_idx = bit_pos / 8;
-            size_t bit_idx = 7 - (bit_pos % 8);
+// MSB-first bit reader: up to 64 bits wait left-aligned in a word, topped up
+// eight bytes at a time while the input lasts
+typedef struct {
+    const uint8_t* data;
+    size_t size;
+    size_t pos;     // Next byte to load
+    uint64_t acc;   // Bits not yet taken, left-aligned
+    unsigned fill;  // Of those, the ones counted, always below 64
+} bit_reader;
+
+static inline uint64_t bit_reader_load(const uint8_t* in) {
+    uint64_t word = 0;
+    for (int i = 0; i < 8; i++) word = (word << 8) | in[i];
+    return word;
+}
 
-            if (x & (1LL << (total_bits - 1 - j))) {
-                encoded->data[byte_idx] |= (1 << bit_idx);
-            }
-            bit_pos++;
-        }
+// Load whole bytes until at least 57 bits are counted or the input is out.
+// The fast path may also put uncounted bits below fill, they are the real
+// next bits, so loading them again changes nothing
+static inline void bit_reader_refill(bit_reader* r) {
+    if (r->pos + 8 <= r->size) {
+        r->acc |= bit_reader_load(r->data + r->pos) >> r->fill;
+        unsigned take = (63 - r->fill) >> 3;
+        r->pos += take;
+        r->fill += take << 3;
+        return;
+    }
+    while (r->fill <= 56 && r->pos < r->size) {
+        r->acc |= (uint64_t)r->data[r->pos++] << (56 - r->fill);
+        r->fill += 8;
     }
+}
 
-    return encoded;
+static inline void bit_reader_skip(bit_reader* r, unsigned bits) {
+    r->acc = bits < 64 ? r->acc << bits : 0;
+    r->fill -= bits;
+}
+
+static inline size_t bit_reader_left(const bit_reader* r) {
+    return r->fill + (r->size - r->pos) * 8;
+}
+
+// Read bits into a word, only the low 64 are kept if there are more
+static inline uint64_t bit_reader_get(bit_reader* r, size_t bits) {
+    uint64_t value = 0;
+    while (bits > 0) {
+        bit_reader_refill(r);
+        unsigned take = bits < r->fill ? (unsigned)bits : r->fill;
+        if (take > 56) take = 56;
+        value = (value << take) | (r->acc >> (64 - take));
+        bit_reader_skip(r, take);
+        bits -= take;
+    }
+    return value;
 }
 
 // Exponential Golomb decoding
-int64_t* exp_golomb_decode(const vec_u8* data, size_t* out_len) {
+int64_t* exp_golomb_decode(const vec_u8* data, size_t expected, size_t* out_len) {
     if (!data || !out_len || data->size == 0) {
         if (out_len) *out_len = 0;
         return NULL;
     }
 
     uint8_t k = data->data[0];
-    int64_t kx = 1LL << k;
-
-    // Convert to bit array
-    size_t bit_len = (data->size - 1) * 8;
-    uint8_t* bits = calloc(bit_len, sizeof(uint8_t));
-    if (!bits) {
-        *out_len = 0;
-        return NULL;
-    }
-
-    // Convert bytes to bits
-    for (size_t i = 1; i < data->size; i++) {
-        uint8_t byte = data->data[i];
-        for (int j = 0; j < 8; j++) {
-            bits[(i - 1) * 8 + j] = (byte >> (7 - j)) & 1;
-        }
-    }
+    uint64_t kx = (uint64_t)1 << k;
 
-    // Decode values
-    size_t capacity = 256;
-    int64_t* decoded = malloc(capacity * sizeof(int64_t));
+    size_t capacity = expected > 0 ? expected : 256;
+    int64_t* decoded = frad_malloc(capacity * sizeof(int64_t));
     if (!decoded) {
-        free(bits);
         *out_len = 0;
         return NULL;
     }
 
+    bit_reader r = { data->data + 1, data->size - 1, 0, 0, 0 };
     size_t decoded_count = 0;
-    size_t idx = 0;
-
-    while (idx < bit_len) {
-        // Find first 1 bit (count leading zeros)
-        size_t m = 0;
-        while (idx + m < bit_len && bits[idx + m] == 0) {
-            m++;
-        }
 
-        if (idx + m >= bit_len) break;
-
-        size_t cwlen = (m * 2) + k + 1;
-        if (idx + cwlen > bit_len) break;
+    while (true) {
+        // Codes up to 33 bits, all but huge values, take the first branch
+        if (r.fill <= 32) bit_reader_refill(&r);
+        unsigned zeros = r.acc ? (unsigned)__builtin_clzll(r.acc) : 64;
+        size_t code_bits = 2 * (size_t)zeros + k + 1;
+        uint64_t x;
+
+        if (zeros < r.fill && code_bits <= r.fill) {
+            // The whole code is loaded, its leading zeros are the top of x
+            x = r.acc >> (64 - code_bits);
+            bit_reader_skip(&r, (unsigned)code_bits);
+        } else {
+            // Count the leading zeros, a run may span more than one word
+            size_t m = 0;
+            bool found = false;
+            while (r.fill > 0) {
+                zeros = r.acc ? (unsigned)__builtin_clzll(r.acc) : 64;
+                if (zeros < r.fill) {
+                    m += zeros;
+                    bit_reader_skip(&r, zeros);
+                    found = true;
+                    break;
+                }
+                m += r.fill;
+                bit_reader_skip(&r, r.fill);
+                bit_reader_refill(&r);
+            }
+            if (!found) break;
 
-        // Read the value
-        int64_t n = 0;
-        for (size_t i = idx + m; i < idx + cwlen && i < bit_len; i++) {
-            n = (n << 1) | bits[i];
+            // The value is the 1 just found and m + k bits after it
+            size_t value_bits = m + k + 1;
+            if (value_bits > bit_reader_left(&r)) break;
+            x = bit_reader_get(&r, value_bits);
         }
-        n -= kx;
+        int64_t n = (int64_t)(x - kx);
 
-        // Decode the sign
-        int64_t value;
-        if (n & 1) {
-            value = (n + 1) >> 1;
-        } else {
-            value = -(n >> 1);
-        }
+        // Decode the sign without a branch, odd n is (n + 1) / 2 and even n is -n / 2
+        int64_t odd = n & 1;
+        int64_t value = ((n >> 1) ^ (odd - 1)) - (odd - 1) + odd;
 
         // Grow array if needed
         if (decoded_count >= capacity) {
             capacity *= 2;
-            int64_t* new_decoded = realloc(decoded, capacity * sizeof(int64_t));
+            int64_t* new_decoded = frad_realloc(decoded, capacity * sizeof(int64_t));
             if (!new_decoded) {
-                free(decoded);
-                free(bits);
+                frad_free(decoded);
                 *out_len = 0;
                 return NULL;
             }
@@ -232,10 +485,8 @@ int64_t* exp_golomb_decode(const vec_u8* data, size_t* out_len) {
         }
 
         decoded[decoded_count++] = value;
-        idx += cwlen;
     }
 
-    free(bits);
     *out_len = decoded_count;
     return decoded;
-}
\ No newline at end of file
+}
@@ -9,10 +9,22 @@
 #define SPREAD_ALPHA 0.5
 
 vec_f64* mask_thres_mos(const vec_f64* freqs, uint32_t srate, double loss_level, double alpha);
-vec_f64* mapping_from_opus(const vec_f64* thres, size_t freq_len, uint32_t srate);
+// Subband thresholds spread over the freq_len bins of out, no allocation
+void mapping_from_opus(const vec_f64* thres, size_t freq_len, uint32_t srate, double* out);
 int64_t quant(double x);
 double dequant(double x);
+int64_t quant_f32(float x);
+float dequant_f32(float y);
+// The same over whole arrays, bit for bit, quantised values are written
+// stride apart to fill interleaved channels
+void quant_array(const double* in, size_t len, int64_t* out, size_t stride);
+void quant_array_f32(const float* in, size_t len, int64_t* out, size_t stride);
+// out[i] = dequant(in[i]) / divisor
+void dequant_array(const int64_t* in, size_t len, double divisor, double* out);
+// out[i] = dequant_f32(in[i]) * scale
+void dequant_array_f32(const int64_t* in, size_t len, float scale, float* out);
 vec_u8* exp_golomb_encode(const int64_t* data, size_t len);
-int64_t* exp_golomb_decode(const vec_u8* data, size_t* out_len);
+// expected sizes the output up front, 0 if unknown; all of data is decoded either way
+int64_t* exp_golomb_decode(const vec_u8* data, size_t expected, size_t* out_len);
 
 #endif // P1TOOLS_H
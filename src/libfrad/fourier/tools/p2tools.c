@@ -1,5 +1,6 @@
 #include "p2tools.h"
 #include "../backend/signal.h"
+#include "../../backend/arena.h"
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
@@ -23,9 +24,7 @@ static vec_f64* calc_autocorr(const vec_f64* freq) {
     }
 
     size_t start = freq->size - 1;
-    for (size_t i = 0; i < freq->size; i++) {
-        vec_f64_push(autocorr, result->data[start + i]);
-    }
+    vec_f64_extend(autocorr, result->data + start, freq->size);
 
     vec_f64_free(result);
     return autocorr;
@@ -38,11 +37,11 @@ static vec_f64* levinson_durbin(const vec_f64* autocorr) {
     vec_f64* lpc = vec_f64_new(p);
     if (!lpc) return NULL;
 
-    double* a = (double*)calloc(p + 1, sizeof(double));
-    double* a_prev = (double*)calloc(p + 1, sizeof(double));
+    double* a = (double*)frad_calloc(p + 1, sizeof(double));
+    double* a_prev = (double*)frad_calloc(p + 1, sizeof(double));
     if (!a || !a_prev) {
-        free(a);
-        free(a_prev);
+        frad_free(a);
+        frad_free(a_prev);
         vec_f64_free(lpc);
         return NULL;
     }
@@ -72,8 +71,8 @@ static vec_f64* levinson_durbin(const vec_f64* autocorr) {
         vec_f64_push(lpc, a[i]);
     }
 
-    free(a);
-    free(a_prev);
+    frad_free(a);
+    frad_free(a_prev);
     return lpc;
 }
 
@@ -157,22 +156,13 @@ void tns_analysis(const vec_f64* freqs, size_t channels,
     }
 
     for (size_t c = 0; c < channels; c++) {
-        // Extract channel data
-        vec_f64* chan_data = vec_f64_new(csize);
-        if (!chan_data) {
-            vec_f64_free(tns_freqs);
-            vec_i64_free(all_lpcqs);
-            return;
-        }
-
-        for (size_t i = 0; i < csize; i++) {
-            vec_f64_push(chan_data, freqs->data[c * csize + i]);
-        }
+        // View of the channel data
+        vec_f64 chan_view = vec_f64_view(freqs->data + c * csize, csize);
+        const vec_f64* chan_data = &chan_view;
 
         // Calculate autocorrelation
         vec_f64* autocorr = calc_autocorr(chan_data);
         if (!autocorr) {
-            vec_f64_free(chan_data);
             vec_f64_free(tns_freqs);
             vec_i64_free(all_lpcqs);
             return;
@@ -183,7 +173,6 @@ void tns_analysis(const vec_f64* freqs, size_t channels,
         vec_f64_free(autocorr);
 
         if (!lpc) {
-            vec_f64_free(chan_data);
             vec_f64_free(tns_freqs);
             vec_i64_free(all_lpcqs);
             return;
@@ -197,15 +186,15 @@ void tns_analysis(const vec_f64* freqs, size_t channels,
             vec_f64_free(a_coeffs);
             vec_f64_free(b_coeffs);
             vec_f64_free(lpc);
-            vec_f64_free(chan_data);
             vec_f64_free(tns_freqs);
             vec_i64_free(all_lpcqs);
             return;
         }
 
-        vec_f64_push(a_coeffs, 1.0);
+        vec_f64_resize(a_coeffs, lpc->size + 1);
+        a_coeffs->data[0] = 1.0;
         for (size_t i = 0; i < lpc->size; i++) {
-            vec_f64_push(a_coeffs, -lpc->data[i]);
+            a_coeffs->data[i + 1] = -lpc->data[i];
         }
         vec_f64_push(b_coeffs, 1.0);
 
@@ -216,7 +205,6 @@ void tns_analysis(const vec_f64* freqs, size_t channels,
 
         if (!tns_chan) {
             vec_f64_free(lpc);
-            vec_f64_free(chan_data);
             vec_f64_free(tns_freqs);
             vec_i64_free(all_lpcqs);
             return;
@@ -228,32 +216,23 @@ void tns_analysis(const vec_f64* freqs, size_t channels,
         // Use TNS if gain is significant
         if (gain > 5.0) {
             // Use TNS filtered data
-            for (size_t i = 0; i < csize; i++) {
-                vec_f64_push(tns_freqs, tns_chan->data[i]);
-            }
+            vec_f64_extend(tns_freqs, tns_chan->data, csize);
 
             // Quantise and store LPC coefficients
             vec_i64* lpcq = quantise_lpc(lpc);
             if (lpcq) {
-                for (size_t i = 0; i < lpcq->size; i++) {
-                    vec_i64_push(all_lpcqs, lpcq->data[i]);
-                }
+                vec_i64_extend(all_lpcqs, lpcq->data, lpcq->size);
                 vec_i64_free(lpcq);
             }
         } else {
             // Use original data, no TNS
-            for (size_t i = 0; i < csize; i++) {
-                vec_f64_push(tns_freqs, chan_data->data[i]);
-            }
+            vec_f64_extend(tns_freqs, chan_data->data, csize);
             // Push zeros for LPC coefficients
-            for (size_t i = 0; i < TNS_MAX_ORDER && i < csize; i++) {
-                vec_i64_push(all_lpcqs, 0);
-            }
+            vec_i64_resize(all_lpcqs, all_lpcqs->size + (TNS_MAX_ORDER < csize ? TNS_MAX_ORDER : csize));
         }
 
         vec_f64_free(lpc);
         vec_f64_free(tns_chan);
-        vec_f64_free(chan_data);
     }
 
     *tns_freqs_out = tns_freqs;
@@ -271,16 +250,9 @@ vec_f64* tns_synthesis(const vec_f64* tns_freqs, const vec_i64* lpcqs, size_t ch
     if (!freqs) return NULL;
 
     for (size_t c = 0; c < channels; c++) {
-        // Extract channel LPC quantised coefficients
-        vec_i64* chan_lpcq = vec_i64_new(lpc_per_channel);
-        if (!chan_lpcq) {
-            vec_f64_free(freqs);
-            return NULL;
-        }
-
-        for (size_t i = 0; i < lpc_per_channel; i++) {
-            vec_i64_push(chan_lpcq, lpcqs->data[c * lpc_per_channel + i]);
-        }
+        // View of the channel LPC quantised coefficients
+        vec_i64 chan_lpcq_view = vec_i64_view(lpcqs->data + c * lpc_per_channel, lpc_per_channel);
+        const vec_i64* chan_lpcq = &chan_lpcq_view;
 
         // Check if TNS was applied (non-zero LPC coefficients)
         bool has_tns = false;
@@ -294,24 +266,14 @@ vec_f64* tns_synthesis(const vec_f64* tns_freqs, const vec_i64* lpcqs, size_t ch
         if (has_tns) {
             // Dequantise LPC coefficients
             vec_f64* lpc = dequantise_lpc(chan_lpcq);
-            vec_i64_free(chan_lpcq);
 
             if (!lpc) {
                 vec_f64_free(freqs);
                 return NULL;
             }
 
-            // Extract channel TNS data
-            vec_f64* chan_tns = vec_f64_new(csize);
-            if (!chan_tns) {
-                vec_f64_free(lpc);
-                vec_f64_free(freqs);
-                return NULL;
-            }
-
-            for (size_t i = 0; i < csize; i++) {
-                vec_f64_push(chan_tns, tns_freqs->data[c * csize + i]);
-            }
+            // View of the channel TNS data
+            vec_f64 chan_tns = vec_f64_view(tns_freqs->data + c * csize, csize);
 
             // Apply inverse TNS filter
             vec_f64* a_coeffs = vec_f64_new(1);
@@ -321,23 +283,22 @@ vec_f64* tns_synthesis(const vec_f64* tns_freqs, const vec_i64* lpcqs, size_t ch
                 vec_f64_free(a_coeffs);
                 vec_f64_free(b_coeffs);
                 vec_f64_free(lpc);
-                vec_f64_free(chan_tns);
                 vec_f64_free(freqs);
                 return NULL;
             }
 
             vec_f64_push(a_coeffs, 1.0);
-            vec_f64_push(b_coeffs, 1.0);
+            vec_f64_resize(b_coeffs, lpc->size + 1);
+            b_coeffs->data[0] = 1.0;
             for (size_t i = 0; i < lpc->size; i++) {
-                vec_f64_push(b_coeffs, -lpc->data[i]);
+                b_coeffs->data[i + 1] = -lpc->data[i];
             }
 
-            vec_f64* chan_freq = impulse_filt(b_coeffs, a_coeffs, chan_tns);
+            vec_f64* chan_freq = impulse_filt(b_coeffs, a_coeffs, &chan_tns);
 
             vec_f64_free(a_coeffs);
             vec_f64_free(b_coeffs);
             vec_f64_free(lpc);
-            vec_f64_free(chan_tns);
 
             if (!chan_freq) {
                 vec_f64_free(freqs);
@@ -345,17 +306,12 @@ vec_f64* tns_synthesis(const vec_f64* tns_freqs, const vec_i64* lpcqs, size_t ch
             }
 
             // Copy synthesized data
-            for (size_t i = 0; i < csize; i++) {
-                vec_f64_push(freqs, chan_freq->data[i]);
-            }
+            vec_f64_extend(freqs, chan_freq->data, csize);
 
             vec_f64_free(chan_freq);
         } else {
             // No TNS, copy original data
-            vec_i64_free(chan_lpcq);
-            for (size_t i = 0; i < csize; i++) {
-                vec_f64_push(freqs, tns_freqs->data[c * csize + i]);
-            }
+            vec_f64_extend(freqs, tns_freqs->data + c * csize, csize);
         }
     }
 
@@ -0,0 +1,229 @@
+#include "zstream.h"
+#include "../../backend/arena.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <math.h>
+#include <zlib.h>
+#ifdef FRAD_LIBDEFLATE
+#include <libdeflate.h>
+#endif
+
+// Stored blocks carry at most this many bytes each
+#define STORED_BLOCK_MAX 65535
+// Order-0 entropy, in bits per byte, above which a frame is stored without
+// trying deflate: Huffman coding would save under 2% and LZ77 matches are
+// rare in Golomb-coded spectra
+#define STORE_ENTROPY_BITS 7.84
+
+static const struct {
+    int level;
+    int strategy;
+    int libdeflate_level;
+} EFFORTS[] = {
+    [ZSTREAM_BEST]     = {Z_BEST_COMPRESSION, Z_DEFAULT_STRATEGY, 0},
+    [ZSTREAM_BALANCED] = {3, Z_DEFAULT_STRATEGY, 6},
+    [ZSTREAM_FAST]     = {1, Z_HUFFMAN_ONLY, 1},
+};
+
+struct zstream_cache {
+    z_stream deflate;
+    z_stream inflate;
+    bool deflate_ready;
+    bool inflate_ready;
+    zstream_effort effort;
+#ifdef FRAD_LIBDEFLATE
+    struct libdeflate_compressor* compressor;  // Set up at the effort's level on first use
+#endif
+};
+
+zstream_cache* zstream_cache_new(void) {
+    return (zstream_cache*)calloc(1, sizeof(zstream_cache));
+}
+
+void zstream_cache_free(zstream_cache* cache) {
+    if (!cache) return;
+    if (cache->deflate_ready) deflateEnd(&cache->deflate);
+    if (cache->inflate_ready) inflateEnd(&cache->inflate);
+#ifdef FRAD_LIBDEFLATE
+    libdeflate_free_compressor(cache->compressor);
+#endif
+    free(cache);
+}
+
+void zstream_set_effort(zstream_cache* cache, zstream_effort effort) {
+    if (!cache || cache->effort == effort) return;
+    if (cache->deflate_ready) deflateEnd(&cache->deflate);
+    cache->deflate_ready = false;
+#ifdef FRAD_LIBDEFLATE
+    libdeflate_free_compressor(cache->compressor);
+    cache->compressor = NULL;
+#endif
+    cache->effort = effort;
+}
+
+// A stream reset for a new frame, from the cache or else set up in local.
+// Cached streams leave zalloc unset, zlib's own malloc, as they outlive the
+// arena the frame is encoded in; one-off streams take frad_zalloc as before.
+static z_stream* deflate_stream(zstream_cache* cache, z_stream* local) {
+    z_stream* strm = cache ? &cache->deflate : local;
+    if (cache && cache->deflate_ready) return deflateReset(strm) == Z_OK ? strm : NULL;
+
+    if (!cache) {
+        memset(local, 0, sizeof(z_stream));
+        local->zalloc = frad_zalloc;
+        local->zfree = frad_zfree;
+    }
+    zstream_effort effort = cache ? cache->effort : ZSTREAM_BEST;
+    // -15 for raw deflate (no header)
+    if (deflateInit2(strm, EFFORTS[effort].level, Z_DEFLATED, -15, 8, EFFORTS[effort].strategy) != Z_OK) return NULL;
+    if (cache) cache->deflate_ready = true;
+    return strm;
+}
+
+static z_stream* inflate_stream(zstream_cache* cache, z_stream* local) {
+    z_stream* strm = cache ? &cache->inflate : local;
+    if (cache && cache->inflate_ready) return inflateReset(strm) == Z_OK ? strm : NULL;
+
+    if (!cache) {
+        memset(local, 0, sizeof(z_stream));
+        local->zalloc = frad_zalloc;
+        local->zfree = frad_zfree;
+    }
+    if (inflateInit2(strm, -15) != Z_OK) return NULL;
+    if (cache) cache->inflate_ready = true;
+    return strm;
+}
+
+static size_t stored_size(size_t len) {
+    size_t blocks = len ? (len + STORED_BLOCK_MAX - 1) / STORED_BLOCK_MAX : 1;
+    return len + blocks * 5;
+}
+
+// The frame as stored blocks, each a byte of header bits then LEN and NLEN
+static vec_u8* deflate_stored(const uint8_t* in, size_t len) {
+    vec_u8* out = vec_u8_new(stored_size(len));
+    if (!out) return NULL;
+    uint8_t* p = out->data;
+    size_t pos = 0;
+    do {
+        size_t n = len - pos < STORED_BLOCK_MAX ? len - pos : STORED_BLOCK_MAX;
+        p[0] = pos + n == len;  // BFINAL on the last block, BTYPE 00
+        p[1] = n & 0xFF;
+        p[2] = n >> 8;
+        p[3] = ~n & 0xFF;
+        p[4] = (~n >> 8) & 0xFF;
+        memcpy(p + 5, in + pos, n);
+        p += 5 + n;
+        pos += n;
+    } while (pos < len);
+    out->size = p - out->data;
+    return out;
+}
+
+static bool looks_incompressible(const uint8_t* in, size_t len) {
+    uint32_t counts[256] = {0};
+    for (size_t i = 0; i < len; i++) counts[in[i]]++;
+    double bits = 0.0;
+    for (int i = 0; i < 256; i++) {
+        if (counts[i]) bits += counts[i] * log2((double)len / counts[i]);
+    }
+    return len > 0 && bits >= STORE_ENTROPY_BITS * len;
+}
+
+#ifdef FRAD_LIBDEFLATE
+static vec_u8* deflate_libdeflate(zstream_cache* cache, const uint8_t* in, size_t len) {
+    if (!cache->compressor) {
+        cache->compressor = libdeflate_alloc_compressor(EFFORTS[cache->effort].libdeflate_level);
+        if (!cache->compressor) return NULL;
+    }
+    size_t bound = libdeflate_deflate_compress_bound(cache->compressor, len);
+    vec_u8* out = vec_u8_new(bound);
+    if (!out) return NULL;
+    out->size = libdeflate_deflate_compress(cache->compressor, in, len, out->data, bound);
+    if (out->size == 0) {
+        vec_u8_free(out);
+        return NULL;
+    }
+    return out;
+}
+#endif
+
+static vec_u8* deflate_zlib(zstream_cache* cache, const uint8_t* in, size_t len) {
+    z_stream local;
+    z_stream* strm = deflate_stream(cache, &local);
+    if (!strm) return NULL;
+
+    uLongf dest_len = deflateBound(strm, len);
+    vec_u8* out = vec_u8_new(dest_len);
+    if (out) {
+        strm->avail_in = len;
+        strm->next_in = (Bytef*)in;
+        strm->avail_out = dest_len;
+        strm->next_out = out->data;
+        if (deflate(strm, Z_FINISH) == Z_STREAM_END) {
+            out->size = strm->total_out;
+        } else {
+            vec_u8_free(out);
+            out = NULL;
+        }
+    }
+    if (!cache) deflateEnd(strm);
+    return out;
+}
+
+vec_u8* zstream_deflate(zstream_cache* cache, const uint8_t* in, size_t len) {
+    if (!cache || cache->effort == ZSTREAM_BEST) return deflate_zlib(cache, in, len);
+    if (looks_incompressible(in, len)) return deflate_stored(in, len);
+
+#ifdef FRAD_LIBDEFLATE
+    vec_u8* out = deflate_libdeflate(cache, in, len);
+#else
+    vec_u8* out = deflate_zlib(cache, in, len);
+#endif
+    if (out && out->size > stored_size(len)) {
+        vec_u8_free(out);
+        out = deflate_stored(in, len);
+    }
+    return out;
+}
+
+uint8_t* zstream_inflate(zstream_cache* cache, const uint8_t* in, size_t len, size_t size_hint, size_t* out_len) {
+    z_stream local;
+    z_stream* strm = inflate_stream(cache, &local);
+    if (!strm) return NULL;
+
+    size_t capacity = size_hint > 0 ? size_hint : 1;
+    uint8_t* out = (uint8_t*)frad_malloc(capacity);
+    if (!out) {
+        if (!cache) inflateEnd(strm);
+        return NULL;
+    }
+
+    strm->avail_in = len;
+    strm->next_in = (Bytef*)in;
+    strm->avail_out = capacity;
+    strm->next_out = out;
+
+    int result;
+    while ((result = inflate(strm, Z_NO_FLUSH)) == Z_OK) {
+        if (strm->avail_out == 0) {
+            // Need more output space
+            size_t used = capacity;
+            capacity *= 2;
+            uint8_t* grown = (uint8_t*)frad_realloc(out, capacity);
+            if (!grown) break;
+            out = grown;
+            strm->avail_out = capacity - used;
+            strm->next_out = out + used;
+        }
+    }
+
+    *out_len = strm->total_out;
+    if (!cache) inflateEnd(strm);
+    if (result != Z_STREAM_END) {
+        frad_free(out);
+        return NULL;
+    }
+    return out;
+}
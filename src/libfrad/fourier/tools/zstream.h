@@ -0,0 +1,35 @@
+#ifndef ZSTREAM_H
+#define ZSTREAM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "../../backend/backend.h"
+
+// Raw deflate and inflate streams kept across frames, so a frame pays for a
+// reset instead of zlib's setup of its window and hash tables. The streams
+// live on the heap, not in a frame arena, and are set up on first use. One
+// cache serves one frame at a time.
+typedef struct zstream_cache zstream_cache;
+
+// How hard a cache's deflate works. Below ZSTREAM_BEST, frames that would
+// not shrink go out as stored blocks, and libdeflate takes over from zlib
+// when built with FRAD_LIBDEFLATE. ZSTREAM_BEST is always zlib's best level.
+typedef enum {
+    ZSTREAM_BEST,      // Level 9
+    ZSTREAM_BALANCED,  // Level 3, libdeflate 6
+    ZSTREAM_FAST       // Huffman coding only, libdeflate 1
+} zstream_effort;
+
+zstream_cache* zstream_cache_new(void);
+void zstream_cache_free(zstream_cache* cache);
+// ZSTREAM_BEST until set, a change restarts the deflate stream on the next frame
+void zstream_set_effort(zstream_cache* cache, zstream_effort effort);
+
+// Raw deflate of a whole frame at the cache's effort, NULL on failure.
+// cache may be NULL, a stream is then set up at the best level for this call only.
+vec_u8* zstream_deflate(zstream_cache* cache, const uint8_t* in, size_t len);
+// Raw inflate of a whole frame into a frad_malloc buffer of size_hint bytes,
+// grown if the data turns out larger. NULL if the data is corrupt or memory ran out
+uint8_t* zstream_inflate(zstream_cache* cache, const uint8_t* in, size_t len, size_t size_hint, size_t* out_len);
+
+#endif // ZSTREAM_H
@@ -87,9 +87,7 @@ vec_u8* repairer_process(repairer_t* ctx, const uint8_t* stream, size_t stream_l
     if (!ctx || !stream) return vec_u8_new(0);
 
     // Extend buffer with input stream
-    for (size_t i = 0; i < stream_len; i++) {
-        vec_u8_push(ctx->buffer, stream[i]);
-    }
+    vec_u8_extend(ctx->buffer, stream, stream_len);
 
     vec_u8* ret = vec_u8_new(0);
     if (!ret) return NULL;
@@ -141,9 +139,7 @@ vec_u8* repairer_process(repairer_t* ctx, const uint8_t* stream, size_t stream_l
             vec_u8_free(encoded);
 
             if (frame_output) {
-                for (size_t i = 0; i < frame_output->size; i++) {
-                    vec_u8_push(ret, frame_output->data[i]);
-                }
+                vec_u8_extend(ret, frame_output->data, frame_output->size);
                 vec_u8_free(frame_output);
             }
 
@@ -164,9 +160,7 @@ vec_u8* repairer_process(repairer_t* ctx, const uint8_t* stream, size_t stream_l
                     // 2.1.1. Split out the buffer to the header buffer
                     vec_u8* prefix = vec_u8_split_front(ctx->buffer, pattern_idx);
                     if (prefix) {
-                        for (size_t i = 0; i < prefix->size; i++) {
-                            vec_u8_push(ret, prefix->data[i]);
-                        }
+                        vec_u8_extend(ret, prefix->data, prefix->size);
                         vec_u8_free(prefix);
                     }
 
@@ -184,9 +178,7 @@ vec_u8* repairer_process(repairer_t* ctx, const uint8_t* stream, size_t stream_l
 
                     vec_u8* prefix = vec_u8_split_front(ctx->buffer, split_size);
                     if (prefix) {
-                        for (size_t i = 0; i < prefix->size; i++) {
-                            vec_u8_push(ret, prefix->data[i]);
-                        }
+                        vec_u8_extend(ret, prefix->data, prefix->size);
                         vec_u8_free(prefix);
                     }
                     break;
@@ -207,9 +199,7 @@ vec_u8* repairer_process(repairer_t* ctx, const uint8_t* stream, size_t stream_l
                     {
                         vec_u8* flush_data = asfh_force_flush(ctx->asfh);
                         if (flush_data) {
-                            for (size_t i = 0; i < flush_data->size; i++) {
-                                vec_u8_push(ret, flush_data->data[i]);
-                            }
+                            vec_u8_extend(ret, flush_data->data, flush_data->size);
                             vec_u8_free(flush_data);
                         }
                     }
@@ -232,9 +222,7 @@ vec_u8* repairer_flush(repairer_t* ctx) {
     vec_u8* ret = vec_u8_new(ctx->buffer->size);
     if (!ret) return NULL;
 
-    for (size_t i = 0; i < ctx->buffer->size; i++) {
-        vec_u8_push(ret, ctx->buffer->data[i]);
-    }
+    vec_u8_extend(ret, ctx->buffer->data, ctx->buffer->size);
 
     ctx->buffer->size = 0;
     return ret;
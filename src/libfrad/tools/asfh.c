@@ -39,69 +39,79 @@ void asfh_free(ASFH* asfh) {
     }
 }
 
+// Longest frame header: lossless profiles, 32 bytes
+#define ASFH_HEAD_MAX 32
+
 vec_u8* asfh_write(ASFH* asfh, vec_u8* frad) {
-    vec_u8* fhead = vec_u8_new(32);
-    for (size_t i = 0; i < 4; i++) vec_u8_push(fhead, FRM_SIGN[i]);
+    vec_u8* frame = vec_u8_new(ASFH_HEAD_MAX + frad->size);
+    if (frame && !asfh_write_into(asfh, frad, frame)) {
+        vec_u8_free(frame);
+        return NULL;
+    }
+    return frame;
+}
+
+bool asfh_write_into(ASFH* asfh, const vec_u8* frad, vec_u8* out) {
+    uint8_t fhead[ASFH_HEAD_MAX];
+    size_t n = 0;
+    for (size_t i = 0; i < 4; i++) fhead[n++] = FRM_SIGN[i];
 
     uint32_t frad_len = frad->size;
-    for (int i = 3; i >= 0; i--) vec_u8_push(fhead, (frad_len >> (i * 8)) & 0xFF);
-    vec_u8_push(fhead, encode_pfb(asfh->profile, asfh->ecc, asfh->endian, asfh->bit_depth_index));
+    for (int i = 3; i >= 0; i--) fhead[n++] = (frad_len >> (i * 8)) & 0xFF;
+    fhead[n++] = encode_pfb(asfh->profile, asfh->ecc, asfh->endian, asfh->bit_depth_index);
 
     if (asfh->profile == 1 || asfh->profile == 2) { // Compact profiles
-        uint8_t css[2];
-        encode_css(asfh->channels, asfh->srate, asfh->fsize, false, css);
-        vec_u8_push(fhead, css[0]);
-        vec_u8_push(fhead, css[1]);
-        vec_u8_push(fhead, (asfh->overlap_ratio > 0 ? asfh->overlap_ratio - 1 : 0));
+        encode_css(asfh->channels, asfh->srate, asfh->fsize, false, fhead + n);
+        n += 2;
+        fhead[n++] = (asfh->overlap_ratio > 0 ? asfh->overlap_ratio - 1 : 0);
         if (asfh->ecc) {
-            vec_u8_push(fhead, asfh->ecc_ratio[0]);
-            vec_u8_push(fhead, asfh->ecc_ratio[1]);
+            fhead[n++] = asfh->ecc_ratio[0];
+            fhead[n++] = asfh->ecc_ratio[1];
             uint16_t crc = crc16_ansi(0, frad->data, frad->size);
-            vec_u8_push(fhead, (crc >> 8) & 0xFF);
-            vec_u8_push(fhead, crc & 0xFF);
+            fhead[n++] = (crc >> 8) & 0xFF;
+            fhead[n++] = crc & 0xFF;
         }
     } else { // Lossless profiles
-        vec_u8_push(fhead, asfh->channels - 1);
-        vec_u8_push(fhead, asfh->ecc_ratio[0]);
-        vec_u8_push(fhead, asfh->ecc_ratio[1]);
-        for (int i = 3; i >= 0; i--) vec_u8_push(fhead, (asfh->srate >> (i * 8)) & 0xFF);
-        for (int i = 0; i < 8; i++) vec_u8_push(fhead, 0); // reserved
-        for (int i = 3; i >= 0; i--) vec_u8_push(fhead, (asfh->fsize >> (i * 8)) & 0xFF);
+        fhead[n++] = asfh->channels - 1;
+        fhead[n++] = asfh->ecc_ratio[0];
+        fhead[n++] = asfh->ecc_ratio[1];
+        for (int i = 3; i >= 0; i--) fhead[n++] = (asfh->srate >> (i * 8)) & 0xFF;
+        for (int i = 0; i < 8; i++) fhead[n++] = 0; // reserved
+        for (int i = 3; i >= 0; i--) fhead[n++] = (asfh->fsize >> (i * 8)) & 0xFF;
         uint32_t crc = frad_crc32(0, frad->data, frad->size);
-        for (int i = 3; i >= 0; i--) vec_u8_push(fhead, (crc >> (i * 8)) & 0xFF);
+        for (int i = 3; i >= 0; i--) fhead[n++] = (crc >> (i * 8)) & 0xFF;
     }
 
-    vec_u8* frame = vec_u8_new(fhead->size + frad->size);
-    memcpy(frame->data, fhead->data, fhead->size);
-    frame->size += fhead->size;
-    memcpy(frame->data + frame->size, frad->data, frad->size);
-    frame->size += frad->size;
-
-    vec_u8_free(fhead);
-    return frame;
+    return vec_u8_extend(out, fhead, n) && vec_u8_extend(out, frad->data, frad->size);
 }
 
 vec_u8* asfh_force_flush(ASFH* asfh) {
     vec_u8* fhead = vec_u8_new(12);
-    for (size_t i = 0; i < 4; i++) vec_u8_push(fhead, FRM_SIGN[i]);
-    for (int i = 0; i < 4; i++) vec_u8_push(fhead, 0); // frad length = 0
-    vec_u8_push(fhead, encode_pfb(asfh->profile, asfh->ecc, asfh->endian, asfh->bit_depth_index));
-
-    if (asfh->profile == 1 || asfh->profile == 2) { // Compact profiles
-        uint16_t channels = asfh->channels > 1 ? asfh->channels : 1;
-        uint8_t css[2];
-        encode_css(channels, asfh->srate, asfh->fsize, true, css);
-        vec_u8_push(fhead, css[0]);
-        vec_u8_push(fhead, css[1]);
-        vec_u8_push(fhead, 0);
-    } else {
+    if (fhead && !asfh_force_flush_into(asfh, fhead)) {
         vec_u8_free(fhead);
-        return vec_u8_new(0);
+        return NULL;
     }
-
     return fhead;
 }
 
+bool asfh_force_flush_into(ASFH* asfh, vec_u8* out) {
+    // Only the compact profiles have a flush header
+    if (asfh->profile != 1 && asfh->profile != 2) return true;
+
+    uint8_t fhead[12];
+    size_t n = 0;
+    for (size_t i = 0; i < 4; i++) fhead[n++] = FRM_SIGN[i];
+    for (int i = 0; i < 4; i++) fhead[n++] = 0; // frad length = 0
+    fhead[n++] = encode_pfb(asfh->profile, asfh->ecc, asfh->endian, asfh->bit_depth_index);
+
+    uint16_t channels = asfh->channels > 1 ? asfh->channels : 1;
+    encode_css(channels, asfh->srate, asfh->fsize, true, fhead + n);
+    n += 2;
+    fhead[n++] = 0;
+
+    return vec_u8_extend(out, fhead, n);
+}
+
 // Helper function to decode PFB byte
 static void decode_pfb(uint8_t pfb, uint8_t* profile, bool* ecc, bool* endian, uint16_t* bit_depth_index) {
     *profile = pfb >> 5;
@@ -125,17 +135,13 @@ static bool fill_buffer(ASFH* asfh, vec_u8* buffer, size_t target_size) {
         size_t needed = target_size - asfh->buffer->size;
         if (buffer->size < needed) {
             // Not enough data in input buffer
-            for (size_t i = 0; i < buffer->size; i++) {
-                vec_u8_push(asfh->buffer, buffer->data[i]);
-            }
+            vec_u8_extend(asfh->buffer, buffer->data, buffer->size);
             buffer->size = 0; // Clear input buffer
             return false;
         }
 
         // Take needed bytes from input buffer
-        for (size_t i = 0; i < needed; i++) {
-            vec_u8_push(asfh->buffer, buffer->data[i]);
-        }
+        vec_u8_extend(asfh->buffer, buffer->data, needed);
 
         // Remove taken bytes from input buffer
         memmove(buffer->data, buffer->data + needed, buffer->size - needed);
@@ -38,6 +38,9 @@ ASFH* asfh_new();
 void asfh_free(ASFH* asfh);
 vec_u8* asfh_write(ASFH* asfh, vec_u8* frad);
 vec_u8* asfh_force_flush(ASFH* asfh);
+// Append the frame or flush header to out instead, false if out could not grow
+bool asfh_write_into(ASFH* asfh, const vec_u8* frad, vec_u8* out);
+bool asfh_force_flush_into(ASFH* asfh, vec_u8* out);
 
 // Missing parsing functions
 ParseResult asfh_parse(ASFH* asfh, vec_u8* buffer);
@@ -1,5 +1,6 @@
 #include "ecc.h"
 #include "reedsolo.h"
+#include "../../backend/arena.h"
 #include <stdlib.h>
 #include <string.h>
 
@@ -37,11 +38,9 @@ vec_u8* ecc_encode(const vec_u8* data, uint8_t ratio[2]) {
         }
 
         // Append encoded chunk to result
-        for (size_t j = 0; j < encoded_len; j++) {
-            vec_u8_push(result, encoded[j]);
-        }
+        vec_u8_extend(result, encoded, encoded_len);
 
-        free(encoded);
+        frad_free(encoded);
     }
 
     rs_codec_free(rs);
@@ -79,23 +78,17 @@ vec_u8* ecc_decode(const vec_u8* data, uint8_t ratio[2], bool repair) {
 
                 if (decoded && error == RS_SUCCESS) {
                     // Copy decoded data
-                    for (size_t j = 0; j < decoded_len; j++) {
-                        vec_u8_push(result, decoded[j]);
-                    }
-                    free(decoded);
+                    vec_u8_extend(result, decoded, decoded_len);
+                    frad_free(decoded);
                 } else {
                     // If decoding fails, fill with zeros
-                    for (size_t j = 0; j < data_size; j++) {
-                        vec_u8_push(result, 0);
-                    }
-                    if (decoded) free(decoded);
+                    vec_u8_resize(result, result->size + data_size);
+                    if (decoded) frad_free(decoded);
                 }
             } else {
                 // Incomplete block - can't repair, just strip parity if present
                 size_t copy_len = (chunk_size >= parity_size) ? (chunk_size - parity_size) : chunk_size;
-                for (size_t j = 0; j < copy_len; j++) {
-                    vec_u8_push(result, data->data[i + j]);
-                }
+                vec_u8_extend(result, data->data + i, copy_len);
             }
         } else {
             // Just strip parity bytes without repair
@@ -109,9 +102,7 @@ vec_u8* ecc_decode(const vec_u8* data, uint8_t ratio[2], bool repair) {
                 copy_len = chunk_size;
             }
 
-            for (size_t j = 0; j < copy_len; j++) {
-                vec_u8_push(result, data->data[i + j]);
-            }
+            vec_u8_extend(result, data->data + i, copy_len);
         }
     }
 
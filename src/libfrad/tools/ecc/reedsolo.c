@@ -1,4 +1,5 @@
 #include "reedsolo.h"
+#include "../../backend/arena.h"
 #include <stdlib.h>
 #include <string.h>
 
@@ -58,13 +59,13 @@ static void init_gf_tables(RSCodec* codec) {
 // Generate Reed-Solomon generator polynomial
 static void generate_polynomial(RSCodec* codec) {
     codec->polynomial_size = codec->parity_size + 1;
-    codec->polynomial = calloc(codec->polynomial_size, sizeof(uint8_t));
+    codec->polynomial = frad_calloc(codec->polynomial_size, sizeof(uint8_t));
     if (!codec->polynomial) return;
 
     codec->polynomial[0] = 1;
 
     for (size_t i = 0; i < codec->parity_size; i++) {
-        uint8_t* new_poly = calloc(codec->polynomial_size, sizeof(uint8_t));
+        uint8_t* new_poly = frad_calloc(codec->polynomial_size, sizeof(uint8_t));
         if (!new_poly) return;
 
         for (size_t j = 0; j <= i; j++) {
@@ -75,7 +76,7 @@ static void generate_polynomial(RSCodec* codec) {
         }
 
         memcpy(codec->polynomial, new_poly, codec->polynomial_size);
-        free(new_poly);
+        frad_free(new_poly);
     }
 }
 
@@ -118,7 +119,7 @@ static int check_syndromes(const uint8_t* synd, size_t synd_len) {
 // Find error locator polynomial using Berlekamp-Massey algorithm
 static size_t find_error_locator(const RSCodec* codec, const uint8_t* synd, uint8_t* err_loc) {
     size_t nsym = codec->parity_size;
-    uint8_t* old_loc = calloc(nsym + 1, sizeof(uint8_t));
+    uint8_t* old_loc = frad_calloc(nsym + 1, sizeof(uint8_t));
     if (!old_loc) return 0;
 
     old_loc[0] = 1;
@@ -134,9 +135,9 @@ static size_t find_error_locator(const RSCodec* codec, const uint8_t* synd, uint
 
         if (delta != 0) {
             if (old_loc[0] != 0) {
-                uint8_t* new_loc = calloc(nsym + 1, sizeof(uint8_t));
+                uint8_t* new_loc = frad_calloc(nsym + 1, sizeof(uint8_t));
                 if (!new_loc) {
-                    free(old_loc);
+                    frad_free(old_loc);
                     return 0;
                 }
 
@@ -155,7 +156,7 @@ static size_t find_error_locator(const RSCodec* codec, const uint8_t* synd, uint
                     synd_shift = i + 1 - synd_shift;
                 }
 
-                free(new_loc);
+                frad_free(new_loc);
             }
         }
     }
@@ -169,7 +170,7 @@ static size_t find_error_locator(const RSCodec* codec, const uint8_t* synd, uint
         }
     }
 
-    free(old_loc);
+    frad_free(old_loc);
     return errs;
 }
 
@@ -197,7 +198,7 @@ static size_t find_errors(const RSCodec* codec, const uint8_t* err_loc, size_t e
 
 RSCodec* rs_codec_new(size_t data_size, size_t parity_size, uint8_t fcr,
                       uint16_t prim, uint8_t generator, uint32_t c_exp) {
-    RSCodec* codec = calloc(1, sizeof(RSCodec));
+    RSCodec* codec = frad_calloc(1, sizeof(RSCodec));
     if (!codec) return NULL;
 
     codec->data_size = data_size;
@@ -219,8 +220,8 @@ RSCodec* rs_codec_new_default(size_t data_size, size_t parity_size) {
 
 void rs_codec_free(RSCodec* codec) {
     if (codec) {
-        free(codec->polynomial);
-        free(codec);
+        frad_free(codec->polynomial);
+        frad_free(codec);
     }
 }
 
@@ -228,7 +229,7 @@ uint8_t* rs_encode(const RSCodec* codec, const uint8_t* data, size_t data_len, s
     if (!codec || !data || !out_len) return NULL;
 
     *out_len = data_len + codec->parity_size;
-    uint8_t* result = malloc(*out_len);
+    uint8_t* result = frad_malloc(*out_len);
     if (!result) return NULL;
 
     memcpy(result, data, data_len);
@@ -244,15 +245,15 @@ uint8_t* rs_encode(const RSCodec* codec, const uint8_t* data, size_t data_len, s
     }
 
     // Move parity to the end
-    uint8_t* parity = malloc(codec->parity_size);
+    uint8_t* parity = frad_malloc(codec->parity_size);
     if (!parity) {
-        free(result);
+        frad_free(result);
         return NULL;
     }
     memcpy(parity, result + data_len, codec->parity_size);
     memcpy(result, data, data_len);
     memcpy(result + data_len, parity, codec->parity_size);
-    free(parity);
+    frad_free(parity);
 
     return result;
 }
@@ -274,7 +275,7 @@ uint8_t* rs_decode(const RSCodec* codec, const uint8_t* data, size_t data_len,
     }
 
     // Calculate syndromes
-    uint8_t* synd = calloc(codec->parity_size, sizeof(uint8_t));
+    uint8_t* synd = frad_calloc(codec->parity_size, sizeof(uint8_t));
     if (!synd) {
         *error = RS_ERROR_MEMORY_ALLOCATION;
         return NULL;
@@ -285,9 +286,9 @@ uint8_t* rs_decode(const RSCodec* codec, const uint8_t* data, size_t data_len,
     // Check if there are any errors
     if (check_syndromes(synd, codec->parity_size)) {
         // No errors, return the data portion
-        free(synd);
+        frad_free(synd);
         *out_len = (data_len > codec->data_size) ? codec->data_size : data_len;
-        uint8_t* result = malloc(*out_len);
+        uint8_t* result = frad_malloc(*out_len);
         if (!result) {
             *error = RS_ERROR_MEMORY_ALLOCATION;
             return NULL;
@@ -297,9 +298,9 @@ uint8_t* rs_decode(const RSCodec* codec, const uint8_t* data, size_t data_len,
     }
 
     // Find error locator polynomial
-    uint8_t* err_loc = calloc(codec->parity_size + 1, sizeof(uint8_t));
+    uint8_t* err_loc = frad_calloc(codec->parity_size + 1, sizeof(uint8_t));
     if (!err_loc) {
-        free(synd);
+        frad_free(synd);
         *error = RS_ERROR_MEMORY_ALLOCATION;
         return NULL;
     }
@@ -308,17 +309,17 @@ uint8_t* rs_decode(const RSCodec* codec, const uint8_t* data, size_t data_len,
 
     if (err_count > codec->parity_size / 2) {
         // Too many errors to correct
-        free(synd);
-        free(err_loc);
+        frad_free(synd);
+        frad_free(err_loc);
         *error = RS_ERROR_TOO_MANY_ERRORS;
         return NULL;
     }
 
     // Find error positions
-    size_t* err_pos = calloc(err_count, sizeof(size_t));
+    size_t* err_pos = frad_calloc(err_count, sizeof(size_t));
     if (!err_pos) {
-        free(synd);
-        free(err_loc);
+        frad_free(synd);
+        frad_free(err_loc);
         *error = RS_ERROR_MEMORY_ALLOCATION;
         return NULL;
     }
@@ -327,20 +328,20 @@ uint8_t* rs_decode(const RSCodec* codec, const uint8_t* data, size_t data_len,
 
     if (found_errors != err_count) {
         // Error locator failed
-        free(synd);
-        free(err_loc);
-        free(err_pos);
+        frad_free(synd);
+        frad_free(err_loc);
+        frad_free(err_pos);
         *error = RS_ERROR_LOCATION_FAILURE;
         return NULL;
     }
 
     // Create corrected message
     *out_len = (data_len > codec->data_size) ? codec->data_size : data_len;
-    uint8_t* result = malloc(data_len);
+    uint8_t* result = frad_malloc(data_len);
     if (!result) {
-        free(synd);
-        free(err_loc);
-        free(err_pos);
+        frad_free(synd);
+        frad_free(err_loc);
+        frad_free(err_pos);
         *error = RS_ERROR_MEMORY_ALLOCATION;
         return NULL;
     }
@@ -357,22 +358,22 @@ uint8_t* rs_decode(const RSCodec* codec, const uint8_t* data, size_t data_len,
     }
 
     // Return only the data portion
-    uint8_t* final_result = malloc(*out_len);
+    uint8_t* final_result = frad_malloc(*out_len);
     if (!final_result) {
-        free(result);
-        free(synd);
-        free(err_loc);
-        free(err_pos);
+        frad_free(result);
+        frad_free(synd);
+        frad_free(err_loc);
+        frad_free(err_pos);
         *error = RS_ERROR_MEMORY_ALLOCATION;
         return NULL;
     }
 
     memcpy(final_result, result, *out_len);
 
-    free(result);
-    free(synd);
-    free(err_loc);
-    free(err_pos);
+    frad_free(result);
+    frad_free(synd);
+    frad_free(err_loc);
+    frad_free(err_pos);
 
     return final_result;
 }
\ No newline at end of file
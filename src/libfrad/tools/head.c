@@ -48,9 +48,7 @@ void metadata_vec_push(metadata_vec* vec, const char* title, const vec_u8* data)
     vec->entries[vec->count].title = title ? strdup(title) : NULL;
     if (data) {
         vec->entries[vec->count].data = vec_u8_new(data->size);
-        for (size_t i = 0; i < data->size; i++) {
-            vec_u8_push(vec->entries[vec->count].data, data->data[i]);
-        }
+        vec_u8_extend(vec->entries[vec->count].data, data->data, data->size);
     } else {
         vec->entries[vec->count].data = NULL;
     }
@@ -70,9 +68,7 @@ static vec_u8* create_comment_block(const char* title, const vec_u8* data) {
     size_t block_len = COMMENT_HEAD_LENGTH + title_len + data_len;
 
     // Write COMMENT signature
-    for (size_t i = 0; i < sizeof(COMMENT_SIG); i++) {
-        vec_u8_push(block, COMMENT_SIG[i]);
-    }
+    vec_u8_extend(block, COMMENT_SIG, sizeof(COMMENT_SIG));
 
     // Write block length (6 bytes, big-endian)
     uint64_t block_size = title_len + data_len + 12;  // Total block size including header
@@ -90,14 +86,10 @@ static vec_u8* create_comment_block(const char* title, const vec_u8* data) {
     vec_u8_push(block, title_len & 0xFF);
 
     // Write title
-    for (size_t i = 0; i < title_len; i++) {
-        vec_u8_push(block, title[i]);
-    }
+    vec_u8_extend(block, (const uint8_t*)title, title_len);
 
     // Write data
-    for (size_t i = 0; i < data_len; i++) {
-        vec_u8_push(block, data->data[i]);
-    }
+    vec_u8_extend(block, data->data, data_len);
 
     return block;
 }
@@ -113,9 +105,7 @@ static vec_u8* create_image_block(const vec_u8* img, uint8_t itype) {
     if (itype > 20) itype = 3;  // Default to "Cover (front)"
 
     // Write IMAGE signature
-    for (size_t i = 0; i < sizeof(IMAGE_SIG); i++) {
-        vec_u8_push(block, IMAGE_SIG[i]);
-    }
+    vec_u8_extend(block, IMAGE_SIG, sizeof(IMAGE_SIG));
 
     // Write picture type with flags (1 byte)
     vec_u8_push(block, 0x40 | itype);  // 0b01000000 | picture_type
@@ -132,9 +122,7 @@ static vec_u8* create_image_block(const vec_u8* img, uint8_t itype) {
     vec_u8_push(block, data_len & 0xFF);
 
     // Write image data
-    for (size_t i = 0; i < img->size; i++) {
-        vec_u8_push(block, img->data[i]);
-    }
+    vec_u8_extend(block, img->data, img->size);
 
     return block;
 }
@@ -148,9 +136,7 @@ vec_u8* head_builder(const metadata_vec* meta, const vec_u8* img, uint8_t itype)
         for (size_t i = 0; i < meta->count; i++) {
             vec_u8* comment_block = create_comment_block(meta->entries[i].title, meta->entries[i].data);
             if (comment_block) {
-                for (size_t j = 0; j < comment_block->size; j++) {
-                    vec_u8_push(blocks, comment_block->data[j]);
-                }
+                vec_u8_extend(blocks, comment_block->data, comment_block->size);
                 vec_u8_free(comment_block);
             }
         }
@@ -160,9 +146,7 @@ vec_u8* head_builder(const metadata_vec* meta, const vec_u8* img, uint8_t itype)
     if (img && img->size > 0) {
         vec_u8* image_block = create_image_block(img, itype);
         if (image_block) {
-            for (size_t j = 0; j < image_block->size; j++) {
-                vec_u8_push(blocks, image_block->data[j]);
-            }
+            vec_u8_extend(blocks, image_block->data, image_block->size);
             vec_u8_free(image_block);
         }
     }
@@ -171,14 +155,10 @@ vec_u8* head_builder(const metadata_vec* meta, const vec_u8* img, uint8_t itype)
     vec_u8* header = vec_u8_new(0);
 
     // Write signature (4 bytes)
-    for (size_t i = 0; i < 4; i++) {
-        vec_u8_push(header, SIGNATURE[i]);
-    }
+    vec_u8_extend(header, SIGNATURE, 4);
 
     // Write 4 reserved bytes
-    for (int i = 0; i < 4; i++) {
-        vec_u8_push(header, 0);
-    }
+    vec_u8_resize(header, header->size + 4);
 
     // Write header size (8 bytes, big-endian) - total size is 64 + blocks
     uint64_t header_size = 64 + blocks->size;
@@ -192,14 +172,10 @@ vec_u8* head_builder(const metadata_vec* meta, const vec_u8* img, uint8_t itype)
     vec_u8_push(header, header_size & 0xFF);
 
     // Write 48 reserved bytes
-    for (int i = 0; i < 48; i++) {
-        vec_u8_push(header, 0);
-    }
+    vec_u8_resize(header, header->size + 48);
 
     // Append blocks
-    for (size_t i = 0; i < blocks->size; i++) {
-        vec_u8_push(header, blocks->data[i]);
-    }
+    vec_u8_extend(header, blocks->data, blocks->size);
 
     vec_u8_free(blocks);
     return header;
@@ -264,9 +240,7 @@ parser_result* head_parser(vec_u8* header) {
             }
 
             vec_u8* data = vec_u8_new(0);
-            for (size_t i = 0; i < data_len; i++) {
-                vec_u8_push(data, header->data[pos + i]);
-            }
+            vec_u8_extend(data, header->data + pos, data_len);
             pos += data_len;
 
             metadata_vec_push(result->meta, title, data);
@@ -300,9 +274,7 @@ parser_result* head_parser(vec_u8* header) {
 
             // Read image data
             result->img = vec_u8_new(0);
-            for (size_t i = 0; i < img_len; i++) {
-                vec_u8_push(result->img, header->data[pos + i]);
-            }
+            vec_u8_extend(result->img, header->data + pos, img_len);
             pos += img_len;
         }
         // Check for frame signature (end of header)
@@ -7,6 +7,7 @@
 #include "libfrad/repairer.h"
 #include "tools/cli.h"
 #include "tools/process.h"
+#include "tools/pipeline.h"
 #include "app_common.h"
 
 static void logging_repair(uint8_t loglevel, process_info_t* log, bool linefeed) {
@@ -101,14 +102,25 @@ void repair(const char* input, CliParams* params) {
     // Create process info for logging
     process_info_t* procinfo = process_info_new();
 
-    // Process input
-    uint8_t buffer[32768];
-    size_t bytes_read;
+    // Read, repair and write on three threads, chunks are recycled
+    io_pipeline_t* io = io_pipeline_new(in_file, out_file, 32768,
+                                        params->pipeline_depth < 0 ? 0 : (size_t)params->pipeline_depth);
+    if (!io) {
+        fprintf(stderr, "Error: Memory allocation failed\n");
+        process_info_free(procinfo);
+        if (!is_stdout) fclose(out_file);
+        repairer_free(repairer);
+        if (!is_stdin) fclose(in_file);
+        if (auto_output) free(auto_output);
+        return;
+    }
+    io_chunk_t* chunk;
 
-    while ((bytes_read = fread(buffer, 1, sizeof(buffer), in_file)) > 0) {
-        vec_u8* result = repairer_process(repairer, buffer, bytes_read);
+    while ((chunk = io_pipeline_read(io)) != NULL) {
+        vec_u8* result = repairer_process(repairer, chunk->data, chunk->size);
+        io_pipeline_release(io, chunk);
         if (result && result->size > 0) {
-            fwrite(result->data, 1, result->size, out_file);
+            io_pipeline_write(io, result->data, result->size);
             process_info_update(procinfo, result->size, 0, 0);
             vec_u8_free(result);
         }
@@ -118,14 +130,18 @@ void repair(const char* input, CliParams* params) {
     // Flush repairer
     vec_u8* result = repairer_flush(repairer);
     if (result && result->size > 0) {
-        fwrite(result->data, 1, result->size, out_file);
+        io_pipeline_write(io, result->data, result->size);
         process_info_update(procinfo, result->size, 0, 0);
         vec_u8_free(result);
     }
+    if (!io_pipeline_finish(io)) {
+        fprintf(stderr, "Error: Failed to write output file '%s'\n", is_stdout ? "-" : output_file);
+    }
     logging_repair(params->loglevel, procinfo, true);
 
     // Cleanup
     process_info_free(procinfo);
+    io_pipeline_free(io);
     if (!is_stdout) fclose(out_file);
     repairer_free(repairer);
     if (!is_stdin) fclose(in_file);
@@ -18,6 +18,14 @@ void init_cli_params(CliParams* params) {
     params->srate = 0;
     params->channels = 0;
     params->frame_size = 2048;
+    params->snap_fsize = false;
+    params->float32 = false;
+    params->preset = ENCODER_PRESET_MAX;
+    params->threads = 1;
+    params->channel_threads = 1;
+    params->pipeline_depth = 4;
+    params->live = false;
+    params->latency = 8.0;
     params->little_endian = false;
     params->profile = 4;
     params->overlap_ratio = 16;
@@ -203,6 +211,34 @@ void parse_cli(int argc, char** argv, char** action, char** metaaction, char** i
                 if (i < argc) params->channels = atoi(argv[i++]);
             } else if (strcmp(key, "frame-size") == 0 || strcmp(key, "fsize") == 0 || strcmp(key, "fr") == 0) {
                 if (i < argc) params->frame_size = atoi(argv[i++]);
+            } else if (strcmp(key, "snap-fsize") == 0 || strcmp(key, "snap") == 0) {
+                params->snap_fsize = true;
+            } else if (strcmp(key, "float32") == 0 || strcmp(key, "f32") == 0) {
+                params->float32 = true;
+            } else if (strcmp(key, "preset") == 0) {
+                if (i < argc) {
+                    char* preset = argv[i++];
+                    if (strcmp(preset, "max") == 0) {
+                        params->preset = ENCODER_PRESET_MAX;
+                    } else if (strcmp(preset, "balanced") == 0) {
+                        params->preset = ENCODER_PRESET_BALANCED;
+                    } else if (strcmp(preset, "fast") == 0) {
+                        params->preset = ENCODER_PRESET_FAST;
+                    } else {
+                        fprintf(stderr, "Unknown preset: %s (fast, balanced or max)\n", preset);
+                        exit(1);
+                    }
+                }
+            } else if (strcmp(key, "threads") == 0 || strcmp(key, "thread") == 0 || strcmp(key, "j") == 0) {
+                if (i < argc) params->threads = atoi(argv[i++]);
+            } else if (strcmp(key, "channel-threads") == 0 || strcmp(key, "chthreads") == 0) {
+                if (i < argc) params->channel_threads = atoi(argv[i++]);
+            } else if (strcmp(key, "pipeline-depth") == 0 || strcmp(key, "pipeline") == 0) {
+                if (i < argc) params->pipeline_depth = atoi(argv[i++]);
+            } else if (strcmp(key, "live") == 0) {
+                params->live = true;
+            } else if (strcmp(key, "latency") == 0) {
+                if (i < argc) params->latency = atof(argv[i++]);
             } else if (strcmp(key, "le") == 0 || strcmp(key, "little-endian") == 0) {
                 params->little_endian = true;
             } else if (strcmp(key, "profile") == 0 || strcmp(key, "prf") == 0 || strcmp(key, "p") == 0) {
@@ -12,6 +12,14 @@ typedef struct {
     int srate;
     int channels;
     int frame_size;
+    bool snap_fsize;
+    bool float32;
+    encoder_preset_t preset;
+    int threads;
+    int channel_threads;
+    int pipeline_depth;
+    bool live;
+    double latency;
     bool little_endian;
     int profile;
     int overlap_ratio;
@@ -0,0 +1,236 @@
+#include "pipeline.h"
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+// Chunks waiting for one side, guarded by the pipeline lock. A queue holds at
+// most depth chunks, as that is all there are in its direction.
+typedef struct {
+    io_chunk_t** items;
+    size_t cap;
+    size_t head;
+    size_t len;
+    bool closed;  // Nothing more is pushed, pop returns NULL once empty
+    pthread_cond_t cond;
+} chunk_queue;
+
+struct io_pipeline {
+    FILE* in;
+    FILE* out;
+    size_t depth;
+    io_chunk_t* chunks;  // All of them, depth per direction or one each when synchronous
+    size_t chunk_count;
+
+    pthread_mutex_t lock;
+    chunk_queue in_free;   // Reader fills these
+    chunk_queue in_full;   // Caller takes these
+    chunk_queue out_free;  // Caller fills these
+    chunk_queue out_full;  // Writer takes these
+    pthread_t reader;
+    pthread_t writer;
+    bool reader_running;
+    bool writer_running;
+    bool write_failed;
+};
+
+static bool queue_init(chunk_queue* queue, size_t cap) {
+    queue->items = (io_chunk_t**)malloc(cap * sizeof(io_chunk_t*));
+    if (!queue->items) return false;
+    queue->cap = cap;
+    queue->head = 0;
+    queue->len = 0;
+    queue->closed = false;
+    pthread_cond_init(&queue->cond, NULL);
+    return true;
+}
+
+static void queue_destroy(chunk_queue* queue) {
+    if (!queue->items) return;
+    free(queue->items);
+    pthread_cond_destroy(&queue->cond);
+}
+
+static void queue_push(io_pipeline_t* pipeline, chunk_queue* queue, io_chunk_t* chunk) {
+    pthread_mutex_lock(&pipeline->lock);
+    queue->items[(queue->head + queue->len) % queue->cap] = chunk;
+    queue->len++;
+    pthread_cond_signal(&queue->cond);
+    pthread_mutex_unlock(&pipeline->lock);
+}
+
+static io_chunk_t* queue_pop(io_pipeline_t* pipeline, chunk_queue* queue) {
+    pthread_mutex_lock(&pipeline->lock);
+    while (queue->len == 0 && !queue->closed) {
+        pthread_cond_wait(&queue->cond, &pipeline->lock);
+    }
+    io_chunk_t* chunk = NULL;
+    if (queue->len > 0) {
+        chunk = queue->items[queue->head];
+        queue->head = (queue->head + 1) % queue->cap;
+        queue->len--;
+    }
+    pthread_mutex_unlock(&pipeline->lock);
+    return chunk;
+}
+
+static void queue_close(io_pipeline_t* pipeline, chunk_queue* queue) {
+    pthread_mutex_lock(&pipeline->lock);
+    queue->closed = true;
+    pthread_cond_broadcast(&queue->cond);
+    pthread_mutex_unlock(&pipeline->lock);
+}
+
+static void* reader_main(void* arg) {
+    io_pipeline_t* pipeline = (io_pipeline_t*)arg;
+    io_chunk_t* chunk;
+    while ((chunk = queue_pop(pipeline, &pipeline->in_free)) != NULL) {
+        chunk->size = fread(chunk->data, 1, chunk->capacity, pipeline->in);
+        if (chunk->size == 0) break;
+        queue_push(pipeline, &pipeline->in_full, chunk);
+    }
+    queue_close(pipeline, &pipeline->in_full);
+    return NULL;
+}
+
+static void* writer_main(void* arg) {
+    io_pipeline_t* pipeline = (io_pipeline_t*)arg;
+    io_chunk_t* chunk;
+    while ((chunk = queue_pop(pipeline, &pipeline->out_full)) != NULL) {
+        bool failed = fwrite(chunk->data, 1, chunk->size, pipeline->out) != chunk->size;
+        if (failed) {
+            pthread_mutex_lock(&pipeline->lock);
+            pipeline->write_failed = true;
+            pthread_mutex_unlock(&pipeline->lock);
+        }
+        queue_push(pipeline, &pipeline->out_free, chunk);
+    }
+    return NULL;
+}
+
+io_pipeline_t* io_pipeline_new(FILE* in, FILE* out, size_t chunk_size, size_t depth) {
+    io_pipeline_t* pipeline = (io_pipeline_t*)calloc(1, sizeof(io_pipeline_t));
+    if (!pipeline) return NULL;
+    pipeline->in = in;
+    pipeline->out = out;
+    pipeline->depth = depth;
+    pthread_mutex_init(&pipeline->lock, NULL);
+
+    size_t per_side = depth > 0 ? depth : 1;
+    pipeline->chunk_count = per_side * 2;
+    pipeline->chunks = (io_chunk_t*)calloc(pipeline->chunk_count, sizeof(io_chunk_t));
+    if (!pipeline->chunks) {
+        io_pipeline_free(pipeline);
+        return NULL;
+    }
+    for (size_t i = 0; i < pipeline->chunk_count; i++) {
+        pipeline->chunks[i].data = (uint8_t*)malloc(chunk_size);
+        if (!pipeline->chunks[i].data) {
+            io_pipeline_free(pipeline);
+            return NULL;
+        }
+        pipeline->chunks[i].capacity = chunk_size;
+    }
+    if (depth == 0) return pipeline;
+
+    // The first half goes to the reader, the second to the caller's writes
+    if (!queue_init(&pipeline->in_free, depth) || !queue_init(&pipeline->in_full, depth) ||
+        !queue_init(&pipeline->out_free, depth) || !queue_init(&pipeline->out_full, depth)) {
+        io_pipeline_free(pipeline);
+        return NULL;
+    }
+    for (size_t i = 0; i < depth; i++) {
+        pipeline->in_free.items[i] = &pipeline->chunks[i];
+        pipeline->out_free.items[i] = &pipeline->chunks[depth + i];
+    }
+    pipeline->in_free.len = depth;
+    pipeline->out_free.len = depth;
+
+    if (in) {
+        pipeline->reader_running = pthread_create(&pipeline->reader, NULL, reader_main, pipeline) == 0;
+        if (!pipeline->reader_running) {
+            io_pipeline_free(pipeline);
+            return NULL;
+        }
+    }
+    if (out) {
+        pipeline->writer_running = pthread_create(&pipeline->writer, NULL, writer_main, pipeline) == 0;
+        if (!pipeline->writer_running) {
+            io_pipeline_free(pipeline);
+            return NULL;
+        }
+    }
+    return pipeline;
+}
+
+io_chunk_t* io_pipeline_read(io_pipeline_t* pipeline) {
+    if (!pipeline->in) return NULL;
+    if (pipeline->depth > 0) return queue_pop(pipeline, &pipeline->in_full);
+
+    io_chunk_t* chunk = &pipeline->chunks[0];
+    chunk->size = fread(chunk->data, 1, chunk->capacity, pipeline->in);
+    return chunk->size > 0 ? chunk : NULL;
+}
+
+void io_pipeline_release(io_pipeline_t* pipeline, io_chunk_t* chunk) {
+    if (!chunk || pipeline->depth == 0) return;
+    queue_push(pipeline, &pipeline->in_free, chunk);
+}
+
+bool io_pipeline_write(io_pipeline_t* pipeline, const uint8_t* data, size_t size) {
+    if (!pipeline->out) return false;
+    if (size == 0) return true;
+    if (pipeline->depth == 0) {
+        bool ok = fwrite(data, 1, size, pipeline->out) == size;
+        if (!ok) pipeline->write_failed = true;
+        return ok;
+    }
+
+    // Blocks while the writer is depth chunks behind
+    io_chunk_t* chunk = queue_pop(pipeline, &pipeline->out_free);
+    if (!chunk) return false;
+    if (chunk->capacity < size) {
+        uint8_t* grown = (uint8_t*)realloc(chunk->data, size);
+        if (!grown) {
+            queue_push(pipeline, &pipeline->out_free, chunk);
+            return false;
+        }
+        chunk->data = grown;
+        chunk->capacity = size;
+    }
+    memcpy(chunk->data, data, size);
+    chunk->size = size;
+    queue_push(pipeline, &pipeline->out_full, chunk);
+    return true;
+}
+
+bool io_pipeline_finish(io_pipeline_t* pipeline) {
+    if (pipeline->writer_running) {
+        queue_close(pipeline, &pipeline->out_full);
+        pthread_join(pipeline->writer, NULL);
+        pipeline->writer_running = false;
+    }
+    return !pipeline->write_failed;
+}
+
+void io_pipeline_free(io_pipeline_t* pipeline) {
+    if (!pipeline) return;
+    if (pipeline->reader_running) {
+        // Wakes the reader if it waits for a free chunk the caller never returned
+        queue_close(pipeline, &pipeline->in_free);
+        pthread_join(pipeline->reader, NULL);
+    }
+    io_pipeline_finish(pipeline);
+
+    queue_destroy(&pipeline->in_free);
+    queue_destroy(&pipeline->in_full);
+    queue_destroy(&pipeline->out_free);
+    queue_destroy(&pipeline->out_full);
+    pthread_mutex_destroy(&pipeline->lock);
+    if (pipeline->chunks) {
+        for (size_t i = 0; i < pipeline->chunk_count; i++) {
+            free(pipeline->chunks[i].data);
+        }
+        free(pipeline->chunks);
+    }
+    free(pipeline);
+}
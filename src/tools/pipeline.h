@@ -0,0 +1,37 @@
+#ifndef TOOLS_PIPELINE_H
+#define TOOLS_PIPELINE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// Reads the input and writes the output on threads of their own, so disk and
+// pipe latency overlaps with the codec. depth chunks circulate in each
+// direction and are reused, a full queue blocks the faster side. With depth 0
+// both happen on the calling thread, the same as a plain fread/fwrite loop.
+typedef struct io_pipeline io_pipeline_t;
+
+typedef struct {
+    uint8_t* data;
+    size_t size;
+    size_t capacity;
+} io_chunk_t;
+
+// Either file may be NULL when that side is not used
+io_pipeline_t* io_pipeline_new(FILE* in, FILE* out, size_t chunk_size, size_t depth);
+
+// Next chunk of input, NULL at the end of the input. Hand it back with
+// io_pipeline_release once done with it
+io_chunk_t* io_pipeline_read(io_pipeline_t* pipeline);
+void io_pipeline_release(io_pipeline_t* pipeline, io_chunk_t* chunk);
+
+// Queue a copy of data for writing
+bool io_pipeline_write(io_pipeline_t* pipeline, const uint8_t* data, size_t size);
+
+// Wait until everything queued is written, false if any write failed
+bool io_pipeline_finish(io_pipeline_t* pipeline);
+// Stops both threads, the files stay open
+void io_pipeline_free(io_pipeline_t* pipeline);
+
+#endif // TOOLS_PIPELINE_H